@@ -37,8 +37,12 @@
 #define MSGPACK_DISABLE_LEGACY_CONVERT
 #endif
 
+#include "wamp_callee_group.hpp"
+#include "wamp_coroutine.hpp"
 #include "wamp_event.hpp"
+#include "wamp_future_executor.hpp"
 #include "wamp_invocation.hpp"
+#include "wamp_result_cache.hpp"
 #include "wamp_session.hpp"
 #include "wamp_tcp_transport.hpp"
 #include "wamp_transport.hpp"
@@ -8,5 +8,18 @@
 #ifndef BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
 #define BOOST_THREAD_PROVIDES_FUTURE_WHEN_ALL_WHEN_ANY
 #endif
+// Define AUTOBAHN_FUTURE_EXECUTORS to let continuations run on an executor
+// instead of a new thread, see wamp_future_executor. This enables executors
+// in Boost.Thread, which changes its configuration: define it for the whole
+// program, e.g. on the compiler command line, so that every file including
+// boost/thread sees the same configuration.
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+#ifndef BOOST_THREAD_PROVIDES_EXECUTORS
+#define BOOST_THREAD_PROVIDES_EXECUTORS
+#endif
+#ifndef BOOST_THREAD_USES_MOVE
+#define BOOST_THREAD_USES_MOVE
+#endif
+#endif
 
 #include <boost/thread/future.hpp>
@@ -61,6 +61,11 @@ class protocol_error : public std::runtime_error {
      protocol_error(const std::string& message) : std::runtime_error(message) {};
 };
 
+class timeout_error : public std::runtime_error {
+  public:
+     timeout_error(const std::string& message) : std::runtime_error(message) {};
+};
+
 } // namespace autobahn
 
 #endif // AUTOBAHN_EXCEPTIONS_HPP
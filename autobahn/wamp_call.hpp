@@ -32,11 +32,16 @@
 #define AUTOBAHN_WAMP_CALL_HPP
 
 #include "wamp_call_result.hpp"
-#include "boost_config.hpp"
-
-#include <boost/thread/future.hpp>
+#include "wamp_completion.hpp"
+#include "wamp_invocation.hpp"
+#include "wamp_progress_handler.hpp"
+#include "wamp_result_cache.hpp"
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <msgpack.hpp>
+#include <string>
 
 namespace autobahn {
 
@@ -45,12 +50,47 @@ class wamp_call
 {
 public:
     wamp_call();
+    explicit wamp_call(wamp_completion<wamp_call_result>&& result);
 
-    boost::promise<wamp_call_result>& result();
+    wamp_completion<wamp_call_result>& result();
     void set_result(wamp_call_result&& value);
 
+    /// The time after which the session fails the call, zero for none.
+    const std::chrono::milliseconds& timeout() const;
+    void set_timeout(const std::chrono::milliseconds& timeout);
+
+    /// The session's timer enforcing the timeout, see wamp_timer_wheel.
+    uint64_t timer() const;
+    void set_timer(uint64_t timer);
+
+    /// Receives progressive results, empty if none were requested.
+    const wamp_progress_handler& progress_handler() const;
+    void set_progress_handler(const wamp_progress_handler& handler);
+
+    /// The cache to store the result in, null if the procedure's results
+    /// are not cached, see wamp_result_cache.
+    const std::shared_ptr<wamp_result_cache>& cache() const;
+    const std::string& cache_key() const;
+    uint64_t cache_generation() const;
+    void set_cache(const std::shared_ptr<wamp_result_cache>& cache, std::string&& key,
+            uint64_t generation);
+
+    /// Whether the call is answered by a procedure of the session itself,
+    /// without the router, and the invocation it is answered by.
+    bool local() const;
+    const std::weak_ptr<wamp_invocation_impl>& local_invocation() const;
+    void set_local_invocation(const wamp_invocation& invocation);
+
 private:
-    boost::promise<wamp_call_result> m_result;
+    wamp_completion<wamp_call_result> m_result;
+    std::chrono::milliseconds m_timeout;
+    uint64_t m_timer;
+    wamp_progress_handler m_progress_handler;
+    std::shared_ptr<wamp_result_cache> m_cache;
+    std::string m_cache_key;
+    uint64_t m_cache_generation;
+    bool m_local;
+    std::weak_ptr<wamp_invocation_impl> m_local_invocation;
 };
 
 } // namespace autobahn
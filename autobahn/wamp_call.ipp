@@ -32,10 +32,31 @@ namespace autobahn {
 
 inline wamp_call::wamp_call()
     : m_result()
+    , m_timeout(0)
+    , m_timer(0)
+    , m_progress_handler()
+    , m_cache()
+    , m_cache_key()
+    , m_cache_generation(0)
+    , m_local(false)
+    , m_local_invocation()
 {
 }
 
-inline boost::promise<wamp_call_result>& wamp_call::result()
+inline wamp_call::wamp_call(wamp_completion<wamp_call_result>&& result)
+    : m_result(std::move(result))
+    , m_timeout(0)
+    , m_timer(0)
+    , m_progress_handler()
+    , m_cache()
+    , m_cache_key()
+    , m_cache_generation(0)
+    , m_local(false)
+    , m_local_invocation()
+{
+}
+
+inline wamp_completion<wamp_call_result>& wamp_call::result()
 {
     return m_result;
 }
@@ -45,4 +66,73 @@ inline void wamp_call::set_result(wamp_call_result&& value)
     m_result.set_value(std::move(value));
 }
 
+inline const std::chrono::milliseconds& wamp_call::timeout() const
+{
+    return m_timeout;
+}
+
+inline void wamp_call::set_timeout(const std::chrono::milliseconds& timeout)
+{
+    m_timeout = timeout;
+}
+
+inline uint64_t wamp_call::timer() const
+{
+    return m_timer;
+}
+
+inline void wamp_call::set_timer(uint64_t timer)
+{
+    m_timer = timer;
+}
+
+inline const wamp_progress_handler& wamp_call::progress_handler() const
+{
+    return m_progress_handler;
+}
+
+inline void wamp_call::set_progress_handler(const wamp_progress_handler& handler)
+{
+    m_progress_handler = handler;
+}
+
+inline const std::shared_ptr<wamp_result_cache>& wamp_call::cache() const
+{
+    return m_cache;
+}
+
+inline const std::string& wamp_call::cache_key() const
+{
+    return m_cache_key;
+}
+
+inline uint64_t wamp_call::cache_generation() const
+{
+    return m_cache_generation;
+}
+
+inline void wamp_call::set_cache(
+        const std::shared_ptr<wamp_result_cache>& cache, std::string&& key, uint64_t generation)
+{
+    m_cache = cache;
+    m_cache_key = std::move(key);
+    m_cache_generation = generation;
+}
+
+inline bool wamp_call::local() const
+{
+    return m_local;
+}
+
+inline const std::weak_ptr<wamp_invocation_impl>& wamp_call::local_invocation() const
+{
+    return m_local_invocation;
+}
+
+inline void wamp_call::set_local_invocation(const wamp_invocation& invocation)
+{
+    m_local = true;
+    m_local_invocation = invocation;
+}
+
 } // namespace autobahn
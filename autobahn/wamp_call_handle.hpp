@@ -0,0 +1,99 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_CALL_HANDLE_HPP
+#define AUTOBAHN_WAMP_CALL_HANDLE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace autobahn {
+
+/*!
+ * How the router handles the cancellation of a call.
+ */
+enum class wamp_cancel_mode
+{
+    /// Stop waiting for the result, but let the callee run to completion.
+    skip,
+    /// Interrupt the callee and wait for it to respond.
+    kill,
+    /// Interrupt the callee but do not wait for it to respond.
+    killnowait
+};
+
+/*!
+ * The mode's name on the wire, e.g. "killnowait".
+ */
+std::string to_string(wamp_cancel_mode mode);
+
+/*!
+ * Refers to an outstanding call so that it can be cancelled with
+ * wamp_session::cancel() or continued with wamp_session::call_chunk(). Pass
+ * the handle in the options of the call; copies of a handle refer to the
+ * same call.
+ */
+class wamp_call_handle
+{
+public:
+    wamp_call_handle();
+
+    /*!
+     * The request id of the call, or 0 if the call has not been made yet.
+     */
+    uint64_t request_id() const;
+
+    /*!
+     * The URI of the called procedure. Only valid once request_id() is set.
+     */
+    const std::string& procedure() const;
+
+    /*!
+     * Refers the handle to an issued call.
+     */
+    void set_call(uint64_t request_id, const std::string& procedure);
+
+private:
+    struct state
+    {
+        std::atomic<uint64_t> request_id;
+        std::string procedure;
+    };
+
+    std::shared_ptr<state> m_state;
+};
+
+} // namespace autobahn
+
+#include "wamp_call_handle.ipp"
+
+#endif // AUTOBAHN_WAMP_CALL_HANDLE_HPP
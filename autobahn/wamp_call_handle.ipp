@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace autobahn {
+
+inline std::string to_string(wamp_cancel_mode mode)
+{
+    switch (mode) {
+        case wamp_cancel_mode::skip:
+            return "skip";
+        case wamp_cancel_mode::killnowait:
+            return "killnowait";
+        case wamp_cancel_mode::kill:
+        default:
+            return "kill";
+    }
+}
+
+inline wamp_call_handle::wamp_call_handle()
+    : m_state(std::make_shared<state>())
+{
+    m_state->request_id.store(0);
+}
+
+inline uint64_t wamp_call_handle::request_id() const
+{
+    return m_state->request_id.load();
+}
+
+inline const std::string& wamp_call_handle::procedure() const
+{
+    return m_state->procedure;
+}
+
+inline void wamp_call_handle::set_call(uint64_t request_id, const std::string& procedure)
+{
+    // The procedure is published by storing the request id.
+    m_state->procedure = procedure;
+    m_state->request_id.store(request_id);
+}
+
+} // namespace autobahn
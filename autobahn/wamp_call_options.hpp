@@ -31,7 +31,11 @@
 #ifndef AUTOBAHN_WAMP_CALL_OPTIONS_HPP
 #define AUTOBAHN_WAMP_CALL_OPTIONS_HPP
 
+#include "wamp_call_handle.hpp"
+#include "wamp_progress_handler.hpp"
+
 #include <chrono>
+#include <memory>
 
 namespace autobahn {
 
@@ -49,8 +53,42 @@ public:
 
     void set_timeout(const std::chrono::milliseconds& timeout);
 
+    /*!
+     * The handle the session stores the call's request id in, or nullptr.
+     */
+    const wamp_call_handle* handle() const;
+
+    /*!
+     * Sets a handle through which the call can be cancelled.
+     */
+    void set_handle(const wamp_call_handle& handle);
+
+    /*!
+     * The handler for progressive results, empty if none are requested.
+     */
+    const wamp_progress_handler& progress_handler() const;
+
+    /*!
+     * Requests progressive results from the callee. Each one is passed to
+     * the handler on the io service as it arrives, while the call's future
+     * resolves to the final result. The call's timeout, if any, still
+     * covers the call as a whole.
+     */
+    void set_progress_handler(const wamp_progress_handler& handler);
+
+    /*!
+     * Whether or not more chunks of the call's arguments follow, see
+     * wamp_session::call_chunk().
+     */
+    bool progress() const;
+
+    void set_progress(bool progress);
+
 private:
     std::chrono::milliseconds m_timeout;
+    std::unique_ptr<wamp_call_handle> m_handle;
+    wamp_progress_handler m_progress_handler;
+    bool m_progress;
 };
 
 } // namespace autobahn
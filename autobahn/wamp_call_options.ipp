@@ -36,6 +36,9 @@ namespace autobahn {
 
 inline wamp_call_options::wamp_call_options()
     : m_timeout()
+    , m_handle()
+    , m_progress_handler()
+    , m_progress(false)
 {
 }
 
@@ -49,6 +52,36 @@ inline void wamp_call_options::set_timeout(const std::chrono::milliseconds& time
     m_timeout = timeout;
 }
 
+inline const wamp_call_handle* wamp_call_options::handle() const
+{
+    return m_handle.get();
+}
+
+inline void wamp_call_options::set_handle(const wamp_call_handle& handle)
+{
+    m_handle.reset(new wamp_call_handle(handle));
+}
+
+inline const wamp_progress_handler& wamp_call_options::progress_handler() const
+{
+    return m_progress_handler;
+}
+
+inline void wamp_call_options::set_progress_handler(const wamp_progress_handler& handler)
+{
+    m_progress_handler = handler;
+}
+
+inline bool wamp_call_options::progress() const
+{
+    return m_progress;
+}
+
+inline void wamp_call_options::set_progress(bool progress)
+{
+    m_progress = progress;
+}
+
 } // namespace autobahn
 
 namespace msgpack {
@@ -70,6 +103,11 @@ struct convert<autobahn::wamp_call_options>
             options.set_timeout(std::chrono::milliseconds(options_map_itr->second.as<unsigned>()));
         }
 
+        const auto progress_itr = options_map.find("progress");
+        if (progress_itr != options_map.end()) {
+            options.set_progress(progress_itr->second.as<bool>());
+        }
+
         return object;
     }
 };
@@ -82,13 +120,23 @@ struct pack<autobahn::wamp_call_options>
             msgpack::packer<Stream>& packer,
             autobahn::wamp_call_options const& options) const
     {
-        std::unordered_map<std::string, unsigned> options_map;
         const auto& timeout = options.timeout();
+        const bool receive_progress = static_cast<bool>(options.progress_handler());
+
+        packer.pack_map((timeout.count() > 0 ? 1 : 0) + (receive_progress ? 1 : 0)
+                + (options.progress() ? 1 : 0));
         if (timeout.count() > 0) {
-            options_map["timeout"] = timeout.count();
+            packer.pack(std::string("timeout"));
+            packer.pack(static_cast<unsigned>(timeout.count()));
+        }
+        if (receive_progress) {
+            packer.pack(std::string("receive_progress"));
+            packer.pack(true);
+        }
+        if (options.progress()) {
+            packer.pack(std::string("progress"));
+            packer.pack(true);
         }
-
-        packer.pack(options_map);
 
         return packer;
     }
@@ -108,6 +156,14 @@ struct object_with_zone<autobahn::wamp_call_options>
             options_map["timeout"] = msgpack::object(timeout.count());
         }
 
+        if (options.progress_handler()) {
+            options_map["receive_progress"] = msgpack::object(true);
+        }
+
+        if (options.progress()) {
+            options_map["progress"] = msgpack::object(true);
+        }
+
         object << options_map;
     }
 };
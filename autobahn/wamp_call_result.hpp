@@ -191,6 +191,11 @@ public:
     void set_arguments(const msgpack::object& arguments);
     void set_kw_arguments(const msgpack::object& kw_arguments);
 
+    /*!
+     * Deep copies the result into a zone of its own.
+     */
+    wamp_call_result clone() const;
+
 private:
     msgpack::zone m_zone;
     msgpack::object m_arguments;
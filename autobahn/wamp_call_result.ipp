@@ -204,4 +204,16 @@ inline void wamp_call_result::set_kw_arguments(const msgpack::object& kw_argumen
     m_kw_arguments = kw_arguments;
 }
 
+inline wamp_call_result wamp_call_result::clone() const
+{
+    wamp_call_result result;
+    if (number_of_arguments() > 0) {
+        result.m_arguments = msgpack::object(m_arguments, result.m_zone);
+    }
+    if (number_of_kw_arguments() > 0) {
+        result.m_kw_arguments = msgpack::object(m_kw_arguments, result.m_zone);
+    }
+    return result;
+}
+
 } // namespace autobahn
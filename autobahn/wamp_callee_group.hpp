@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_CALLEE_GROUP_HPP
+#define AUTOBAHN_WAMP_CALLEE_GROUP_HPP
+
+#include "wamp_procedure.hpp"
+#include "wamp_register_options.hpp"
+#include "wamp_session.hpp"
+#include "wamp_transport.hpp"
+#include "wamp_uri_trie.hpp"
+
+#include <boost/asio.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * A group of sessions that all register the same procedures, each running
+ * on an io service of its own thread, to scale callees across cores.
+ *
+ * The procedures are registered as shared registrations, leaving it to the
+ * router to spread the calls over the members. Members can be spread over
+ * processes the same way by starting a group in each of them.
+ *
+ * @code
+ * wamp_callee_group group(4, [&](boost::asio::io_service& io) {
+ *     return std::make_shared<wamp_tcp_transport>(io, endpoint);
+ * });
+ * group.provide("com.example.add", &add);
+ * group.start("realm1");
+ * @endcode
+ */
+class wamp_callee_group
+{
+public:
+    /*!
+     * Creates the transport of a member on the member's io service.
+     */
+    using transport_factory =
+            std::function<std::shared_ptr<wamp_transport>(boost::asio::io_service& io_service)>;
+
+    /*!
+     * Creates a group, without connecting it.
+     *
+     * @param size The number of member sessions, at least one.
+     * @param factory Creates the transport of each member.
+     * @param debug_enabled Whether or not the members log at trace level.
+     */
+    wamp_callee_group(std::size_t size, const transport_factory& factory, bool debug_enabled = false);
+
+    /*!
+     * Stops the group.
+     */
+    ~wamp_callee_group();
+
+    /*!
+     * Adds a procedure for every member to register on start().
+     *
+     * @param uri The URI or URI pattern to register.
+     * @param procedure The procedure, invoked on the io service of the
+     *        member the call was routed to.
+     * @param invoke How the router distributes calls between the members.
+     *        Must not be single, which allows only one callee.
+     * @param concurrency The maximum number of outstanding invocations per
+     *        member, 0 for no limit.
+     * @param match How the router matches called URIs against the URI.
+     */
+    void provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            wamp_invoke invoke = wamp_invoke::roundrobin,
+            uint32_t concurrency = 0,
+            wamp_match match = wamp_match::exact);
+
+    /*!
+     * Connects, starts and joins every member, then registers the
+     * procedures. Blocks until all members have registered all procedures.
+     *
+     * @param realm The realm to join.
+     *
+     * @throw The first error any member fails with, or timeout_error if a
+     *        member takes longer than 5 seconds for a step, in which case the
+     *        group is stopped again.
+     */
+    void start(const std::string& realm);
+
+    /*!
+     * Leaves and disconnects the members and joins their threads. Errors
+     * are ignored, a member that lost its connection is stopped as well.
+     */
+    void stop();
+
+    /*!
+     * The number of member sessions.
+     */
+    std::size_t size() const;
+
+    /*!
+     * The session of a member, or nullptr while the group is not started.
+     */
+    std::shared_ptr<wamp_session> session(std::size_t index) const;
+
+private:
+    wamp_callee_group(const wamp_callee_group&) = delete;
+    wamp_callee_group& operator=(const wamp_callee_group&) = delete;
+
+    struct member
+    {
+        boost::asio::io_service io_service;
+        std::unique_ptr<boost::asio::io_service::work> work;
+        std::shared_ptr<wamp_transport> transport;
+        std::shared_ptr<wamp_session> session;
+        std::thread thread;
+    };
+
+    struct provided_procedure
+    {
+        std::string uri;
+        wamp_procedure procedure;
+        wamp_invoke invoke;
+        uint32_t concurrency;
+        wamp_match match;
+    };
+
+    // How long start() and stop() wait for the members in each step.
+    static const int STEP_TIMEOUT_SECONDS = 5;
+
+    // Waits for one future per member, in order, and rethrows the first
+    // failure once all of them are ready or the step has timed out.
+    template <typename T>
+    static void wait_all(std::vector<boost::future<T>>& futures);
+
+private:
+    const std::size_t m_size;
+    const transport_factory m_factory;
+    const bool m_debug_enabled;
+    std::vector<std::unique_ptr<member>> m_members;
+    std::vector<provided_procedure> m_procedures;
+};
+
+} // namespace autobahn
+
+#include "wamp_callee_group.ipp"
+
+#endif // AUTOBAHN_WAMP_CALLEE_GROUP_HPP
@@ -0,0 +1,222 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "exceptions.hpp"
+
+#include <exception>
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_callee_group::wamp_callee_group(
+        std::size_t size, const transport_factory& factory, bool debug_enabled)
+    : m_size(size)
+    , m_factory(factory)
+    , m_debug_enabled(debug_enabled)
+    , m_members()
+    , m_procedures()
+{
+    if (size == 0) {
+        throw std::invalid_argument("callee group must have at least one member");
+    }
+}
+
+inline wamp_callee_group::~wamp_callee_group()
+{
+    stop();
+}
+
+inline void wamp_callee_group::provide(
+        const std::string& uri,
+        const wamp_procedure& procedure,
+        wamp_invoke invoke,
+        uint32_t concurrency,
+        wamp_match match)
+{
+    if (invoke == wamp_invoke::single) {
+        throw std::invalid_argument("callee group procedures must be shared");
+    }
+
+    if (!m_members.empty()) {
+        throw std::logic_error("callee group already started");
+    }
+
+    provided_procedure provided;
+    provided.uri = uri;
+    provided.procedure = procedure;
+    provided.invoke = invoke;
+    provided.concurrency = concurrency;
+    provided.match = match;
+    m_procedures.push_back(std::move(provided));
+}
+
+inline void wamp_callee_group::start(const std::string& realm)
+{
+    if (!m_members.empty()) {
+        throw std::logic_error("callee group already started");
+    }
+
+    try {
+        for (std::size_t index = 0; index < m_size; ++index) {
+            std::unique_ptr<member> created(new member());
+            member* added = created.get();
+            added->work.reset(new boost::asio::io_service::work(added->io_service));
+            added->transport = m_factory(added->io_service);
+            added->session = std::make_shared<wamp_session>(added->io_service, m_debug_enabled);
+            added->transport->attach(
+                    std::static_pointer_cast<wamp_transport_handler>(added->session));
+            m_members.push_back(std::move(created));
+
+            added->thread = std::thread([added]() {
+                added->io_service.run();
+            });
+        }
+
+        // Every step is issued to all members before waiting for any of
+        // them, so the members connect and register in parallel.
+        std::vector<boost::future<void>> connected;
+        for (const auto& member : m_members) {
+            connected.push_back(member->transport->connect());
+        }
+        wait_all(connected);
+
+        std::vector<boost::future<void>> started;
+        for (const auto& member : m_members) {
+            started.push_back(member->session->start());
+        }
+        wait_all(started);
+
+        std::vector<boost::future<uint64_t>> joined;
+        for (const auto& member : m_members) {
+            joined.push_back(member->session->join(realm));
+        }
+        wait_all(joined);
+
+        std::vector<boost::future<wamp_registration>> registered;
+        for (const auto& member : m_members) {
+            for (const auto& provided : m_procedures) {
+                wamp_register_options options;
+                options.set_match(provided.match);
+                options.set_invoke(provided.invoke);
+                options.set_concurrency(provided.concurrency);
+                registered.push_back(member->session->provide(provided.uri, provided.procedure, options));
+            }
+        }
+        wait_all(registered);
+    } catch (...) {
+        stop();
+        throw;
+    }
+}
+
+inline void wamp_callee_group::stop()
+{
+    // Each step is bounded, a member that lost its router must not keep
+    // the others from stopping.
+    const boost::chrono::seconds timeout(STEP_TIMEOUT_SECONDS);
+
+    std::vector<boost::future<std::string>> left;
+    for (const auto& member : m_members) {
+        if (member->session->is_connected()) {
+            left.push_back(member->session->leave());
+        }
+    }
+    for (auto& leaving : left) {
+        leaving.wait_for(timeout);
+    }
+
+    std::vector<boost::future<void>> stopped;
+    for (const auto& member : m_members) {
+        stopped.push_back(member->session->stop());
+    }
+    for (auto& stopping : stopped) {
+        stopping.wait_for(timeout);
+    }
+
+    std::vector<boost::future<void>> disconnected;
+    for (const auto& member : m_members) {
+        if (member->transport->is_connected()) {
+            disconnected.push_back(member->transport->disconnect());
+        }
+    }
+    for (auto& disconnecting : disconnected) {
+        disconnecting.wait_for(timeout);
+    }
+
+    for (const auto& member : m_members) {
+        member->work.reset();
+        member->io_service.stop();
+        if (member->thread.joinable()) {
+            member->thread.join();
+        }
+        member->transport->detach();
+    }
+
+    m_members.clear();
+}
+
+inline std::size_t wamp_callee_group::size() const
+{
+    return m_size;
+}
+
+inline std::shared_ptr<wamp_session> wamp_callee_group::session(std::size_t index) const
+{
+    return index < m_members.size() ? m_members[index]->session : nullptr;
+}
+
+template <typename T>
+inline void wamp_callee_group::wait_all(std::vector<boost::future<T>>& futures)
+{
+    // All members share the time limit of the step.
+    const boost::chrono::steady_clock::time_point deadline =
+            boost::chrono::steady_clock::now() + boost::chrono::seconds(STEP_TIMEOUT_SECONDS);
+
+    std::exception_ptr error;
+    for (auto& future : futures) {
+        try {
+            if (future.wait_until(deadline) != boost::future_status::ready) {
+                throw timeout_error("callee group member did not respond in time");
+            }
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace autobahn
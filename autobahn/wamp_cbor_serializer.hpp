@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_CBOR_SERIALIZER_HPP
+#define AUTOBAHN_WAMP_CBOR_SERIALIZER_HPP
+
+#include "wamp_serializer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <msgpack.hpp>
+#include <string>
+
+namespace autobahn {
+
+/*!
+ * A serializer that encodes wamp messages using CBOR (RFC 7049).
+ *
+ * Messages are converted directly between CBOR and the msgpack object
+ * representation used by wamp_message, so the rest of the library is
+ * unaware of the format being used on the wire. Indefinite length items
+ * are not supported when deserializing and tags are ignored.
+ */
+class wamp_cbor_serializer : public wamp_serializer
+{
+public:
+    /*!
+     * @copydoc wamp_serializer::rawsocket_serializer_id()
+     */
+    virtual uint8_t rawsocket_serializer_id() const override;
+
+    /*!
+     * @copydoc wamp_serializer::websocket_subprotocol()
+     */
+    virtual std::string websocket_subprotocol() const override;
+
+    /*!
+     * @copydoc wamp_serializer::serialize()
+     */
+    virtual void serialize(const wamp_message& message, msgpack::sbuffer& buffer) const override;
+
+    /*!
+     * @copydoc wamp_serializer::deserialize()
+     */
+    virtual wamp_message deserialize(const char* data, std::size_t length) const override;
+
+private:
+    // CBOR major types.
+    static const uint8_t CBOR_UNSIGNED = 0;
+    static const uint8_t CBOR_NEGATIVE = 1;
+    static const uint8_t CBOR_BYTES = 2;
+    static const uint8_t CBOR_TEXT = 3;
+    static const uint8_t CBOR_ARRAY = 4;
+    static const uint8_t CBOR_MAP = 5;
+    static const uint8_t CBOR_TAG = 6;
+    static const uint8_t CBOR_SIMPLE = 7;
+
+    // Nesting limit when decoding, protects the stack against hostile peers.
+    static const std::size_t CBOR_MAX_DEPTH = 256;
+
+    void encode(const msgpack::object& object, msgpack::sbuffer& buffer) const;
+
+    void encode_head(uint8_t major_type, uint64_t value, msgpack::sbuffer& buffer) const;
+
+    msgpack::object decode(
+            const uint8_t*& data,
+            const uint8_t* end,
+            msgpack::zone& zone,
+            std::size_t depth) const;
+
+    uint64_t decode_argument(
+            uint8_t additional_info,
+            const uint8_t*& data,
+            const uint8_t* end) const;
+};
+
+} // namespace autobahn
+
+#include "wamp_cbor_serializer.ipp"
+
+#endif // AUTOBAHN_WAMP_CBOR_SERIALIZER_HPP
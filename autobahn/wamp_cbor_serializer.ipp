@@ -0,0 +1,374 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "exceptions.hpp"
+#include "wamp_message.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace autobahn {
+
+inline uint8_t wamp_cbor_serializer::rawsocket_serializer_id() const
+{
+    return 0x03;
+}
+
+inline std::string wamp_cbor_serializer::websocket_subprotocol() const
+{
+    return "wamp.2.cbor";
+}
+
+inline void wamp_cbor_serializer::serialize(
+        const wamp_message& message, msgpack::sbuffer& buffer) const
+{
+    const wamp_message::message_fields& fields = message.fields();
+
+    encode_head(CBOR_ARRAY, fields.size(), buffer);
+    for (const auto& field : fields) {
+        encode(field, buffer);
+    }
+}
+
+inline wamp_message wamp_cbor_serializer::deserialize(
+        const char* data, std::size_t length) const
+{
+    const uint8_t* begin = reinterpret_cast<const uint8_t*>(data);
+    const uint8_t* end = begin + length;
+
+    msgpack::zone zone;
+    msgpack::object object = decode(begin, end, zone, 0);
+
+    if (begin != end) {
+        throw protocol_error("invalid CBOR message - trailing octets");
+    }
+
+    if (object.type != msgpack::type::ARRAY) {
+        throw protocol_error("invalid message structure - message is not an array");
+    }
+
+    wamp_message::message_fields fields(
+            object.via.array.ptr, object.via.array.ptr + object.via.array.size);
+
+    return wamp_message(std::move(fields), std::move(zone));
+}
+
+inline void wamp_cbor_serializer::encode(
+        const msgpack::object& object, msgpack::sbuffer& buffer) const
+{
+    switch (object.type) {
+        case msgpack::type::NIL:
+            {
+                const char null_value = static_cast<char>(0xF6);
+                buffer.write(&null_value, 1);
+            }
+            break;
+        case msgpack::type::BOOLEAN:
+            {
+                const char boolean_value = static_cast<char>(object.via.boolean ? 0xF5 : 0xF4);
+                buffer.write(&boolean_value, 1);
+            }
+            break;
+        case msgpack::type::POSITIVE_INTEGER:
+            encode_head(CBOR_UNSIGNED, object.via.u64, buffer);
+            break;
+        case msgpack::type::NEGATIVE_INTEGER:
+            // CBOR stores negative integers as -1 - n.
+            encode_head(CBOR_NEGATIVE, static_cast<uint64_t>(-(object.via.i64 + 1)), buffer);
+            break;
+        case msgpack::type::FLOAT32:
+            {
+                float value = static_cast<float>(object.via.f64);
+                uint32_t bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+
+                char octets[5];
+                octets[0] = static_cast<char>(0xFA);
+                for (int i = 0; i < 4; ++i) {
+                    octets[1 + i] = static_cast<char>((bits >> (8 * (3 - i))) & 0xFF);
+                }
+                buffer.write(octets, sizeof(octets));
+            }
+            break;
+        case msgpack::type::FLOAT64:
+            {
+                uint64_t bits;
+                std::memcpy(&bits, &object.via.f64, sizeof(bits));
+
+                char octets[9];
+                octets[0] = static_cast<char>(0xFB);
+                for (int i = 0; i < 8; ++i) {
+                    octets[1 + i] = static_cast<char>((bits >> (8 * (7 - i))) & 0xFF);
+                }
+                buffer.write(octets, sizeof(octets));
+            }
+            break;
+        case msgpack::type::STR:
+            encode_head(CBOR_TEXT, object.via.str.size, buffer);
+            buffer.write(object.via.str.ptr, object.via.str.size);
+            break;
+        case msgpack::type::BIN:
+            encode_head(CBOR_BYTES, object.via.bin.size, buffer);
+            buffer.write(object.via.bin.ptr, object.via.bin.size);
+            break;
+        case msgpack::type::ARRAY:
+            encode_head(CBOR_ARRAY, object.via.array.size, buffer);
+            for (uint32_t i = 0; i < object.via.array.size; ++i) {
+                encode(object.via.array.ptr[i], buffer);
+            }
+            break;
+        case msgpack::type::MAP:
+            encode_head(CBOR_MAP, object.via.map.size, buffer);
+            for (uint32_t i = 0; i < object.via.map.size; ++i) {
+                encode(object.via.map.ptr[i].key, buffer);
+                encode(object.via.map.ptr[i].val, buffer);
+            }
+            break;
+        default:
+            throw protocol_error("unable to serialize msgpack extension type as CBOR");
+    }
+}
+
+inline void wamp_cbor_serializer::encode_head(
+        uint8_t major_type, uint64_t value, msgpack::sbuffer& buffer) const
+{
+    char octets[9];
+    std::size_t length = 0;
+    const uint8_t major = static_cast<uint8_t>(major_type << 5);
+
+    if (value < 24) {
+        octets[length++] = static_cast<char>(major | value);
+    } else if (value <= 0xFF) {
+        octets[length++] = static_cast<char>(major | 24);
+        octets[length++] = static_cast<char>(value);
+    } else if (value <= 0xFFFF) {
+        octets[length++] = static_cast<char>(major | 25);
+        octets[length++] = static_cast<char>(value >> 8);
+        octets[length++] = static_cast<char>(value);
+    } else if (value <= 0xFFFFFFFF) {
+        octets[length++] = static_cast<char>(major | 26);
+        for (int i = 3; i >= 0; --i) {
+            octets[length++] = static_cast<char>(value >> (8 * i));
+        }
+    } else {
+        octets[length++] = static_cast<char>(major | 27);
+        for (int i = 7; i >= 0; --i) {
+            octets[length++] = static_cast<char>(value >> (8 * i));
+        }
+    }
+
+    buffer.write(octets, length);
+}
+
+inline uint64_t wamp_cbor_serializer::decode_argument(
+        uint8_t additional_info,
+        const uint8_t*& data,
+        const uint8_t* end) const
+{
+    if (additional_info < 24) {
+        return additional_info;
+    }
+
+    std::size_t length = 0;
+    switch (additional_info) {
+        case 24: length = 1; break;
+        case 25: length = 2; break;
+        case 26: length = 4; break;
+        case 27: length = 8; break;
+        case 31: throw protocol_error("invalid CBOR message - indefinite length items are not supported");
+        default: throw protocol_error("invalid CBOR message - reserved additional information");
+    }
+
+    if (static_cast<std::size_t>(end - data) < length) {
+        throw protocol_error("invalid CBOR message - truncated");
+    }
+
+    uint64_t value = 0;
+    for (std::size_t i = 0; i < length; ++i) {
+        value = (value << 8) | *data++;
+    }
+
+    return value;
+}
+
+inline msgpack::object wamp_cbor_serializer::decode(
+        const uint8_t*& data,
+        const uint8_t* end,
+        msgpack::zone& zone,
+        std::size_t depth) const
+{
+    if (depth > CBOR_MAX_DEPTH) {
+        throw protocol_error("invalid CBOR message - nesting too deep");
+    }
+
+    if (data == end) {
+        throw protocol_error("invalid CBOR message - truncated");
+    }
+
+    const uint8_t initial = *data++;
+    const uint8_t major_type = initial >> 5;
+    const uint8_t additional_info = initial & 0x1F;
+
+    msgpack::object object;
+
+    if (major_type == CBOR_SIMPLE) {
+        switch (additional_info) {
+            case 20:
+                object.type = msgpack::type::BOOLEAN;
+                object.via.boolean = false;
+                return object;
+            case 21:
+                object.type = msgpack::type::BOOLEAN;
+                object.via.boolean = true;
+                return object;
+            case 22:
+            case 23:
+                object.type = msgpack::type::NIL;
+                return object;
+            case 25:
+                {
+                    uint64_t bits = decode_argument(additional_info, data, end);
+                    int exponent = (bits >> 10) & 0x1F;
+                    double mantissa = static_cast<double>(bits & 0x3FF);
+                    double value;
+                    if (exponent == 0) {
+                        value = std::ldexp(mantissa, -24);
+                    } else if (exponent != 31) {
+                        value = std::ldexp(mantissa + 1024, exponent - 25);
+                    } else {
+                        value = mantissa == 0
+                                ? std::numeric_limits<double>::infinity()
+                                : std::numeric_limits<double>::quiet_NaN();
+                    }
+                    object.type = msgpack::type::FLOAT32;
+                    object.via.f64 = (bits & 0x8000) ? -value : value;
+                }
+                return object;
+            case 26:
+                {
+                    uint32_t bits = static_cast<uint32_t>(decode_argument(additional_info, data, end));
+                    float value;
+                    std::memcpy(&value, &bits, sizeof(value));
+                    object.type = msgpack::type::FLOAT32;
+                    object.via.f64 = value;
+                }
+                return object;
+            case 27:
+                {
+                    uint64_t bits = decode_argument(additional_info, data, end);
+                    object.type = msgpack::type::FLOAT64;
+                    std::memcpy(&object.via.f64, &bits, sizeof(bits));
+                }
+                return object;
+            default:
+                throw protocol_error("invalid CBOR message - unsupported simple value");
+        }
+    }
+
+    const uint64_t argument = decode_argument(additional_info, data, end);
+
+    switch (major_type) {
+        case CBOR_UNSIGNED:
+            object.type = msgpack::type::POSITIVE_INTEGER;
+            object.via.u64 = argument;
+            break;
+        case CBOR_NEGATIVE:
+            if (argument > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
+                throw protocol_error("invalid CBOR message - negative integer out of range");
+            }
+            object.type = msgpack::type::NEGATIVE_INTEGER;
+            object.via.i64 = -1 - static_cast<int64_t>(argument);
+            break;
+        case CBOR_BYTES:
+        case CBOR_TEXT:
+            {
+                if (argument > static_cast<uint64_t>(end - data)) {
+                    throw protocol_error("invalid CBOR message - truncated");
+                }
+                const uint32_t size = static_cast<uint32_t>(argument);
+                char* ptr = static_cast<char*>(zone.allocate_align(size == 0 ? 1 : size));
+                std::memcpy(ptr, data, size);
+                data += size;
+
+                if (major_type == CBOR_TEXT) {
+                    object.type = msgpack::type::STR;
+                    object.via.str.size = size;
+                    object.via.str.ptr = ptr;
+                } else {
+                    object.type = msgpack::type::BIN;
+                    object.via.bin.size = size;
+                    object.via.bin.ptr = ptr;
+                }
+            }
+            break;
+        case CBOR_ARRAY:
+            {
+                // Every item occupies at least one octet.
+                if (argument > static_cast<uint64_t>(end - data)) {
+                    throw protocol_error("invalid CBOR message - truncated");
+                }
+                const uint32_t size = static_cast<uint32_t>(argument);
+                msgpack::object* items = static_cast<msgpack::object*>(
+                        zone.allocate_align(sizeof(msgpack::object) * (size == 0 ? 1 : size)));
+                for (uint32_t i = 0; i < size; ++i) {
+                    items[i] = decode(data, end, zone, depth + 1);
+                }
+                object.type = msgpack::type::ARRAY;
+                object.via.array.size = size;
+                object.via.array.ptr = items;
+            }
+            break;
+        case CBOR_MAP:
+            {
+                if (argument > static_cast<uint64_t>(end - data) / 2) {
+                    throw protocol_error("invalid CBOR message - truncated");
+                }
+                const uint32_t size = static_cast<uint32_t>(argument);
+                msgpack::object_kv* items = static_cast<msgpack::object_kv*>(
+                        zone.allocate_align(sizeof(msgpack::object_kv) * (size == 0 ? 1 : size)));
+                for (uint32_t i = 0; i < size; ++i) {
+                    items[i].key = decode(data, end, zone, depth + 1);
+                    items[i].val = decode(data, end, zone, depth + 1);
+                }
+                object.type = msgpack::type::MAP;
+                object.via.map.size = size;
+                object.via.map.ptr = items;
+            }
+            break;
+        case CBOR_TAG:
+            // Tags carry semantics we do not interpret, decode the tagged item.
+            return decode(data, end, zone, depth + 1);
+    }
+
+    return object;
+}
+
+} // namespace autobahn
@@ -0,0 +1,136 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_COMPLETION_HPP
+#define AUTOBAHN_WAMP_COMPLETION_HPP
+
+#include "boost_config.hpp"
+
+#include <boost/exception_ptr.hpp>
+#include <boost/optional.hpp>
+#include <boost/thread/future.hpp>
+#include <cstddef>
+#include <exception>
+#include <type_traits>
+
+namespace autobahn {
+
+/*!
+ * Completes an outstanding request, either by fulfilling a promise or by
+ * invoking a completion handler.
+ *
+ * A default constructed completion owns a promise, whose future is handed
+ * to the application. A completion constructed from a handler owns no
+ * promise at all, so completing it takes neither an allocation nor a lock.
+ * The handler is stored inline unless it is large or may throw when moved.
+ *
+ * Handlers are invoked with the signature void(std::exception_ptr, T). On
+ * failure the value is default constructed.
+ *
+ * @tparam T The value the request completes with.
+ */
+template <typename T>
+class wamp_completion
+{
+public:
+    typedef void signature(std::exception_ptr, T);
+
+    wamp_completion();
+
+    template <typename Handler, typename = typename std::enable_if<
+            !std::is_same<typename std::decay<Handler>::type, wamp_completion>::value>::type>
+    explicit wamp_completion(Handler&& handler);
+
+    wamp_completion(wamp_completion&& other);
+    ~wamp_completion();
+
+    wamp_completion& operator=(wamp_completion&& other);
+
+    /*!
+     * The future of a promise based completion.
+     *
+     * @throw std::logic_error If the completion invokes a handler instead.
+     */
+    boost::future<T> get_future();
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    /*!
+     * Runs the continuations of the future on the executor.
+     *
+     * @throw std::logic_error If the completion invokes a handler instead.
+     */
+    void set_executor(const boost::executor_ptr_type& executor);
+#endif
+
+    void set_value(T value);
+
+    /*!
+     * Fails the request with the given exception, which may also be a
+     * boost::exception_ptr.
+     */
+    template <typename Exception>
+    void set_exception(const Exception& exception);
+    void set_exception(const boost::exception_ptr& exception);
+
+private:
+    wamp_completion(const wamp_completion&) = delete;
+    wamp_completion& operator=(const wamp_completion&) = delete;
+
+    struct operations
+    {
+        void (*invoke)(void* storage, std::exception_ptr error, T&& value);
+        void (*move)(void* from, void* to);
+        void (*destroy)(void* storage);
+    };
+
+    template <typename Handler, bool Inline>
+    struct handler_operations;
+
+    enum : std::size_t { INLINE_SIZE = 64 };
+
+    template <typename Handler>
+    void store(Handler&& handler, std::true_type);
+    template <typename Handler>
+    void store(Handler&& handler, std::false_type);
+
+    void complete(std::exception_ptr error, T&& value);
+    void reset();
+
+private:
+    boost::optional<boost::promise<T>> m_promise;
+    const operations* m_operations;
+    typename std::aligned_storage<INLINE_SIZE>::type m_storage;
+};
+
+} // namespace autobahn
+
+#include "wamp_completion.ipp"
+
+#endif // AUTOBAHN_WAMP_COMPLETION_HPP
@@ -0,0 +1,251 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+template <typename T>
+template <typename Handler>
+struct wamp_completion<T>::handler_operations<Handler, true>
+{
+    static void invoke(void* storage, std::exception_ptr error, T&& value)
+    {
+        // Move the handler out first so that it may start another request
+        // that reuses the storage.
+        Handler* stored = static_cast<Handler*>(storage);
+        Handler handler(std::move(*stored));
+        stored->~Handler();
+        handler(std::move(error), std::move(value));
+    }
+
+    static void move(void* from, void* to)
+    {
+        Handler* source = static_cast<Handler*>(from);
+        new (to) Handler(std::move(*source));
+        source->~Handler();
+    }
+
+    static void destroy(void* storage)
+    {
+        static_cast<Handler*>(storage)->~Handler();
+    }
+
+    static const operations* table()
+    {
+        static const operations instance = { &invoke, &move, &destroy };
+        return &instance;
+    }
+};
+
+template <typename T>
+template <typename Handler>
+struct wamp_completion<T>::handler_operations<Handler, false>
+{
+    static void invoke(void* storage, std::exception_ptr error, T&& value)
+    {
+        std::unique_ptr<Handler> stored(*static_cast<Handler**>(storage));
+        Handler handler(std::move(*stored));
+        stored.reset();
+        handler(std::move(error), std::move(value));
+    }
+
+    static void move(void* from, void* to)
+    {
+        *static_cast<Handler**>(to) = *static_cast<Handler**>(from);
+    }
+
+    static void destroy(void* storage)
+    {
+        delete *static_cast<Handler**>(storage);
+    }
+
+    static const operations* table()
+    {
+        static const operations instance = { &invoke, &move, &destroy };
+        return &instance;
+    }
+};
+
+template <typename T>
+wamp_completion<T>::wamp_completion()
+    : m_promise()
+    , m_operations(nullptr)
+    , m_storage()
+{
+    m_promise.emplace();
+}
+
+template <typename T>
+template <typename Handler, typename>
+wamp_completion<T>::wamp_completion(Handler&& handler)
+    : m_promise()
+    , m_operations(nullptr)
+    , m_storage()
+{
+    typedef typename std::decay<Handler>::type handler_type;
+    typedef std::integral_constant<bool, sizeof(handler_type) <= INLINE_SIZE
+            && alignof(handler_type) <= alignof(decltype(m_storage))
+            && std::is_nothrow_move_constructible<handler_type>::value> fits_inline;
+
+    store(std::forward<Handler>(handler), fits_inline());
+    m_operations = handler_operations<handler_type, fits_inline::value>::table();
+}
+
+template <typename T>
+wamp_completion<T>::wamp_completion(wamp_completion&& other)
+    : m_promise(std::move(other.m_promise))
+    , m_operations(other.m_operations)
+    , m_storage()
+{
+    if (m_operations) {
+        m_operations->move(&other.m_storage, &m_storage);
+        other.m_operations = nullptr;
+    }
+}
+
+template <typename T>
+wamp_completion<T>::~wamp_completion()
+{
+    reset();
+}
+
+template <typename T>
+wamp_completion<T>& wamp_completion<T>::operator=(wamp_completion&& other)
+{
+    if (this != &other) {
+        reset();
+        m_promise = std::move(other.m_promise);
+        m_operations = other.m_operations;
+        if (m_operations) {
+            m_operations->move(&other.m_storage, &m_storage);
+            other.m_operations = nullptr;
+        }
+    }
+    return *this;
+}
+
+template <typename T>
+boost::future<T> wamp_completion<T>::get_future()
+{
+    if (!m_promise) {
+        throw std::logic_error("completion has no future");
+    }
+    return m_promise->get_future();
+}
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+template <typename T>
+void wamp_completion<T>::set_executor(const boost::executor_ptr_type& executor)
+{
+    if (!m_promise) {
+        throw std::logic_error("completion has no future");
+    }
+    m_promise->set_executor(executor);
+}
+#endif
+
+template <typename T>
+void wamp_completion<T>::set_value(T value)
+{
+    if (m_promise) {
+        m_promise->set_value(std::move(value));
+    } else {
+        complete(nullptr, std::move(value));
+    }
+}
+
+template <typename T>
+template <typename Exception>
+void wamp_completion<T>::set_exception(const Exception& exception)
+{
+    if (m_promise) {
+        m_promise->set_exception(exception);
+    } else {
+        complete(std::make_exception_ptr(exception), T());
+    }
+}
+
+template <typename T>
+void wamp_completion<T>::set_exception(const boost::exception_ptr& exception)
+{
+    if (m_promise) {
+        m_promise->set_exception(exception);
+        return;
+    }
+
+    try {
+        boost::rethrow_exception(exception);
+    } catch (...) {
+        complete(std::current_exception(), T());
+    }
+}
+
+template <typename T>
+template <typename Handler>
+void wamp_completion<T>::store(Handler&& handler, std::true_type)
+{
+    typedef typename std::decay<Handler>::type handler_type;
+    new (&m_storage) handler_type(std::forward<Handler>(handler));
+}
+
+template <typename T>
+template <typename Handler>
+void wamp_completion<T>::store(Handler&& handler, std::false_type)
+{
+    typedef typename std::decay<Handler>::type handler_type;
+    *reinterpret_cast<handler_type**>(&m_storage) = new handler_type(std::forward<Handler>(handler));
+}
+
+template <typename T>
+void wamp_completion<T>::complete(std::exception_ptr error, T&& value)
+{
+    // A handler is invoked at most once, later completions are ignored.
+    const operations* handler = m_operations;
+    if (!handler) {
+        return;
+    }
+    m_operations = nullptr;
+    handler->invoke(&m_storage, std::move(error), std::move(value));
+}
+
+template <typename T>
+void wamp_completion<T>::reset()
+{
+    if (m_operations) {
+        m_operations->destroy(&m_storage);
+        m_operations = nullptr;
+    }
+}
+
+} // namespace autobahn
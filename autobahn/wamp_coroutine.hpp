@@ -0,0 +1,221 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_COROUTINE_HPP
+#define AUTOBAHN_WAMP_COROUTINE_HPP
+
+#include "boost_config.hpp"
+
+#include <boost/asio.hpp>
+#include <boost/version.hpp>
+
+// The coroutine API needs a C++20 compiler and an asio that provides
+// awaitables. Without them this header provides nothing.
+#if defined(BOOST_ASIO_HAS_CO_AWAIT) && BOOST_VERSION >= 107000
+
+#include "wamp_call_options.hpp"
+#include "wamp_call_result.hpp"
+#include "wamp_event_handler.hpp"
+#include "wamp_invocation.hpp"
+#include "wamp_procedure.hpp"
+#include "wamp_registration.hpp"
+#include "wamp_session.hpp"
+#include "wamp_subscribe_options.hpp"
+#include "wamp_subscription.hpp"
+#include "wamp_transport.hpp"
+
+#include <boost/asio/awaitable.hpp>
+#include <boost/asio/co_spawn.hpp>
+#include <boost/asio/use_awaitable.hpp>
+#include <boost/thread/future.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * Awaits a future from a coroutine without blocking the thread.
+ *
+ * The coroutine is resumed on its own executor once the future is ready.
+ * This is meant for the few session operations that only exist in future
+ * form (connecting, starting, joining and leaving); requests are awaited
+ * through their completion token overloads instead, which take no future
+ * shared state.
+ *
+ * @param future The future to await.
+ * @return The value of the future, rethrowing its exception if it failed.
+ */
+template <typename T>
+boost::asio::awaitable<T> await_future(boost::future<T> future);
+
+boost::asio::awaitable<void> await_future(boost::future<void> future);
+
+/*!
+ * Connects the transport.
+ */
+boost::asio::awaitable<void> co_connect(const std::shared_ptr<wamp_transport>& transport);
+
+/*!
+ * Starts the session, see wamp_session::start.
+ */
+boost::asio::awaitable<void> co_start(const std::shared_ptr<wamp_session>& session);
+
+/*!
+ * Joins a realm, see wamp_session::join.
+ *
+ * @return The session ID.
+ */
+boost::asio::awaitable<uint64_t> co_join(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& realm,
+        const std::vector<std::string>& authmethods = std::vector<std::string>(),
+        const std::string& authid = "");
+
+/*!
+ * Leaves the realm, see wamp_session::leave.
+ *
+ * @return The reason sent by the peer.
+ */
+boost::asio::awaitable<std::string> co_leave(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& reason = std::string("wamp.error.close_realm"));
+
+/*!
+ * Calls a remote procedure. The coroutine is resumed directly from the io
+ * service when the result arrives.
+ *
+ * @param session The session to call on.
+ * @param procedure The URI of the procedure.
+ * @param arguments The positional arguments for the call.
+ * @param options The options for the call.
+ * @return The call result, throwing if the call failed.
+ */
+template <typename List>
+boost::asio::awaitable<wamp_call_result> co_call(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options = wamp_call_options());
+
+template <typename List, typename Map>
+boost::asio::awaitable<wamp_call_result> co_call(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& procedure,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_call_options& options);
+
+/*!
+ * Subscribes a handler to a topic.
+ */
+boost::asio::awaitable<wamp_subscription> co_subscribe(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const wamp_subscribe_options& options = wamp_subscribe_options());
+
+/*!
+ * Publishes an event. Completes once the event has been sent.
+ */
+template <typename List>
+boost::asio::awaitable<void> co_publish(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const List& arguments);
+
+template <typename List, typename Map>
+boost::asio::awaitable<void> co_publish(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments);
+
+/*!
+ * Adapts a coroutine to a wamp_procedure, spawning one coroutine per
+ * invocation on the io service and replying with what it co_returns.
+ *
+ * @tparam Procedure A callable taking a wamp_invocation and returning a
+ *         boost::asio::awaitable.
+ */
+template <typename Procedure>
+class wamp_coroutine_procedure
+{
+public:
+    wamp_coroutine_procedure(Procedure procedure, boost::asio::io_service& io_service);
+
+    void operator()(wamp_invocation invocation);
+
+private:
+    template <typename Result>
+    static boost::asio::awaitable<void> reply(
+            boost::asio::awaitable<Result> procedure, wamp_invocation invocation);
+    static boost::asio::awaitable<void> reply(
+            boost::asio::awaitable<void> procedure, wamp_invocation invocation);
+
+private:
+    Procedure m_procedure;
+    boost::asio::io_service* m_io_service;
+};
+
+/*!
+ * Registers a coroutine as a procedure.
+ *
+ * The procedure is called with the invocation and returns an awaitable.
+ * Each invocation is spawned as a coroutine on the session's io service.
+ * A value the coroutine co_returns is sent as the positional result
+ * arguments, so it has to be a list such as a std::tuple. A coroutine
+ * returning awaitable<void> answers with an empty result, unless it
+ * already replied through the invocation. An exception escaping the
+ * coroutine is answered with "wamp.error.runtime_error", as for plain
+ * procedures.
+ *
+ * @param session The session to register on.
+ * @param uri The URI of the procedure.
+ * @param procedure A callable taking a wamp_invocation and returning a
+ *        boost::asio::awaitable.
+ * @param options Options for registering the procedure.
+ * @return The registration.
+ */
+template <typename Procedure>
+boost::asio::awaitable<wamp_registration> co_provide(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& uri,
+        Procedure procedure,
+        const provide_options& options = provide_options());
+
+} // namespace autobahn
+
+#include "wamp_coroutine.ipp"
+
+#endif // BOOST_ASIO_HAS_CO_AWAIT
+
+#endif // AUTOBAHN_WAMP_COROUTINE_HPP
@@ -0,0 +1,223 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <exception>
+#include <map>
+#include <utility>
+
+namespace autobahn {
+
+template <typename T>
+boost::asio::awaitable<T> await_future(boost::future<T> future)
+{
+    auto executor = co_await boost::asio::this_coro::executor;
+
+    co_return co_await boost::asio::async_initiate<
+            decltype(boost::asio::use_awaitable), void(std::exception_ptr, T)>(
+        [&future, executor](auto handler) {
+            // The continuation runs on whichever thread satisfies the
+            // future, so the coroutine is resumed through its executor.
+            auto shared_handler = std::make_shared<decltype(handler)>(std::move(handler));
+            future.then(boost::launch::sync, [shared_handler, executor](boost::future<T> ready) {
+                std::exception_ptr error;
+                T value = T();
+                try {
+                    value = ready.get();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(executor, [shared_handler, error, value]() mutable {
+                    (*shared_handler)(error, std::move(value));
+                });
+            });
+        }, boost::asio::use_awaitable);
+}
+
+inline boost::asio::awaitable<void> await_future(boost::future<void> future)
+{
+    auto executor = co_await boost::asio::this_coro::executor;
+
+    co_await boost::asio::async_initiate<
+            decltype(boost::asio::use_awaitable), void(std::exception_ptr)>(
+        [&future, executor](auto handler) {
+            auto shared_handler = std::make_shared<decltype(handler)>(std::move(handler));
+            future.then(boost::launch::sync, [shared_handler, executor](boost::future<void> ready) {
+                std::exception_ptr error;
+                try {
+                    ready.get();
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                boost::asio::post(executor, [shared_handler, error]() {
+                    (*shared_handler)(error);
+                });
+            });
+        }, boost::asio::use_awaitable);
+}
+
+inline boost::asio::awaitable<void> co_connect(const std::shared_ptr<wamp_transport>& transport)
+{
+    return await_future(transport->connect());
+}
+
+inline boost::asio::awaitable<void> co_start(const std::shared_ptr<wamp_session>& session)
+{
+    return await_future(session->start());
+}
+
+inline boost::asio::awaitable<uint64_t> co_join(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& realm,
+        const std::vector<std::string>& authmethods,
+        const std::string& authid)
+{
+    return await_future(session->join(realm, authmethods, authid));
+}
+
+inline boost::asio::awaitable<std::string> co_leave(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& reason)
+{
+    return await_future(session->leave(reason));
+}
+
+template <typename List>
+boost::asio::awaitable<wamp_call_result> co_call(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options)
+{
+    return session->async_call(procedure, arguments, options, boost::asio::use_awaitable);
+}
+
+template <typename List, typename Map>
+boost::asio::awaitable<wamp_call_result> co_call(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& procedure,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_call_options& options)
+{
+    return session->async_call(
+            procedure, arguments, kw_arguments, options, boost::asio::use_awaitable);
+}
+
+inline boost::asio::awaitable<wamp_subscription> co_subscribe(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const wamp_subscribe_options& options)
+{
+    return session->async_subscribe(topic, handler, options, boost::asio::use_awaitable);
+}
+
+template <typename List>
+boost::asio::awaitable<void> co_publish(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const List& arguments)
+{
+    return session->async_publish(topic, arguments, boost::asio::use_awaitable);
+}
+
+template <typename List, typename Map>
+boost::asio::awaitable<void> co_publish(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments)
+{
+    return session->async_publish(topic, arguments, kw_arguments, boost::asio::use_awaitable);
+}
+
+template <typename Procedure>
+wamp_coroutine_procedure<Procedure>::wamp_coroutine_procedure(
+        Procedure procedure, boost::asio::io_service& io_service)
+    : m_procedure(std::move(procedure))
+    , m_io_service(&io_service)
+{
+}
+
+template <typename Procedure>
+void wamp_coroutine_procedure<Procedure>::operator()(wamp_invocation invocation)
+{
+    boost::asio::co_spawn(*m_io_service, reply(m_procedure(invocation), invocation),
+            [invocation](std::exception_ptr error) {
+                if (!error || !invocation->sendable()) {
+                    return;
+                }
+
+                // Mirror the replies for exceptions escaping plain procedures.
+                try {
+                    std::rethrow_exception(error);
+                } catch (const std::exception& e) {
+                    std::map<std::string, std::string> error_kw_arguments;
+                    error_kw_arguments["what"] = e.what();
+                    invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
+                } catch (...) {
+                    invocation->error("wamp.error.runtime_error");
+                }
+            });
+}
+
+template <typename Procedure>
+template <typename Result>
+boost::asio::awaitable<void> wamp_coroutine_procedure<Procedure>::reply(
+        boost::asio::awaitable<Result> procedure, wamp_invocation invocation)
+{
+    Result result = co_await std::move(procedure);
+    invocation->result(result);
+}
+
+template <typename Procedure>
+boost::asio::awaitable<void> wamp_coroutine_procedure<Procedure>::reply(
+        boost::asio::awaitable<void> procedure, wamp_invocation invocation)
+{
+    co_await std::move(procedure);
+    if (invocation->sendable()) {
+        invocation->empty_result();
+    }
+}
+
+template <typename Procedure>
+boost::asio::awaitable<wamp_registration> co_provide(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& uri,
+        Procedure procedure,
+        const provide_options& options)
+{
+    wamp_procedure wrapper = wamp_coroutine_procedure<Procedure>(
+            std::move(procedure), session->io_service());
+
+    return session->async_provide(uri, wrapper, options, boost::asio::use_awaitable);
+}
+
+} // namespace autobahn
@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_EXECUTION_POLICY_HPP
+#define AUTOBAHN_WAMP_EXECUTION_POLICY_HPP
+
+#include "wamp_executor.hpp"
+
+#include <cstddef>
+#include <memory>
+
+namespace autobahn {
+
+/*!
+ * Where the invocations of a provided procedure are executed.
+ *
+ * By default invocations run inline on the io service, which is the cheapest
+ * option for short procedures but means that a slow procedure holds up all
+ * other I/O of the session. Procedures may instead run on the shared thread
+ * pool, on a dedicated pool or on any other executor, optionally capping the
+ * number of invocations that run at the same time.
+ *
+ * Results and errors are sent back through the io service regardless of the
+ * policy.
+ */
+class wamp_execution_policy
+{
+public:
+    /*!
+     * Runs invocations inline on the io service.
+     */
+    wamp_execution_policy();
+
+    /*!
+     * Runs invocations inline on the io service.
+     */
+    static wamp_execution_policy io_service();
+
+    /*!
+     * Runs invocations on the process wide wamp_thread_pool::shared() pool.
+     *
+     * @param max_concurrency The maximum number of invocations of the
+     *        procedure that run at once, or 0 for no limit.
+     */
+    static wamp_execution_policy shared_pool(std::size_t max_concurrency = 0);
+
+    /*!
+     * Runs invocations on a new wamp_thread_pool used only by the procedure,
+     * which also caps the number of invocations running at once.
+     *
+     * @param threads The number of threads in the pool.
+     */
+    static wamp_execution_policy dedicated_pool(std::size_t threads);
+
+    /*!
+     * Runs invocations on the given executor.
+     *
+     * @param executor The executor to run invocations on.
+     * @param max_concurrency The maximum number of invocations of the
+     *        procedure that run at once, or 0 for no limit.
+     */
+    static wamp_execution_policy on(
+            const std::shared_ptr<wamp_executor>& executor,
+            std::size_t max_concurrency = 0);
+
+    /*!
+     * The executor invocations are posted to, or nullptr to run them inline.
+     * Its metrics give the queue depth and wait time of the invocations.
+     */
+    const std::shared_ptr<wamp_executor>& executor() const;
+
+private:
+    explicit wamp_execution_policy(const std::shared_ptr<wamp_executor>& executor);
+
+private:
+    std::shared_ptr<wamp_executor> m_executor;
+};
+
+} // namespace autobahn
+
+#include "wamp_execution_policy.ipp"
+
+#endif // AUTOBAHN_WAMP_EXECUTION_POLICY_HPP
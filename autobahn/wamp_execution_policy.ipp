@@ -0,0 +1,78 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wamp_limited_executor.hpp"
+#include "wamp_thread_pool.hpp"
+
+namespace autobahn {
+
+inline wamp_execution_policy::wamp_execution_policy()
+    : m_executor()
+{
+}
+
+inline wamp_execution_policy::wamp_execution_policy(const std::shared_ptr<wamp_executor>& executor)
+    : m_executor(executor)
+{
+}
+
+inline wamp_execution_policy wamp_execution_policy::io_service()
+{
+    return wamp_execution_policy();
+}
+
+inline wamp_execution_policy wamp_execution_policy::shared_pool(std::size_t max_concurrency)
+{
+    return on(wamp_thread_pool::shared(), max_concurrency);
+}
+
+inline wamp_execution_policy wamp_execution_policy::dedicated_pool(std::size_t threads)
+{
+    return wamp_execution_policy(std::make_shared<wamp_thread_pool>(threads));
+}
+
+inline wamp_execution_policy wamp_execution_policy::on(
+        const std::shared_ptr<wamp_executor>& executor,
+        std::size_t max_concurrency)
+{
+    if (max_concurrency == 0) {
+        return wamp_execution_policy(executor);
+    }
+
+    return wamp_execution_policy(
+            std::make_shared<wamp_limited_executor>(executor, max_concurrency));
+}
+
+inline const std::shared_ptr<wamp_executor>& wamp_execution_policy::executor() const
+{
+    return m_executor;
+}
+
+} // namespace autobahn
@@ -0,0 +1,122 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_EXECUTOR_HPP
+#define AUTOBAHN_WAMP_EXECUTOR_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+namespace autobahn {
+
+/*!
+ * A snapshot of the load on an executor.
+ */
+struct wamp_executor_metrics
+{
+    wamp_executor_metrics()
+        : queue_depth(0)
+        , executed(0)
+        , failed(0)
+        , total_wait(0)
+        , max_wait(0)
+    {
+    }
+
+    /*!
+     * The number of tasks waiting to be started.
+     */
+    std::size_t queue_depth;
+
+    /*!
+     * The number of tasks started so far.
+     */
+    uint64_t executed;
+
+    /*!
+     * The number of started tasks that ended with an exception. The
+     * exceptions themselves are discarded, as there is nobody to report
+     * them to.
+     */
+    uint64_t failed;
+
+    /*!
+     * The accumulated time started tasks spent waiting in the queue.
+     */
+    std::chrono::nanoseconds total_wait;
+
+    /*!
+     * The longest time a started task spent waiting in the queue.
+     */
+    std::chrono::nanoseconds max_wait;
+};
+
+/*!
+ * Provides an abstraction for running tasks off the io service, e.g. to
+ * execute invocations of a procedure on a thread pool.
+ */
+class wamp_executor
+{
+public:
+    /*!
+     * The type of task run by an executor.
+     */
+    using task = std::function<void()>;
+
+public:
+    /*!
+     * Default virtual destructor.
+     */
+    virtual ~wamp_executor() = default;
+
+    /*!
+     * Schedules a task to be run. Never runs the task inline. Thread-safe.
+     *
+     * @param task The task to run.
+     */
+    virtual void post(task&& task) = 0;
+
+    /*!
+     * The current load on the executor. Executors that do not keep metrics
+     * return empty metrics. Thread-safe.
+     *
+     * @return A snapshot of the executor metrics.
+     */
+    virtual wamp_executor_metrics metrics() const
+    {
+        return wamp_executor_metrics();
+    }
+};
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_WAMP_EXECUTOR_HPP
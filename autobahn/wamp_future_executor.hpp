@@ -0,0 +1,120 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_FUTURE_EXECUTOR_HPP
+#define AUTOBAHN_WAMP_FUTURE_EXECUTOR_HPP
+
+#include "boost_config.hpp"
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+
+#include "wamp_executor.hpp"
+
+#include <boost/asio/io_service.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/executors/executor.hpp>
+#include <atomic>
+#include <memory>
+
+namespace autobahn {
+
+/*!
+ * Runs future continuations on the io service or on a wamp_executor.
+ *
+ * Without an executor, boost::future::then launches every continuation
+ * asynchronously, which means a new thread per continuation. Futures whose
+ * promise carries an executor instead submit their continuations to it, so
+ * running a continuation only costs a post. Continuations chained on such a
+ * future inherit the executor.
+ *
+ * Continuations are never run inline. Those submitted to an io service that
+ * is no longer run, or after the executor was closed, are dropped.
+ *
+ * Only available with AUTOBAHN_FUTURE_EXECUTORS defined, see boost_config.hpp.
+ *
+ * @see wamp_session::set_continuation_executor
+ */
+class wamp_future_executor : public boost::executors::executor
+{
+public:
+    /*!
+     * Runs continuations on the io service.
+     */
+    explicit wamp_future_executor(boost::asio::io_service& io_service);
+
+    /*!
+     * Runs continuations on an executor, e.g. a wamp_thread_pool.
+     */
+    explicit wamp_future_executor(const std::shared_ptr<wamp_executor>& executor);
+
+    /*!
+     * Creates a shared executor in the form taken by boost::promise.
+     */
+    static boost::shared_ptr<wamp_future_executor> create(boost::asio::io_service& io_service);
+    static boost::shared_ptr<wamp_future_executor> create(
+            const std::shared_ptr<wamp_executor>& executor);
+
+    /*!
+     * Stops accepting continuations. Thread-safe.
+     */
+    virtual void close() override;
+
+    /*!
+     * Whether or not close() was called. Thread-safe.
+     */
+    virtual bool closed() override;
+
+    /*!
+     * Schedules a continuation. Thread-safe.
+     *
+     * @throw std::logic_error If the executor was closed.
+     */
+    virtual void submit(work&& closure) override;
+    using boost::executors::executor::submit;
+
+    /*!
+     * Always returns false, as continuations only ever run on the
+     * underlying executor.
+     */
+    virtual bool try_executing_one() override;
+
+private:
+    boost::asio::io_service* m_io_service;
+    std::shared_ptr<wamp_executor> m_executor;
+    std::atomic<bool> m_closed;
+};
+
+} // namespace autobahn
+
+#include "wamp_future_executor.ipp"
+
+#endif // AUTOBAHN_FUTURE_EXECUTORS
+
+#endif // AUTOBAHN_WAMP_FUTURE_EXECUTOR_HPP
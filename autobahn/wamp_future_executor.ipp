@@ -0,0 +1,96 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_future_executor::wamp_future_executor(boost::asio::io_service& io_service)
+    : m_io_service(&io_service)
+    , m_executor()
+    , m_closed(false)
+{
+}
+
+inline wamp_future_executor::wamp_future_executor(const std::shared_ptr<wamp_executor>& executor)
+    : m_io_service(nullptr)
+    , m_executor(executor)
+    , m_closed(false)
+{
+}
+
+inline boost::shared_ptr<wamp_future_executor> wamp_future_executor::create(
+        boost::asio::io_service& io_service)
+{
+    return boost::shared_ptr<wamp_future_executor>(new wamp_future_executor(io_service));
+}
+
+inline boost::shared_ptr<wamp_future_executor> wamp_future_executor::create(
+        const std::shared_ptr<wamp_executor>& executor)
+{
+    return boost::shared_ptr<wamp_future_executor>(new wamp_future_executor(executor));
+}
+
+inline void wamp_future_executor::close()
+{
+    m_closed = true;
+}
+
+inline bool wamp_future_executor::closed()
+{
+    return m_closed;
+}
+
+inline void wamp_future_executor::submit(work&& closure)
+{
+    if (m_closed) {
+        throw std::logic_error("future executor closed");
+    }
+
+    // The closure is move only whereas tasks have to be copyable.
+    auto shared_closure = std::make_shared<work>(std::move(closure));
+    auto task = [shared_closure]() {
+        (*shared_closure)();
+    };
+
+    if (m_io_service) {
+        m_io_service->post(task);
+    } else {
+        m_executor->post(task);
+    }
+}
+
+inline bool wamp_future_executor::try_executing_one()
+{
+    return false;
+}
+
+} // namespace autobahn
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_ID_MAP_HPP
+#define AUTOBAHN_WAMP_ID_MAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * An open addressing hash table keyed by wamp ids, storing its values inline.
+ *
+ * Wamp ids (request, subscription, registration and publication ids) are
+ * always in the range [1, 2^53], so the key 0 is used to mark empty slots.
+ * Keys are spread with fibonacci hashing, which distributes sequential
+ * request ids evenly, collisions are resolved with linear probing and
+ * erasing uses backward shift deletion so no tombstones are left behind.
+ *
+ * The table grows when it becomes half full and never shrinks, so once a
+ * session has reached its steady state number of outstanding requests,
+ * inserting and erasing does not allocate.
+ *
+ * Pointers to values are invalidated by any insertion or erasure. Values
+ * whose completion may run user code (e.g. promises) should be moved out
+ * with take() before being completed.
+ *
+ * @tparam T The value type, which must be move constructible.
+ */
+template <typename T>
+class wamp_id_map
+{
+public:
+    wamp_id_map();
+    wamp_id_map(wamp_id_map&& other);
+    ~wamp_id_map();
+
+    wamp_id_map& operator=(wamp_id_map&& other);
+
+    /*!
+     * Inserts a value constructed from the given arguments.
+     *
+     * @param id The id to insert the value under, must be non-zero.
+     * @param args The arguments to construct the value from.
+     *
+     * @return The inserted value, or the existing value if the id is
+     *         already present, in which case nothing is constructed.
+     */
+    template <typename... Args>
+    T& emplace(uint64_t id, Args&&... args);
+
+    /*!
+     * Looks up a value.
+     *
+     * @return The value stored under the id or nullptr if there is none.
+     */
+    T* find(uint64_t id);
+    const T* find(uint64_t id) const;
+
+    /*!
+     * Moves a value out of the table and erases it.
+     *
+     * @param id The id of the value, which must be present.
+     */
+    T take(uint64_t id);
+
+    /*!
+     * Erases a value.
+     *
+     * @return Whether or not a value was erased.
+     */
+    bool erase(uint64_t id);
+
+    void clear();
+
+    std::size_t size() const;
+
+    bool empty() const;
+
+    /*!
+     * Calls the function with the id and value of every entry. The table
+     * must not be modified while iterating.
+     */
+    template <typename Function>
+    void for_each(Function&& function);
+
+    void swap(wamp_id_map& other);
+
+private:
+    wamp_id_map(const wamp_id_map&) = delete;
+    wamp_id_map& operator=(const wamp_id_map&) = delete;
+
+    struct slot
+    {
+        uint64_t id;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T& value() { return *reinterpret_cast<T*>(&storage); }
+    };
+
+    std::size_t index_of(uint64_t id) const;
+    std::size_t find_slot(uint64_t id) const;
+    void erase_slot(std::size_t index);
+    void grow();
+
+private:
+    std::vector<slot> m_slots;
+    std::size_t m_size;
+    unsigned m_shift;
+};
+
+} // namespace autobahn
+
+#include "wamp_id_map.ipp"
+
+#endif // AUTOBAHN_WAMP_ID_MAP_HPP
@@ -0,0 +1,261 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <new>
+#include <utility>
+
+namespace autobahn {
+
+template <typename T>
+wamp_id_map<T>::wamp_id_map()
+    : m_slots()
+    , m_size(0)
+    , m_shift(64)
+{
+}
+
+template <typename T>
+wamp_id_map<T>::wamp_id_map(wamp_id_map&& other)
+    : m_slots()
+    , m_size(0)
+    , m_shift(64)
+{
+    swap(other);
+}
+
+template <typename T>
+wamp_id_map<T>::~wamp_id_map()
+{
+    clear();
+}
+
+template <typename T>
+wamp_id_map<T>& wamp_id_map<T>::operator=(wamp_id_map&& other)
+{
+    if (this != &other) {
+        clear();
+        swap(other);
+    }
+    return *this;
+}
+
+template <typename T>
+template <typename... Args>
+T& wamp_id_map<T>::emplace(uint64_t id, Args&&... args)
+{
+    assert(id != 0);
+
+    if ((m_size + 1) * 2 > m_slots.size()) {
+        grow();
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t index = index_of(id);
+    while (m_slots[index].id != 0) {
+        if (m_slots[index].id == id) {
+            return m_slots[index].value();
+        }
+        index = (index + 1) & mask;
+    }
+
+    new (&m_slots[index].storage) T(std::forward<Args>(args)...);
+    m_slots[index].id = id;
+    ++m_size;
+
+    return m_slots[index].value();
+}
+
+template <typename T>
+T* wamp_id_map<T>::find(uint64_t id)
+{
+    std::size_t index = find_slot(id);
+    return index == m_slots.size() ? nullptr : &m_slots[index].value();
+}
+
+template <typename T>
+const T* wamp_id_map<T>::find(uint64_t id) const
+{
+    return const_cast<wamp_id_map<T>*>(this)->find(id);
+}
+
+template <typename T>
+T wamp_id_map<T>::take(uint64_t id)
+{
+    std::size_t index = find_slot(id);
+    assert(index != m_slots.size());
+
+    T value(std::move(m_slots[index].value()));
+    erase_slot(index);
+
+    return value;
+}
+
+template <typename T>
+bool wamp_id_map<T>::erase(uint64_t id)
+{
+    std::size_t index = find_slot(id);
+    if (index == m_slots.size()) {
+        return false;
+    }
+
+    erase_slot(index);
+    return true;
+}
+
+template <typename T>
+void wamp_id_map<T>::clear()
+{
+    for (auto& slot : m_slots) {
+        if (slot.id != 0) {
+            slot.value().~T();
+            slot.id = 0;
+        }
+    }
+    m_size = 0;
+}
+
+template <typename T>
+std::size_t wamp_id_map<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+bool wamp_id_map<T>::empty() const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+template <typename Function>
+void wamp_id_map<T>::for_each(Function&& function)
+{
+    for (auto& slot : m_slots) {
+        if (slot.id != 0) {
+            function(slot.id, slot.value());
+        }
+    }
+}
+
+template <typename T>
+void wamp_id_map<T>::swap(wamp_id_map& other)
+{
+    m_slots.swap(other.m_slots);
+    std::swap(m_size, other.m_size);
+    std::swap(m_shift, other.m_shift);
+}
+
+template <typename T>
+std::size_t wamp_id_map<T>::index_of(uint64_t id) const
+{
+    // Fibonacci hashing: multiply by 2^64 / phi and keep the high bits.
+    return static_cast<std::size_t>((id * UINT64_C(11400714819323198485)) >> m_shift);
+}
+
+template <typename T>
+std::size_t wamp_id_map<T>::find_slot(uint64_t id) const
+{
+    if (m_size == 0 || id == 0) {
+        return m_slots.size();
+    }
+
+    const std::size_t mask = m_slots.size() - 1;
+    std::size_t index = index_of(id);
+    while (m_slots[index].id != 0) {
+        if (m_slots[index].id == id) {
+            return index;
+        }
+        index = (index + 1) & mask;
+    }
+
+    return m_slots.size();
+}
+
+template <typename T>
+void wamp_id_map<T>::erase_slot(std::size_t index)
+{
+    const std::size_t mask = m_slots.size() - 1;
+
+    m_slots[index].value().~T();
+    m_slots[index].id = 0;
+    --m_size;
+
+    // Shift back any entries that were displaced past the freed slot so
+    // that lookups never need to skip over holes.
+    std::size_t hole = index;
+    std::size_t next = (index + 1) & mask;
+    while (m_slots[next].id != 0) {
+        std::size_t home = index_of(m_slots[next].id);
+        if (((next - home) & mask) >= ((next - hole) & mask)) {
+            new (&m_slots[hole].storage) T(std::move(m_slots[next].value()));
+            m_slots[hole].id = m_slots[next].id;
+            m_slots[next].value().~T();
+            m_slots[next].id = 0;
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+}
+
+template <typename T>
+void wamp_id_map<T>::grow()
+{
+    const std::size_t capacity = m_slots.empty() ? 16 : m_slots.size() * 2;
+
+    std::vector<slot> slots(capacity);
+    for (auto& slot : slots) {
+        slot.id = 0;
+    }
+
+    m_slots.swap(slots);
+    m_shift = 64;
+    for (std::size_t size = capacity; size > 1; size >>= 1) {
+        --m_shift;
+    }
+
+    const std::size_t mask = capacity - 1;
+    for (auto& slot : slots) {
+        if (slot.id == 0) {
+            continue;
+        }
+
+        std::size_t index = index_of(slot.id);
+        while (m_slots[index].id != 0) {
+            index = (index + 1) & mask;
+        }
+
+        new (&m_slots[index].storage) T(std::move(slot.value()));
+        m_slots[index].id = slot.id;
+        slot.value().~T();
+    }
+}
+
+} // namespace autobahn
@@ -32,11 +32,15 @@
 #define AUTOBAHN_WAMP_INVOCATION_HPP
 
 #include "wamp_arguments.hpp"
+#include "wamp_call_result.hpp"
 
+#include <atomic>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <memory>
 #include <msgpack.hpp>
+#include <mutex>
 #include <string>
 
 namespace autobahn {
@@ -48,6 +52,7 @@ class wamp_invocation_impl
 public:
     wamp_invocation_impl();
     wamp_invocation_impl(wamp_invocation_impl&&) = delete; // copy wamp_invocation instead
+    ~wamp_invocation_impl();
 
     //add URI and details
     /*!
@@ -244,6 +249,50 @@ public:
             const std::string& error_uri,
             const List& arguments, const Map& kw_arguments);
 
+    /*!
+     * Handler invoked when the caller cancels the call, with the cancel mode
+     * requested by the caller ("kill" or "killnowait").
+     */
+    using interrupt_handler = std::function<void(const std::string& mode)>;
+
+    /*!
+     * Whether or not the caller has cancelled the call. Long running
+     * procedures should check this regularly and stop early, e.g. by
+     * replying with error("wamp.error.canceled"). With the "kill" mode the
+     * router waits for such a reply. Thread-safe.
+     */
+    bool is_canceled() const;
+
+    /*!
+     * Sets the handler to invoke when the caller cancels the call. The
+     * handler runs on the io service, or right away on the calling thread
+     * if the call has already been cancelled. Thread-safe.
+     */
+    void set_interrupt_handler(interrupt_handler handler);
+
+    /*!
+     * Handler receiving the further chunks of a progressive call, each with
+     * its own positional and keyword arguments. The last chunk is flagged
+     * as final.
+     */
+    using chunk_handler = std::function<void(const wamp_call_result& chunk, bool final)>;
+
+    /*!
+     * Checks if the caller sends its arguments in several chunks. The
+     * invocation's own arguments are then the first chunk and the rest are
+     * passed to the chunk handler.
+     */
+    bool progressive_call() const;
+
+    /*!
+     * Sets the handler to receive the further chunks of a progressive call.
+     * Chunks arriving before the handler is set are kept and passed to it
+     * right away on the calling thread, later ones are passed on the io
+     * service. Chunks are always passed in order and one at a time.
+     * Thread-safe.
+     */
+    void set_chunk_handler(chunk_handler handler);
+
     //
     // functions only called internally by wamp_session
 
@@ -254,6 +303,8 @@ public:
 
     using send_result_fn = std::function<void(const std::shared_ptr<wamp_message>&)>;
     void set_send_result_fn(send_result_fn&&);
+    using release_fn = std::function<void()>;
+    void set_release_fn(release_fn&&);
     void set_details(const msgpack::object& details);
     void set_request_id(std::uint64_t);
 	std::uint64_t get_request_id();
@@ -261,6 +312,8 @@ public:
     void set_arguments(const msgpack::object& arguments);
     void set_kw_arguments(const msgpack::object& kw_arguments);
     bool sendable() const;
+    void interrupt(const std::string& mode);
+    void add_chunk(wamp_call_result&& chunk, bool final);
 
 private:
     void throw_if_not_sendable() const;
@@ -270,6 +323,8 @@ private:
 
     template <typename List, typename Map>
     void send_result(const List& arguments, const Map& kw_arguments, result_type resultType);
+
+    void deliver_chunks(std::unique_lock<std::mutex>& lock);
 private:
 
 
@@ -277,9 +332,28 @@ private:
     msgpack::object m_arguments;
     msgpack::object m_kw_arguments;
     send_result_fn m_send_result_fn;
+    release_fn m_release_fn;
     std::uint64_t m_request_id;
     std::string m_uri;
     bool m_progressive_results_expected;
+
+    std::atomic<bool> m_canceled;
+    std::mutex m_interrupt_mutex;
+    interrupt_handler m_interrupt_handler;
+    std::string m_interrupt_mode;
+
+    struct pending_chunk
+    {
+        wamp_call_result arguments;
+        bool final;
+    };
+
+    bool m_progressive_call;
+    bool m_awaiting_chunks;
+    std::mutex m_chunk_mutex;
+    chunk_handler m_chunk_handler;
+    std::deque<pending_chunk> m_chunks;
+    bool m_delivering_chunks;
 };
 
 using wamp_invocation = std::shared_ptr<wamp_invocation_impl>;
@@ -42,9 +42,34 @@ inline wamp_invocation_impl::wamp_invocation_impl()
     , m_arguments(EMPTY_ARGUMENTS)
     , m_kw_arguments(EMPTY_KW_ARGUMENTS)
     , m_send_result_fn()
+    , m_release_fn()
     , m_request_id(0)
     , m_progressive_results_expected(false)
-{
+    , m_canceled(ATOMIC_VAR_INIT(false))
+    , m_interrupt_mutex()
+    , m_interrupt_handler()
+    , m_interrupt_mode()
+    , m_progressive_call(false)
+    , m_awaiting_chunks(false)
+    , m_chunk_mutex()
+    , m_chunk_handler()
+    , m_chunks()
+    , m_delivering_chunks(false)
+{
+}
+
+inline wamp_invocation_impl::~wamp_invocation_impl()
+{
+    // Dropped without a final answer: let the session forget about it. A
+    // progressive call still sending chunks is forgotten once its last
+    // chunk arrives instead, so that the chunks in between are not taken
+    // for new invocations.
+    if (m_release_fn && sendable() && !m_awaiting_chunks) {
+        try {
+            m_release_fn();
+        } catch (...) {
+        }
+    }
 }
 
 inline const std::string& wamp_invocation_impl::uri() const
@@ -343,10 +368,17 @@ inline void wamp_invocation_impl::set_send_result_fn(send_result_fn&& send_resul
     m_send_result_fn = std::move(send_result);
 }
 
+inline void wamp_invocation_impl::set_release_fn(release_fn&& release)
+{
+    m_release_fn = std::move(release);
+}
+
 inline void wamp_invocation_impl::set_details(const msgpack::object& details)
 {
     m_uri = std::move(value_for_key_or<std::string>(details, "procedure", std::string()));
     m_progressive_results_expected = value_for_key_or<bool>(details, "receive_progress", false);
+    m_progressive_call = value_for_key_or<bool>(details, "progress", false);
+    m_awaiting_chunks = m_progressive_call;
 }
 
 inline void wamp_invocation_impl::set_request_id(std::uint64_t request_id)
@@ -379,6 +411,96 @@ inline bool wamp_invocation_impl::sendable() const
     return static_cast<bool>(m_send_result_fn);
 }
 
+inline bool wamp_invocation_impl::is_canceled() const
+{
+    return m_canceled.load();
+}
+
+inline void wamp_invocation_impl::set_interrupt_handler(interrupt_handler handler)
+{
+    std::string mode;
+    {
+        std::lock_guard<std::mutex> lock(m_interrupt_mutex);
+        if (!m_canceled.load()) {
+            m_interrupt_handler = std::move(handler);
+            return;
+        }
+        mode = m_interrupt_mode;
+    }
+
+    if (handler) {
+        handler(mode);
+    }
+}
+
+inline bool wamp_invocation_impl::progressive_call() const
+{
+    return m_progressive_call;
+}
+
+inline void wamp_invocation_impl::set_chunk_handler(chunk_handler handler)
+{
+    std::unique_lock<std::mutex> lock(m_chunk_mutex);
+    m_chunk_handler = std::move(handler);
+    deliver_chunks(lock);
+}
+
+inline void wamp_invocation_impl::add_chunk(wamp_call_result&& chunk, bool final)
+{
+    std::unique_lock<std::mutex> lock(m_chunk_mutex);
+    if (final) {
+        m_awaiting_chunks = false;
+    }
+    m_chunks.push_back(pending_chunk{std::move(chunk), final});
+    deliver_chunks(lock);
+}
+
+inline void wamp_invocation_impl::deliver_chunks(std::unique_lock<std::mutex>& lock)
+{
+    // Only one thread delivers at a time, chunks added meanwhile are picked
+    // up by it so that the handler never runs concurrently or out of order.
+    if (!m_chunk_handler || m_delivering_chunks) {
+        return;
+    }
+    m_delivering_chunks = true;
+
+    while (!m_chunks.empty() && m_chunk_handler) {
+        pending_chunk chunk(std::move(m_chunks.front()));
+        m_chunks.pop_front();
+        chunk_handler handler = m_chunk_handler;
+
+        lock.unlock();
+        try {
+            handler(chunk.arguments, chunk.final);
+        } catch (...) {
+            lock.lock();
+            m_delivering_chunks = false;
+            throw;
+        }
+        lock.lock();
+    }
+
+    m_delivering_chunks = false;
+}
+
+inline void wamp_invocation_impl::interrupt(const std::string& mode)
+{
+    interrupt_handler handler;
+    {
+        std::lock_guard<std::mutex> lock(m_interrupt_mutex);
+        if (m_canceled.load()) {
+            return;
+        }
+        m_interrupt_mode = mode;
+        m_canceled.store(true);
+        handler = std::move(m_interrupt_handler);
+    }
+
+    if (handler) {
+        handler(mode);
+    }
+}
+
 inline void wamp_invocation_impl::throw_if_not_sendable() const
 {
     if (!sendable()) {
@@ -0,0 +1,109 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_LIMITED_EXECUTOR_HPP
+#define AUTOBAHN_WAMP_LIMITED_EXECUTOR_HPP
+
+#include "wamp_executor.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+
+namespace autobahn {
+
+/*!
+ * Runs tasks on another executor while capping how many of them run at the
+ * same time. Tasks beyond the cap wait in a backlog of their own, so they do
+ * not occupy the underlying executor until they can start.
+ *
+ * Must be owned by a std::shared_ptr, as running tasks keep it alive.
+ */
+class wamp_limited_executor :
+        public wamp_executor,
+        public std::enable_shared_from_this<wamp_limited_executor>
+{
+public:
+    /*!
+     * @param executor The executor to run tasks on.
+     * @param max_concurrency The maximum number of tasks running at once,
+     *        at least one.
+     */
+    wamp_limited_executor(
+            const std::shared_ptr<wamp_executor>& executor,
+            std::size_t max_concurrency);
+
+    /*!
+     * @copydoc wamp_executor::post()
+     */
+    virtual void post(task&& task) override;
+
+    /*!
+     * @copydoc wamp_executor::metrics()
+     *
+     * The queue depth and wait time only cover the backlog of this executor.
+     */
+    virtual wamp_executor_metrics metrics() const override;
+
+    /*!
+     * The maximum number of tasks running at once.
+     */
+    std::size_t max_concurrency() const;
+
+private:
+    struct queued_task
+    {
+        task function;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    void run_next();
+
+private:
+    const std::shared_ptr<wamp_executor> m_executor;
+    const std::size_t m_max_concurrency;
+
+    mutable std::mutex m_mutex;
+    std::deque<queued_task> m_backlog;
+
+    // The number of runners posted to the underlying executor.
+    std::size_t m_running;
+
+    wamp_executor_metrics m_metrics;
+};
+
+} // namespace autobahn
+
+#include "wamp_limited_executor.ipp"
+
+#endif // AUTOBAHN_WAMP_LIMITED_EXECUTOR_HPP
@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_limited_executor::wamp_limited_executor(
+        const std::shared_ptr<wamp_executor>& executor,
+        std::size_t max_concurrency)
+    : m_executor(executor)
+    , m_max_concurrency(max_concurrency)
+    , m_mutex()
+    , m_backlog()
+    , m_running(0)
+    , m_metrics()
+{
+    if (!m_executor) {
+        throw std::invalid_argument("limited executor needs an executor");
+    }
+
+    if (m_max_concurrency == 0) {
+        throw std::invalid_argument("limited executor needs a concurrency of at least one");
+    }
+}
+
+inline void wamp_limited_executor::post(task&& task)
+{
+    queued_task queued;
+    queued.function = std::move(task);
+    queued.queued = std::chrono::steady_clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_backlog.push_back(std::move(queued));
+        if (m_running == m_max_concurrency) {
+            return;
+        }
+        ++m_running;
+    }
+
+    auto self = shared_from_this();
+    m_executor->post([self]() { self->run_next(); });
+}
+
+inline wamp_executor_metrics wamp_limited_executor::metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    wamp_executor_metrics metrics = m_metrics;
+    metrics.queue_depth = m_backlog.size();
+    return metrics;
+}
+
+inline std::size_t wamp_limited_executor::max_concurrency() const
+{
+    return m_max_concurrency;
+}
+
+inline void wamp_limited_executor::run_next()
+{
+    queued_task queued;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Another runner may have taken the task this one was posted for.
+        if (m_backlog.empty()) {
+            --m_running;
+            return;
+        }
+
+        queued = std::move(m_backlog.front());
+        m_backlog.pop_front();
+
+        auto wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - queued.queued);
+        ++m_metrics.executed;
+        m_metrics.total_wait += wait;
+        if (wait > m_metrics.max_wait) {
+            m_metrics.max_wait = wait;
+        }
+    }
+
+    // Catch here rather than leave it to the underlying executor, so that
+    // a throwing task does not leak its concurrency slot.
+    bool failed = false;
+    try {
+        queued.function();
+    } catch (...) {
+        failed = true;
+    }
+    queued.function = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (failed) {
+            ++m_metrics.failed;
+        }
+        if (m_backlog.empty()) {
+            --m_running;
+            return;
+        }
+    }
+
+    // Repost rather than loop, so that a busy backlog does not monopolise a
+    // thread of the underlying executor.
+    auto self = shared_from_this();
+    m_executor->post([self]() { self->run_next(); });
+}
+
+} // namespace autobahn
@@ -0,0 +1,240 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_LOG_SINK_HPP
+#define AUTOBAHN_WAMP_LOG_SINK_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * The severity of a log record.
+ */
+enum class log_level : uint8_t
+{
+    trace = 0,
+    debug = 1,
+    info = 2,
+    warning = 3,
+    error = 4,
+    off = 5
+};
+
+/*!
+ * What a log record describes. Message events carry a binary summary of
+ * the message (type, request id and size) rather than the formatted message.
+ */
+enum class log_event : uint8_t
+{
+    message_sent,
+    message_received,
+    transport,
+    session,
+    dispatch
+};
+
+/*!
+ * A fixed size, binary encoded log record. Records are produced on the hot
+ * path and only formatted once they reach the sink.
+ */
+struct log_record
+{
+    /*!
+     * The maximum number of characters of free text kept in a record.
+     */
+    static const std::size_t TEXT_LENGTH = 40;
+
+    /*!
+     * Nanoseconds since the epoch of the steady clock.
+     */
+    uint64_t timestamp;
+
+    /*!
+     * The request, subscription or registration id the record refers to.
+     */
+    uint64_t id;
+
+    /*!
+     * The size in octets of the serialized message, if any.
+     */
+    uint32_t size;
+
+    log_level level;
+
+    log_event event;
+
+    /*!
+     * The wamp message type, or zero if the record is not about a message.
+     */
+    uint8_t message_type;
+
+    /*!
+     * The truncated, null terminated free text of the record.
+     */
+    char text[TEXT_LENGTH];
+};
+
+/*!
+ * A destination for log records.
+ */
+class wamp_log_sink
+{
+public:
+    virtual ~wamp_log_sink() = default;
+
+    /*!
+     * Accepts a record. This is called from the thread that logs and must
+     * not block.
+     *
+     * @param record The record to write.
+     */
+    virtual void write(const log_record& record) = 0;
+
+    /*!
+     * Formats a record as a single line of text.
+     *
+     * @param out The stream to write to.
+     * @param record The record to format.
+     */
+    static void format(std::ostream& out, const log_record& record);
+};
+
+/*!
+ * A sink that hands records to a background thread through a bounded,
+ * lock-free queue. The background thread formats records and writes them to
+ * the output stream, flushing only when the queue runs empty. It is started
+ * by the first record written and sleeps while there is nothing to write.
+ *
+ * Producers never block. Records are dropped when the queue is full or when
+ * more than the configured number of records per second are written. The
+ * number of dropped records is reported on the output stream.
+ */
+class wamp_async_log_sink : public wamp_log_sink
+{
+public:
+    /*!
+     * Constructs an asynchronous sink. The background thread is started
+     * once the first record is written.
+     *
+     * @param out The stream to write formatted records to.
+     * @param capacity The capacity of the queue, rounded up to a power of two.
+     * @param max_records_per_second The rate limit, zero for no limit.
+     */
+    wamp_async_log_sink(
+            std::ostream& out,
+            std::size_t capacity = 8192,
+            uint32_t max_records_per_second = 10000);
+
+    virtual ~wamp_async_log_sink() override;
+
+    /*!
+     * @copydoc wamp_log_sink::write()
+     */
+    virtual void write(const log_record& record) override;
+
+    /*!
+     * The total number of records dropped so far.
+     */
+    uint64_t dropped() const;
+
+    /*!
+     * The process wide sink writing to std::clog, used by default.
+     */
+    static std::shared_ptr<wamp_log_sink> default_sink();
+
+private:
+    wamp_async_log_sink(const wamp_async_log_sink&) = delete;
+    wamp_async_log_sink& operator=(const wamp_async_log_sink&) = delete;
+
+    bool try_acquire_rate(uint64_t timestamp);
+    bool try_enqueue(const log_record& record);
+    bool try_dequeue(log_record& record);
+    bool has_record() const;
+    void start();
+    void wake();
+    void drain(uint64_t& reported_dropped);
+    void run();
+
+private:
+    struct cell
+    {
+        std::atomic<std::size_t> sequence;
+        log_record record;
+    };
+
+    std::ostream& m_out;
+
+    std::vector<cell> m_cells;
+
+    std::size_t m_mask;
+
+    /*!
+     * Producer and consumer positions, padded onto separate cache lines.
+     */
+    std::atomic<std::size_t> m_enqueue_position;
+    char m_enqueue_padding[64 - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> m_dequeue_position;
+    char m_dequeue_padding[64 - sizeof(std::atomic<std::size_t>)];
+
+    uint32_t m_max_records_per_second;
+
+    /*!
+     * The current rate limiting window (in seconds) in the upper 32 bits
+     * and the number of records accepted in it in the lower 32 bits, so
+     * that starting a new window and counting in it is a single atomic
+     * update.
+     */
+    std::atomic<uint64_t> m_rate_state;
+
+    std::atomic<uint64_t> m_dropped;
+
+    std::atomic<bool> m_started;
+    std::atomic<bool> m_sleeping;
+    std::atomic<bool> m_stopped;
+    std::mutex m_wakeup_mutex;
+    std::condition_variable m_wakeup;
+
+    std::thread m_thread;
+};
+
+} // namespace autobahn
+
+#include "wamp_log_sink.ipp"
+
+#endif // AUTOBAHN_WAMP_LOG_SINK_HPP
@@ -0,0 +1,278 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wamp_message_type.hpp"
+
+#include <iostream>
+
+namespace autobahn {
+
+inline void wamp_log_sink::format(std::ostream& out, const log_record& record)
+{
+    static const char* level_names[] = { "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "OFF" };
+    static const char* event_names[] = { "TX", "RX", "transport", "session", "dispatch" };
+
+    out << '[' << record.timestamp / 1000 << "] "
+        << level_names[static_cast<int>(record.level)] << ' '
+        << event_names[static_cast<int>(record.event)] << ':';
+
+    if (record.text[0] != '\0') {
+        out << ' ' << record.text;
+    }
+    if (record.message_type != 0) {
+        out << " type=" << to_string(static_cast<message_type>(record.message_type));
+    }
+    if (record.id != 0) {
+        out << " id=" << record.id;
+    }
+    if (record.size != 0) {
+        out << " size=" << record.size;
+    }
+    out << '\n';
+}
+
+inline wamp_async_log_sink::wamp_async_log_sink(
+        std::ostream& out,
+        std::size_t capacity,
+        uint32_t max_records_per_second)
+    : m_out(out)
+    , m_cells()
+    , m_mask(0)
+    , m_enqueue_position(0)
+    , m_dequeue_position(0)
+    , m_max_records_per_second(max_records_per_second)
+    , m_rate_state(0)
+    , m_dropped(0)
+    , m_started(false)
+    , m_sleeping(false)
+    , m_stopped(false)
+    , m_wakeup_mutex()
+    , m_wakeup()
+    , m_thread()
+{
+    std::size_t size = 2;
+    while (size < capacity) {
+        size <<= 1;
+    }
+
+    m_cells = std::vector<cell>(size);
+    for (std::size_t i = 0; i < size; ++i) {
+        m_cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    m_mask = size - 1;
+}
+
+inline wamp_async_log_sink::~wamp_async_log_sink()
+{
+    {
+        std::lock_guard<std::mutex> guard(m_wakeup_mutex);
+        m_stopped.store(true);
+    }
+    m_wakeup.notify_one();
+
+    // No thread is started once stopped, so this is the last look at it.
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+inline void wamp_async_log_sink::write(const log_record& record)
+{
+    // Dropped records are reported along with the next record written.
+    if (!try_acquire_rate(record.timestamp) || !try_enqueue(record)) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (!m_started.load(std::memory_order_acquire)) {
+        start();
+    }
+    wake();
+}
+
+inline uint64_t wamp_async_log_sink::dropped() const
+{
+    return m_dropped.load(std::memory_order_relaxed);
+}
+
+inline std::shared_ptr<wamp_log_sink> wamp_async_log_sink::default_sink()
+{
+    static std::shared_ptr<wamp_log_sink> sink = std::make_shared<wamp_async_log_sink>(std::clog);
+    return sink;
+}
+
+inline bool wamp_async_log_sink::try_acquire_rate(uint64_t timestamp)
+{
+    if (m_max_records_per_second == 0) {
+        return true;
+    }
+
+    // A fixed one second window is good enough to keep a flood of records
+    // from swamping the output, and costs a single compare and swap. Records
+    // stamped slightly before the current window count against it rather
+    // than moving the window back.
+    const uint64_t window = timestamp / 1000000000;
+    uint64_t state = m_rate_state.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t next;
+        if (window > (state >> 32)) {
+            next = (window << 32) | 1;
+        } else if ((state & 0xFFFFFFFF) < m_max_records_per_second) {
+            next = state + 1;
+        } else {
+            return false;
+        }
+
+        if (m_rate_state.compare_exchange_weak(state, next, std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+}
+
+inline bool wamp_async_log_sink::try_enqueue(const log_record& record)
+{
+    std::size_t position = m_enqueue_position.load(std::memory_order_relaxed);
+    for (;;) {
+        cell& slot = m_cells[position & m_mask];
+        std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+        std::ptrdiff_t difference =
+                static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+
+        if (difference == 0) {
+            if (m_enqueue_position.compare_exchange_weak(
+                    position, position + 1, std::memory_order_relaxed)) {
+                slot.record = record;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The queue is full.
+            return false;
+        } else {
+            position = m_enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+inline bool wamp_async_log_sink::has_record() const
+{
+    const std::size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+    return m_cells[position & m_mask].sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+inline void wamp_async_log_sink::start()
+{
+    std::lock_guard<std::mutex> guard(m_wakeup_mutex);
+    if (m_started.load(std::memory_order_relaxed) || m_stopped.load()) {
+        return;
+    }
+
+    m_thread = std::thread(&wamp_async_log_sink::run, this);
+    m_started.store(true, std::memory_order_release);
+}
+
+inline void wamp_async_log_sink::wake()
+{
+    // Pairs with the fence in run(): either the background thread sees the
+    // record before it sleeps, or this sees it sleeping. Taking the mutex
+    // makes sure it is waiting before it is notified.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_relaxed)) {
+        {
+            std::lock_guard<std::mutex> guard(m_wakeup_mutex);
+        }
+        m_wakeup.notify_one();
+    }
+}
+
+inline bool wamp_async_log_sink::try_dequeue(log_record& record)
+{
+    // Only the background thread dequeues.
+    std::size_t position = m_dequeue_position.load(std::memory_order_relaxed);
+    cell& slot = m_cells[position & m_mask];
+    std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+    if (sequence != position + 1) {
+        return false;
+    }
+
+    record = slot.record;
+    slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+    m_dequeue_position.store(position + 1, std::memory_order_relaxed);
+    return true;
+}
+
+inline void wamp_async_log_sink::drain(uint64_t& reported_dropped)
+{
+    bool written = false;
+    log_record record;
+    while (try_dequeue(record)) {
+        format(m_out, record);
+        written = true;
+    }
+
+    const uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+    if (dropped != reported_dropped) {
+        m_out << "log records dropped: " << dropped - reported_dropped << '\n';
+        reported_dropped = dropped;
+        written = true;
+    }
+
+    // An idle sink leaves the stream alone.
+    if (written) {
+        m_out.flush();
+    }
+}
+
+inline void wamp_async_log_sink::run()
+{
+    uint64_t reported_dropped = 0;
+
+    for (;;) {
+        drain(reported_dropped);
+
+        std::unique_lock<std::mutex> lock(m_wakeup_mutex);
+        if (m_stopped.load()) {
+            lock.unlock();
+            drain(reported_dropped);
+            return;
+        }
+
+        // Producers only notify while we are sleeping, see wake().
+        m_sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!has_record()) {
+            m_wakeup.wait(lock);
+        }
+        m_sleeping.store(false, std::memory_order_relaxed);
+    }
+}
+
+} // namespace autobahn
@@ -0,0 +1,137 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_LOGGER_HPP
+#define AUTOBAHN_WAMP_LOGGER_HPP
+
+#include "wamp_log_sink.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/*!
+ * The lowest level that is compiled in, as an integer value of log_level.
+ * Log statements below this level are removed at compile time, e.g. define
+ * it as 2 to drop all trace and debug statements from a release build.
+ */
+#ifndef AUTOBAHN_LOG_MIN_LEVEL
+#define AUTOBAHN_LOG_MIN_LEVEL 0
+#endif
+
+/*!
+ * Logs through the given logger if the level is both compiled in and enabled
+ * at runtime. The arguments are only evaluated when the record is written.
+ */
+#if AUTOBAHN_LOG_MIN_LEVEL > 0
+#define AUTOBAHN_LOG(logger, level, ...) \
+    do { \
+        if (static_cast<int>(level) >= AUTOBAHN_LOG_MIN_LEVEL && (logger).is_enabled(level)) { \
+            (logger).log(level, __VA_ARGS__); \
+        } \
+    } while (0)
+#else
+#define AUTOBAHN_LOG(logger, level, ...) \
+    do { \
+        if ((logger).is_enabled(level)) { \
+            (logger).log(level, __VA_ARGS__); \
+        } \
+    } while (0)
+#endif
+
+namespace autobahn {
+
+class wamp_message;
+
+/*!
+ * A lightweight logging facade. A logger filters records by level and passes
+ * them on to a sink. Records are small binary summaries, so logging a message
+ * costs a few stores rather than formatting the whole message.
+ */
+class wamp_logger
+{
+public:
+    /*!
+     * Constructs a logger writing to the default asynchronous sink.
+     *
+     * @param level The minimum level to log.
+     */
+    explicit wamp_logger(log_level level = log_level::warning);
+
+    /*!
+     * Constructs a logger writing to the given sink.
+     *
+     * @param level The minimum level to log.
+     * @param sink The sink to write records to.
+     */
+    wamp_logger(log_level level, const std::shared_ptr<wamp_log_sink>& sink);
+
+    log_level level() const;
+
+    /*!
+     * Changes the minimum level to log. May be called while other threads
+     * are logging, which pick up the new level eventually.
+     */
+    void set_level(log_level level);
+
+    void set_sink(const std::shared_ptr<wamp_log_sink>& sink);
+
+    bool is_enabled(log_level level) const;
+
+    /*!
+     * Logs free text, with an optional id.
+     */
+    void log(log_level level, log_event event, const char* text, uint64_t id = 0) const;
+
+    /*!
+     * Logs a summary of a message: its type, request id and serialized size.
+     */
+    void log(log_level level, log_event event, const wamp_message& message, std::size_t size = 0) const;
+
+    /*!
+     * Logs free text along with the serialized size of a message.
+     */
+    void log(log_level level, log_event event, const char* text, uint64_t id, std::size_t size) const;
+
+private:
+    void fill(log_record& record, log_level level, log_event event) const;
+
+private:
+    // Read on every log statement from any thread, hence relaxed atomic.
+    std::atomic<log_level> m_level;
+    std::shared_ptr<wamp_log_sink> m_sink;
+};
+
+} // namespace autobahn
+
+#include "wamp_logger.ipp"
+
+#endif // AUTOBAHN_WAMP_LOGGER_HPP
@@ -0,0 +1,121 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "wamp_message.hpp"
+
+#include <chrono>
+#include <cstring>
+
+namespace autobahn {
+
+inline wamp_logger::wamp_logger(log_level level)
+    : m_level(level)
+    , m_sink(wamp_async_log_sink::default_sink())
+{
+}
+
+inline wamp_logger::wamp_logger(log_level level, const std::shared_ptr<wamp_log_sink>& sink)
+    : m_level(level)
+    , m_sink(sink)
+{
+}
+
+inline log_level wamp_logger::level() const
+{
+    return m_level.load(std::memory_order_relaxed);
+}
+
+inline void wamp_logger::set_level(log_level level)
+{
+    m_level.store(level, std::memory_order_relaxed);
+}
+
+inline void wamp_logger::set_sink(const std::shared_ptr<wamp_log_sink>& sink)
+{
+    m_sink = sink;
+}
+
+inline bool wamp_logger::is_enabled(log_level level) const
+{
+    return level >= m_level.load(std::memory_order_relaxed) && m_sink;
+}
+
+inline void wamp_logger::log(log_level level, log_event event, const char* text, uint64_t id) const
+{
+    log(level, event, text, id, 0);
+}
+
+inline void wamp_logger::log(
+        log_level level, log_event event, const char* text, uint64_t id, std::size_t size) const
+{
+    log_record record;
+    fill(record, level, event);
+    record.id = id;
+    record.size = static_cast<uint32_t>(size);
+
+    std::strncpy(record.text, text, log_record::TEXT_LENGTH - 1);
+    record.text[log_record::TEXT_LENGTH - 1] = '\0';
+
+    m_sink->write(record);
+}
+
+inline void wamp_logger::log(
+        log_level level, log_event event, const wamp_message& message, std::size_t size) const
+{
+    log_record record;
+    fill(record, level, event);
+    record.size = static_cast<uint32_t>(size);
+    record.text[0] = '\0';
+
+    // Every message starts with its type and nearly all of them carry a
+    // request or session id in the second field.
+    if (message.size() > 0 && message.field(0).type == msgpack::type::POSITIVE_INTEGER) {
+        record.message_type = static_cast<uint8_t>(message.field(0).via.u64);
+    }
+    if (message.size() > 1 && message.field(1).type == msgpack::type::POSITIVE_INTEGER) {
+        record.id = message.field(1).via.u64;
+    }
+
+    m_sink->write(record);
+}
+
+inline void wamp_logger::fill(log_record& record, log_level level, log_event event) const
+{
+    record.timestamp = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch()).count());
+    record.id = 0;
+    record.size = 0;
+    record.level = level;
+    record.event = event;
+    record.message_type = 0;
+}
+
+} // namespace autobahn
@@ -28,6 +28,8 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <map>
+
 namespace autobahn {
 
 inline std::string to_string(message_type type)
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_MPSC_QUEUE_HPP
+#define AUTOBAHN_WAMP_MPSC_QUEUE_HPP
+
+#include <atomic>
+
+namespace autobahn {
+
+/*!
+ * The link embedded in every element of a wamp_mpsc_queue.
+ */
+class wamp_mpsc_node
+{
+public:
+    wamp_mpsc_node();
+
+    std::atomic<wamp_mpsc_node*> m_next;
+};
+
+/*!
+ * An intrusive, unbounded, multi-producer single-consumer queue.
+ *
+ * Pushing is wait-free (a single atomic exchange) and popping is lock-free,
+ * neither allocates as the link is embedded in the element. Any thread may
+ * push, but only one thread at a time may pop. The queue never owns its
+ * elements.
+ *
+ * @tparam Node The element type, which must derive from wamp_mpsc_node.
+ */
+template <typename Node>
+class wamp_mpsc_queue
+{
+public:
+    wamp_mpsc_queue();
+
+    /*!
+     * Appends an element. May be called from any thread.
+     */
+    void push(Node* node);
+
+    /*!
+     * Removes the oldest element. Consumer thread only.
+     *
+     * @return The element, or nullptr if the queue is empty or the oldest
+     *         element is still being pushed.
+     */
+    Node* pop();
+
+    /*!
+     * Whether or not all pushed elements have been popped. Unlike a nullptr
+     * from pop(), this also accounts for elements that are still being
+     * pushed. The result is only stable on the consumer thread.
+     */
+    bool empty() const;
+
+private:
+    wamp_mpsc_queue(const wamp_mpsc_queue&) = delete;
+    wamp_mpsc_queue& operator=(const wamp_mpsc_queue&) = delete;
+
+    void push_node(wamp_mpsc_node* node);
+
+private:
+    std::atomic<wamp_mpsc_node*> m_head;
+
+    // Only written by the consumer. It is atomic so that empty() may be
+    // used to check for work after handing the consumer role to another
+    // thread.
+    std::atomic<wamp_mpsc_node*> m_tail;
+    wamp_mpsc_node m_stub;
+};
+
+} // namespace autobahn
+
+#include "wamp_mpsc_queue.ipp"
+
+#endif // AUTOBAHN_WAMP_MPSC_QUEUE_HPP
@@ -0,0 +1,104 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace autobahn {
+
+inline wamp_mpsc_node::wamp_mpsc_node()
+    : m_next(nullptr)
+{
+}
+
+template <typename Node>
+wamp_mpsc_queue<Node>::wamp_mpsc_queue()
+    : m_head(&m_stub)
+    , m_tail(&m_stub)
+    , m_stub()
+{
+}
+
+template <typename Node>
+void wamp_mpsc_queue<Node>::push(Node* node)
+{
+    push_node(node);
+}
+
+template <typename Node>
+Node* wamp_mpsc_queue<Node>::pop()
+{
+    wamp_mpsc_node* tail = m_tail.load(std::memory_order_relaxed);
+    wamp_mpsc_node* next = tail->m_next.load(std::memory_order_acquire);
+
+    // Skip over the stub, it is only there to keep the queue non-empty.
+    if (tail == &m_stub) {
+        if (next == nullptr) {
+            return nullptr;
+        }
+        m_tail.store(next, std::memory_order_relaxed);
+        tail = next;
+        next = next->m_next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr) {
+        m_tail.store(next, std::memory_order_relaxed);
+        return static_cast<Node*>(tail);
+    }
+
+    // The tail is the last element unless a producer is half way through
+    // pushing, in which case we have to wait for it to link its element.
+    if (tail != m_head.load()) {
+        return nullptr;
+    }
+
+    push_node(&m_stub);
+
+    next = tail->m_next.load(std::memory_order_acquire);
+    if (next != nullptr) {
+        m_tail.store(next, std::memory_order_relaxed);
+        return static_cast<Node*>(tail);
+    }
+
+    return nullptr;
+}
+
+template <typename Node>
+bool wamp_mpsc_queue<Node>::empty() const
+{
+    return m_head.load() == m_tail.load(std::memory_order_relaxed);
+}
+
+template <typename Node>
+void wamp_mpsc_queue<Node>::push_node(wamp_mpsc_node* node)
+{
+    node->m_next.store(nullptr, std::memory_order_relaxed);
+    wamp_mpsc_node* previous = m_head.exchange(node);
+    previous->m_next.store(node, std::memory_order_release);
+}
+
+} // namespace autobahn
@@ -0,0 +1,74 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_MSGPACK_SERIALIZER_HPP
+#define AUTOBAHN_WAMP_MSGPACK_SERIALIZER_HPP
+
+#include "wamp_serializer.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <msgpack.hpp>
+#include <string>
+
+namespace autobahn {
+
+/*!
+ * A serializer that encodes wamp messages using MessagePack.
+ */
+class wamp_msgpack_serializer : public wamp_serializer
+{
+public:
+    /*!
+     * @copydoc wamp_serializer::rawsocket_serializer_id()
+     */
+    virtual uint8_t rawsocket_serializer_id() const override;
+
+    /*!
+     * @copydoc wamp_serializer::websocket_subprotocol()
+     */
+    virtual std::string websocket_subprotocol() const override;
+
+    /*!
+     * @copydoc wamp_serializer::serialize()
+     */
+    virtual void serialize(const wamp_message& message, msgpack::sbuffer& buffer) const override;
+
+    /*!
+     * @copydoc wamp_serializer::deserialize()
+     */
+    virtual wamp_message deserialize(const char* data, std::size_t length) const override;
+};
+
+} // namespace autobahn
+
+#include "wamp_msgpack_serializer.ipp"
+
+#endif // AUTOBAHN_WAMP_MSGPACK_SERIALIZER_HPP
@@ -0,0 +1,69 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "exceptions.hpp"
+#include "wamp_message.hpp"
+
+namespace autobahn {
+
+inline uint8_t wamp_msgpack_serializer::rawsocket_serializer_id() const
+{
+    return 0x02;
+}
+
+inline std::string wamp_msgpack_serializer::websocket_subprotocol() const
+{
+    return "wamp.2.msgpack";
+}
+
+inline void wamp_msgpack_serializer::serialize(
+        const wamp_message& message, msgpack::sbuffer& buffer) const
+{
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack(message.fields());
+}
+
+inline wamp_message wamp_msgpack_serializer::deserialize(
+        const char* data, std::size_t length) const
+{
+    msgpack::unpacked result;
+    msgpack::unpack(result, data, length);
+
+    if (result.get().type != msgpack::type::ARRAY) {
+        throw protocol_error("invalid message structure - message is not an array");
+    }
+
+    wamp_message::message_fields fields;
+    result.get().convert(fields);
+
+    return wamp_message(std::move(fields), std::move(*(result.zone())));
+}
+
+} // namespace autobahn
@@ -31,20 +31,34 @@
 #ifndef AUTOBAHN_WAMP_PUBLICATION_HPP
 #define AUTOBAHN_WAMP_PUBLICATION_HPP
 
+#include <chrono>
 #include <cstdint>
 
 namespace autobahn {
 
-/// Represents a topic subscription.
+/// Represents a published event.
 class wamp_publication
 {
 public:
     wamp_publication();
     wamp_publication(uint64_t id);
+    wamp_publication(uint64_t id, const std::chrono::nanoseconds& latency);
+
+    /*!
+     * The publication id assigned by the router, or 0 if the publish was
+     * not acknowledged.
+     */
     uint64_t id() const;
 
+    /*!
+     * The time from sending the event to receiving the router's
+     * acknowledgement, or 0 if the publish was not acknowledged.
+     */
+    const std::chrono::nanoseconds& latency() const;
+
 private:
     uint64_t m_id;
+    std::chrono::nanoseconds m_latency;
 };
 
 } // namespace autobahn
@@ -32,11 +32,19 @@ namespace autobahn {
 
 inline wamp_publication::wamp_publication()
     : m_id(0)
+    , m_latency(0)
 {
 }
 
 inline wamp_publication::wamp_publication(uint64_t id)
     : m_id(id)
+    , m_latency(0)
+{
+}
+
+inline wamp_publication::wamp_publication(uint64_t id, const std::chrono::nanoseconds& latency)
+    : m_id(id)
+    , m_latency(latency)
 {
 }
 
@@ -45,4 +53,9 @@ inline uint64_t wamp_publication::id() const
     return m_id;
 }
 
+inline const std::chrono::nanoseconds& wamp_publication::latency() const
+{
+    return m_latency;
+}
+
 } // namespace autobahn
@@ -0,0 +1,94 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_PUBLISH_OPTIONS_HPP
+#define AUTOBAHN_WAMP_PUBLISH_OPTIONS_HPP
+
+namespace autobahn {
+
+/*!
+ * Whether an event is delivered to the publishing session's own handlers
+ * directly, without the round-trip through the router.
+ */
+enum class wamp_local_delivery
+{
+    /// The event is only sent to the router. The default.
+    none,
+    /// The session's matching handlers receive the event directly and the
+    /// router copy is sent with exclude_me, so it only reaches other
+    /// sessions.
+    local_and_router,
+    /// Only the session's matching handlers receive the event, nothing is
+    /// sent to the router.
+    local_only
+};
+
+class wamp_publish_options
+{
+public:
+    wamp_publish_options();
+
+    wamp_publish_options(wamp_publish_options&& other) = delete;
+    wamp_publish_options(const wamp_publish_options& other) = delete;
+    wamp_publish_options& operator=(wamp_publish_options&& other) = delete;
+    wamp_publish_options& operator=(const wamp_publish_options& other) = delete;
+
+    /*!
+     * Whether or not the router is asked to acknowledge the publish.
+     */
+    bool acknowledge() const;
+
+    /*!
+     * Asks the router to acknowledge the publish. The publish then only
+     * completes once the router accepted the event, or fails with the
+     * router's error. Acknowledged publishes count towards the session's
+     * publish window, see wamp_session::set_publish_window().
+     */
+    void set_acknowledge(bool acknowledge);
+
+    /*!
+     * Whether the event is delivered to the session's own subscriptions
+     * directly. The handlers then get the publisher's argument objects,
+     * without any serialization, on the io service. A local only publish
+     * completes right away, acknowledged or not.
+     */
+    wamp_local_delivery local_delivery() const;
+    void set_local_delivery(wamp_local_delivery local_delivery);
+
+private:
+    bool m_acknowledge;
+    wamp_local_delivery m_local_delivery;
+};
+
+} // namespace autobahn
+
+#include "wamp_publish_options.ipp"
+
+#endif // AUTOBAHN_WAMP_PUBLISH_OPTIONS_HPP
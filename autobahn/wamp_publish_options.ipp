@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <msgpack.hpp>
+#include <string>
+#include <unordered_map>
+
+namespace autobahn {
+
+inline wamp_publish_options::wamp_publish_options()
+    : m_acknowledge(false)
+    , m_local_delivery(wamp_local_delivery::none)
+{
+}
+
+inline bool wamp_publish_options::acknowledge() const
+{
+    return m_acknowledge;
+}
+
+inline void wamp_publish_options::set_acknowledge(bool acknowledge)
+{
+    m_acknowledge = acknowledge;
+}
+
+inline wamp_local_delivery wamp_publish_options::local_delivery() const
+{
+    return m_local_delivery;
+}
+
+inline void wamp_publish_options::set_local_delivery(wamp_local_delivery local_delivery)
+{
+    m_local_delivery = local_delivery;
+}
+
+} // namespace autobahn
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+
+template<>
+struct convert<autobahn::wamp_publish_options>
+{
+    msgpack::object const& operator()(
+            msgpack::object const& object,
+            autobahn::wamp_publish_options& options) const
+    {
+        std::unordered_map<std::string, msgpack::object> options_map;
+        object >> options_map;
+
+        const auto acknowledge_itr = options_map.find("acknowledge");
+        if (acknowledge_itr != options_map.end()) {
+            options.set_acknowledge(acknowledge_itr->second.as<bool>());
+        }
+
+        return object;
+    }
+};
+
+template<>
+struct pack<autobahn::wamp_publish_options>
+{
+    template <typename Stream>
+    msgpack::packer<Stream>& operator()(
+            msgpack::packer<Stream>& packer,
+            autobahn::wamp_publish_options const& options) const
+    {
+        const bool exclude_me =
+                options.local_delivery() == autobahn::wamp_local_delivery::local_and_router;
+
+        packer.pack_map((options.acknowledge() ? 1 : 0) + (exclude_me ? 1 : 0));
+        if (options.acknowledge()) {
+            packer.pack(std::string("acknowledge"));
+            packer.pack(true);
+        }
+        if (exclude_me) {
+            packer.pack(std::string("exclude_me"));
+            packer.pack(true);
+        }
+
+        return packer;
+    }
+};
+
+template <>
+struct object_with_zone<autobahn::wamp_publish_options>
+{
+    void operator()(
+            msgpack::object::with_zone& object,
+            const autobahn::wamp_publish_options& options)
+    {
+        std::unordered_map<std::string, msgpack::object> options_map;
+
+        if (options.acknowledge()) {
+            options_map["acknowledge"] = msgpack::object(true);
+        }
+        if (options.local_delivery() == autobahn::wamp_local_delivery::local_and_router) {
+            options_map["exclude_me"] = msgpack::object(true);
+        }
+
+        object << options_map;
+    }
+};
+
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
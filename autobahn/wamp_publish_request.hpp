@@ -0,0 +1,80 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
+#define AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
+
+#include "boost_config.hpp"
+#include "wamp_publication.hpp"
+#include "wamp_publish_options.hpp"
+
+#include <boost/thread/future.hpp>
+#include <chrono>
+
+namespace autobahn {
+
+/// An outstanding publish with options.
+class wamp_publish_request
+{
+public:
+    explicit wamp_publish_request(
+            bool acknowledge, wamp_local_delivery local_delivery = wamp_local_delivery::none);
+
+    /*!
+     * Whether or not the publish completes on the router's acknowledgement
+     * rather than once it has been sent.
+     */
+    bool acknowledge() const;
+
+    /*!
+     * Whether the event is also delivered to the session's own handlers.
+     */
+    wamp_local_delivery local_delivery() const;
+
+    boost::promise<wamp_publication>& response();
+
+    /*!
+     * When the publish was sent, which its latency is measured from.
+     */
+    const std::chrono::steady_clock::time_point& sent() const;
+    void set_sent(const std::chrono::steady_clock::time_point& sent);
+
+private:
+    bool m_acknowledge;
+    wamp_local_delivery m_local_delivery;
+    boost::promise<wamp_publication> m_response;
+    std::chrono::steady_clock::time_point m_sent;
+};
+
+} // namespace autobahn
+
+#include "wamp_publish_request.ipp"
+
+#endif // AUTOBAHN_WAMP_PUBLISH_REQUEST_HPP
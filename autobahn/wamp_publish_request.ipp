@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+namespace autobahn {
+
+inline wamp_publish_request::wamp_publish_request(
+        bool acknowledge, wamp_local_delivery local_delivery)
+    : m_acknowledge(acknowledge)
+    , m_local_delivery(local_delivery)
+    , m_response()
+    , m_sent()
+{
+}
+
+inline bool wamp_publish_request::acknowledge() const
+{
+    return m_acknowledge;
+}
+
+inline wamp_local_delivery wamp_publish_request::local_delivery() const
+{
+    return m_local_delivery;
+}
+
+inline boost::promise<wamp_publication>& wamp_publish_request::response()
+{
+    return m_response;
+}
+
+inline const std::chrono::steady_clock::time_point& wamp_publish_request::sent() const
+{
+    return m_sent;
+}
+
+inline void wamp_publish_request::set_sent(const std::chrono::steady_clock::time_point& sent)
+{
+    m_sent = sent;
+}
+
+} // namespace autobahn
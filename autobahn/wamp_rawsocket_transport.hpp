@@ -32,13 +32,16 @@
 #define AUTOBAHN_WAMP_NETWORK_TRANSPORT_HPP
 
 #include "boost_config.hpp"
+#include "wamp_logger.hpp"
+#include "wamp_msgpack_serializer.hpp"
+#include "wamp_serializer.hpp"
 #include "wamp_transport.hpp"
 
 #include <boost/thread/future.hpp>
 #include <boost/asio/io_service.hpp>
 #include <cstddef>
 #include <memory>
-#include <msgpack.hpp>
+#include <vector>
 
 namespace autobahn {
 
@@ -74,11 +77,15 @@ public:
      *
      * @param io_service The io service to use for asynchronous operations.
      * @param remote_endpoint The remote endpoint to connect to.
+     * @param debug_enabled Whether or not to log every message at debug level.
+     * @param serializer The serializer to request in the rawsocket handshake.
      */
     wamp_rawsocket_transport(
             boost::asio::io_service& io_service,
             const endpoint_type& remote_endpoint,
-            bool debug_enabled=false);
+            bool debug_enabled=false,
+            const std::shared_ptr<wamp_serializer>& serializer =
+                    std::make_shared<wamp_msgpack_serializer>());
 
     virtual ~wamp_rawsocket_transport() override = default;
 
@@ -108,6 +115,21 @@ public:
      */
     virtual void send_message(wamp_message&& message) override;
 
+    /*!
+     * @copydoc wamp_transport::send_messages()
+     */
+    virtual void send_messages(std::vector<wamp_message>&& messages) override;
+
+    /*!
+     * @copydoc wamp_transport::serializer()
+     */
+    virtual std::shared_ptr<wamp_serializer> serializer() const override;
+
+    /*!
+     * @copydoc wamp_transport::send_frame()
+     */
+    virtual void send_frame(msgpack::sbuffer&& frame) override;
+
     /*!
      * @copydoc wamp_transport::set_pause_handler()
      */
@@ -150,6 +172,12 @@ public:
      */
     virtual bool has_handler() const override;
 
+    /*!
+     * The logger used by the transport. Its level and sink may be changed
+     * before connecting.
+     */
+    wamp_logger& logger();
+
 protected:
     socket_type& socket();
 
@@ -169,6 +197,8 @@ private:
             const boost::system::error_code& error,
             std::size_t /* bytes transferred */);
 
+    bool write_frame(const msgpack::sbuffer& frame);
+
     void close_socket(bool was_clean, const std::string &reason);
 
 private:
@@ -218,14 +248,19 @@ private:
     uint32_t m_message_length;
 
     /*!
-     * Used for unpacking serialized messages.
+     * Buffer used for receiving serialized messages.
+     */
+    std::vector<char> m_message_buffer;
+
+    /*!
+     * The serializer used to encode and decode messages.
      */
-    msgpack::unpacker m_message_unpacker;
+    std::shared_ptr<wamp_serializer> m_serializer;
 
     /*!
-     * Whether or not debugging is enabled.
+     * The logger for transport events and message summaries.
      */
-    bool m_debug_enabled;
+    wamp_logger m_logger;
 };
 
 } // namespace autobahn
@@ -36,6 +36,7 @@
 #include <boost/asio/placeholders.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <cstring>
 #include <system_error>
 
 namespace autobahn {
@@ -44,7 +45,8 @@ template <class Socket>
 wamp_rawsocket_transport<Socket>::wamp_rawsocket_transport(
             boost::asio::io_service& io_service,
             const endpoint_type& remote_endpoint,
-            bool debug_enabled)
+            bool debug_enabled,
+            const std::shared_ptr<wamp_serializer>& serializer)
     : wamp_transport()
     , m_socket(io_service)
     , m_remote_endpoint(remote_endpoint)
@@ -52,8 +54,9 @@ wamp_rawsocket_transport<Socket>::wamp_rawsocket_transport(
     , m_disconnect()
     , m_handshake_buffer()
     , m_message_length(0)
-    , m_message_unpacker()
-    , m_debug_enabled(debug_enabled)
+    , m_message_buffer()
+    , m_serializer(serializer)
+    , m_logger(debug_enabled ? log_level::trace : log_level::warning)
 {
     memset(m_handshake_buffer, 0, sizeof(m_handshake_buffer));
 }
@@ -67,7 +70,7 @@ boost::future<void> wamp_rawsocket_transport<Socket>::connect()
     }
 
     std::weak_ptr<wamp_rawsocket_transport<Socket>> weak_self = this->shared_from_this();
-    auto connect_handler = [=](const boost::system::error_code& error_code) {
+    auto connect_handler = [this, weak_self](const boost::system::error_code& error_code) {
         auto shared_self = weak_self.lock();
         if (!shared_self) {
             return;
@@ -86,7 +89,8 @@ boost::future<void> wamp_rawsocket_transport<Socket>::connect()
         // Send the initial handshake packet informing the server which
         // serialization format we wish to use, and our maximum message size.
         m_handshake_buffer[0] = 0x7F; // magic byte
-        m_handshake_buffer[1] = 0xF2; // we are ready to receive messages up to 2**24 octets and encoded using MsgPack
+        // we are ready to receive messages up to 2**24 octets and encoded using our serializer
+        m_handshake_buffer[1] = 0xF0 | (m_serializer->rawsocket_serializer_id() & 0x0F);
         m_handshake_buffer[2] = 0x00; // reserved
         m_handshake_buffer[3] = 0x00; // reserved
 
@@ -94,7 +98,7 @@ boost::future<void> wamp_rawsocket_transport<Socket>::connect()
                 m_socket,
                 boost::asio::buffer(m_handshake_buffer, sizeof(m_handshake_buffer)));
 
-        auto handshake_reply = [=](
+        auto handshake_reply = [this, weak_self](
                 const boost::system::error_code& error,
                 std::size_t bytes_transferred) {
             auto shared_self = weak_self.lock();
@@ -153,26 +157,73 @@ bool wamp_rawsocket_transport<Socket>::is_connected() const
 template <class Socket>
 void wamp_rawsocket_transport<Socket>::send_message(wamp_message&& message)
 {
-    auto buffer = std::make_shared<msgpack::sbuffer>();
-    msgpack::packer<msgpack::sbuffer> packer(*buffer);
-    packer.pack(message.fields());
+    msgpack::sbuffer buffer;
+    m_serializer->serialize(message, buffer);
 
+    if (write_frame(buffer)) {
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_sent, message, buffer.size());
+    }
+}
+
+template <class Socket>
+void wamp_rawsocket_transport<Socket>::send_messages(std::vector<wamp_message>&& messages)
+{
+    // Frame every message into one buffer so the batch takes a single write.
+    msgpack::sbuffer buffer;
+    for (const auto& message : messages) {
+        const std::size_t offset = buffer.size();
+        uint32_t length = 0;
+        buffer.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        m_serializer->serialize(message, buffer);
+
+        length = htonl(buffer.size() - offset - sizeof(length));
+        std::memcpy(buffer.data() + offset, &length, sizeof(length));
+    }
+
+    boost::system::error_code ec;
+    boost::asio::write(m_socket, boost::asio::buffer(buffer.data(), buffer.size()), ec);
+    if (ec) {
+        close_socket(false, ec.message());
+        return;
+    }
+
+    AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_sent,
+            "TX message batch", messages.size(), buffer.size());
+}
+
+template <class Socket>
+std::shared_ptr<wamp_serializer> wamp_rawsocket_transport<Socket>::serializer() const
+{
+    return m_serializer;
+}
+
+template <class Socket>
+void wamp_rawsocket_transport<Socket>::send_frame(msgpack::sbuffer&& frame)
+{
+    if (write_frame(frame)) {
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_sent,
+                "TX pre-encoded frame", 0, frame.size());
+    }
+}
+
+template <class Socket>
+bool wamp_rawsocket_transport<Socket>::write_frame(const msgpack::sbuffer& frame)
+{
     // Write the length prefix as the message header.
-    uint32_t length = htonl(buffer->size());
+    uint32_t length = htonl(frame.size());
     boost::system::error_code ec;
     boost::asio::write(m_socket, boost::asio::buffer(&length, sizeof(length)), ec);
 
     if (!ec) {
         // Write actual serialized message.
-        boost::asio::write(m_socket, boost::asio::buffer(buffer->data(), buffer->size()), ec);
-        if (m_debug_enabled) {
-            std::cerr << "TX message (" << buffer->size() << " octets) ..." << std::endl;
-            std::cerr << "TX message: " << message << std::endl;
-        }
+        boost::asio::write(m_socket, boost::asio::buffer(frame.data(), frame.size()), ec);
     }
     if (ec) {
         close_socket(false, ec.message());
+        return false;
     }
+
+    return true;
 }
 
 template <class Socket>
@@ -239,24 +290,27 @@ Socket& wamp_rawsocket_transport<Socket>::socket()
     return m_socket;
 }
 
+template <class Socket>
+wamp_logger& wamp_rawsocket_transport<Socket>::logger()
+{
+    return m_logger;
+}
+
 template <class Socket>
 void wamp_rawsocket_transport<Socket>::handshake_reply_handler(
         const boost::system::error_code& error_code,
         std::size_t /* bytes_transferred */)
 {
     if (error_code) {
-        if (m_debug_enabled) {
-            std::cerr << "rawsocket handshake error: " << error_code << std::endl;
-        }
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::transport,
+                "rawsocket handshake error", error_code.value());
 
         m_connect.set_exception(
                 std::system_error(error_code.value(), std::system_category(), "async_read"));
         return;
     }
 
-    if (m_debug_enabled) {
-        std::cerr << "RawSocket handshake reply received" << std::endl;
-    }
+    AUTOBAHN_LOG(m_logger, log_level::trace, log_event::transport, "rawsocket handshake reply received");
 
     if (m_handshake_buffer[0] != 0x7F) {
         m_connect.set_exception(protocol_error("invalid handshake frame"));
@@ -266,9 +320,8 @@ void wamp_rawsocket_transport<Socket>::handshake_reply_handler(
     // Indicates that the handshake reply is an error.
     if ((m_handshake_buffer[1] & 0x0F) == 0x00) {
         uint32_t error = m_handshake_buffer[1] & 0xF0;
-        if (m_debug_enabled) {
-            std::cerr << "rawsocket handshake error: " << std::hex << error << std::endl;
-        }
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::transport,
+                "rawsocket handshake error", error);
 
         std::stringstream error_string;
         if (error == 0x00) {
@@ -290,17 +343,13 @@ void wamp_rawsocket_transport<Socket>::handshake_reply_handler(
     }
 
     uint32_t serializer_type = (m_handshake_buffer[1] & 0x0F);
-    if (serializer_type == 0x01) {
-        m_connect.set_exception(protocol_error("json currently not supported"));
-    } else if (serializer_type == 0x02) {
-        if (m_debug_enabled) {
-            std::cerr << "connect successful: valid handshake" << std::endl;
-        }
+    if (serializer_type == m_serializer->rawsocket_serializer_id()) {
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::transport, "connect successful: valid handshake");
         m_connect.set_value();
         receive_message();
     } else {
         std::stringstream error_string;
-        error_string << "rawsocket handshake error: invalid serializer type (" << serializer_type << ")";
+        error_string << "rawsocket handshake error: unexpected serializer type (" << serializer_type << ")";
         m_connect.set_exception(protocol_error(error_string.str()));
     }
 }
@@ -308,9 +357,7 @@ void wamp_rawsocket_transport<Socket>::handshake_reply_handler(
 template <class Socket>
 void wamp_rawsocket_transport<Socket>::receive_message()
 {
-    if (m_debug_enabled) {
-        std::cerr << "RX preparing to receive message .." << std::endl;
-    }
+    AUTOBAHN_LOG(m_logger, log_level::trace, log_event::transport, "RX preparing to receive message");
 
     boost::asio::async_read(
         m_socket,
@@ -327,26 +374,25 @@ void wamp_rawsocket_transport<Socket>::receive_message_header(
         std::size_t /* bytes transferred */)
 {
     if (error_code) {
+        if (error_code != boost::asio::error::operation_aborted) {
+            AUTOBAHN_LOG(m_logger, log_level::debug, log_event::transport,
+                    "receive error", error_code.value());
+        }
         std::stringstream sstr;
         sstr << "Receive error: " << error_code << std::endl;
-        if (m_debug_enabled && error_code != boost::asio::error::operation_aborted) {
-            std::cerr << sstr.str();
-        }
         close_socket(false, sstr.str());
         return;
     }
 
     m_message_length = ntohl(m_message_length);
 
-    if (m_debug_enabled) {
-        std::cerr << "RX message (" << m_message_length << " octets) ..." << std::endl;
-    }
+    AUTOBAHN_LOG(m_logger, log_level::trace, log_event::transport, "RX message header", 0, m_message_length);
 
-    m_message_unpacker.reserve_buffer(m_message_length);
+    m_message_buffer.resize(m_message_length);
 
     boost::asio::async_read(
         m_socket,
-        boost::asio::buffer(m_message_unpacker.buffer(), m_message_length),
+        boost::asio::buffer(m_message_buffer.data(), m_message_length),
         bind(&wamp_rawsocket_transport<Socket>::receive_message_body,
             this->shared_from_this(),
             boost::asio::placeholders::error,
@@ -359,37 +405,24 @@ void wamp_rawsocket_transport<Socket>::receive_message_body(
         std::size_t /* bytes transferred */)
 {
     if (error_code) {
+        if (error_code != boost::asio::error::operation_aborted) {
+            AUTOBAHN_LOG(m_logger, log_level::debug, log_event::transport,
+                    "receive error", error_code.value());
+        }
         std::stringstream sstr;
         sstr << "Receive error: " << error_code << std::endl;
-        if (m_debug_enabled && error_code != boost::asio::error::operation_aborted) {
-            std::cerr << sstr.str();
-        }
         close_socket(false, sstr.str());
         return;
     }
 
-    if (m_debug_enabled) {
-        std::cerr << "RX message received." << std::endl;
-    }
-
     if (m_handler) {
-        m_message_unpacker.buffer_consumed(m_message_length);
-        msgpack::unpacked result;
-
-        while (m_message_unpacker.next(&result)) {
-            wamp_message::message_fields fields;
-            result.get().convert(fields);
-
-            wamp_message message(std::move(fields), std::move(*(result.zone())));
-            if (m_debug_enabled) {
-                std::cerr << "RX message: " << message << std::endl;
-            }
-            if (m_handler) {
-                m_handler->on_message(std::move(message));
-            }
-        }
+        wamp_message message = m_serializer->deserialize(
+                m_message_buffer.data(), m_message_length);
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_received, message, m_message_length);
+        m_handler->on_message(std::move(message));
     } else {
-        std::cerr << "RX message ignored: no handler attached" << std::endl;
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::message_received,
+                "RX message ignored: no handler attached", 0, m_message_length);
     }
 
     receive_message();
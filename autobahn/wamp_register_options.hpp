@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_REGISTER_OPTIONS_HPP
+#define AUTOBAHN_WAMP_REGISTER_OPTIONS_HPP
+
+#include "wamp_uri_trie.hpp"
+
+#include <cstdint>
+
+namespace autobahn {
+
+/*!
+ * How the router picks the callee of a procedure that several sessions
+ * have registered.
+ */
+enum class wamp_invoke
+{
+    /// A single callee, further registrations are refused.
+    single,
+    /// The callees in turn.
+    roundrobin,
+    /// A callee at random.
+    random,
+    /// The callee that registered first.
+    first,
+    /// The callee that registered last.
+    last
+};
+
+/*!
+ * The name of an invocation policy in the WAMP register options.
+ */
+const char* to_string(wamp_invoke invoke);
+
+class wamp_register_options
+{
+public:
+    wamp_register_options();
+
+    wamp_register_options(wamp_register_options&& other) = delete;
+    wamp_register_options(const wamp_register_options& other) = delete;
+    wamp_register_options& operator=(wamp_register_options&& other) = delete;
+    wamp_register_options& operator=(const wamp_register_options& other) = delete;
+
+    /*!
+     * How the router matches called URIs against the registered URI.
+     */
+    wamp_match match() const;
+
+    /*!
+     * Registers a pattern rather than a single procedure. The invocations
+     * then carry the called URI, which wamp_session::add_procedure_route()
+     * can dispatch on.
+     */
+    void set_match(wamp_match match);
+
+    /*!
+     * How the router distributes calls between the sessions registering
+     * the procedure. Anything other than single lets several callees share
+     * the registration, which is how a procedure is scaled out.
+     */
+    wamp_invoke invoke() const;
+    void set_invoke(wamp_invoke invoke);
+
+    /*!
+     * The maximum number of invocations the router may have outstanding
+     * with this callee at a time, 0 for no limit.
+     */
+    uint32_t concurrency() const;
+    void set_concurrency(uint32_t concurrency);
+
+private:
+    wamp_match m_match;
+    wamp_invoke m_invoke;
+    uint32_t m_concurrency;
+};
+
+} // namespace autobahn
+
+#include "wamp_register_options.ipp"
+
+#endif // AUTOBAHN_WAMP_REGISTER_OPTIONS_HPP
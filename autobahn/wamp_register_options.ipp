@@ -0,0 +1,203 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <map>
+#include <msgpack.hpp>
+#include <string>
+#include <unordered_map>
+
+namespace autobahn {
+
+inline const char* to_string(wamp_invoke invoke)
+{
+    switch (invoke) {
+        case wamp_invoke::single:
+            return "single";
+        case wamp_invoke::roundrobin:
+            return "roundrobin";
+        case wamp_invoke::random:
+            return "random";
+        case wamp_invoke::first:
+            return "first";
+        case wamp_invoke::last:
+            return "last";
+    }
+
+    return "single";
+}
+
+inline wamp_register_options::wamp_register_options()
+    : m_match(wamp_match::exact)
+    , m_invoke(wamp_invoke::single)
+    , m_concurrency(0)
+{
+}
+
+inline wamp_match wamp_register_options::match() const
+{
+    return m_match;
+}
+
+inline void wamp_register_options::set_match(wamp_match match)
+{
+    m_match = match;
+}
+
+inline wamp_invoke wamp_register_options::invoke() const
+{
+    return m_invoke;
+}
+
+inline void wamp_register_options::set_invoke(wamp_invoke invoke)
+{
+    m_invoke = invoke;
+}
+
+inline uint32_t wamp_register_options::concurrency() const
+{
+    return m_concurrency;
+}
+
+inline void wamp_register_options::set_concurrency(uint32_t concurrency)
+{
+    m_concurrency = concurrency;
+}
+
+} // namespace autobahn
+
+namespace msgpack {
+MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS) {
+namespace adaptor {
+
+template<>
+struct convert<autobahn::wamp_register_options>
+{
+    msgpack::object const& operator()(
+            msgpack::object const& object,
+            autobahn::wamp_register_options& options) const
+    {
+        std::unordered_map<std::string, msgpack::object> options_map;
+        object >> options_map;
+
+        const auto match_itr = options_map.find("match");
+        if (match_itr != options_map.end()) {
+            const std::string match = match_itr->second.as<std::string>();
+            if (match == "prefix") {
+                options.set_match(autobahn::wamp_match::prefix);
+            } else if (match == "wildcard") {
+                options.set_match(autobahn::wamp_match::wildcard);
+            } else {
+                options.set_match(autobahn::wamp_match::exact);
+            }
+        }
+
+        const auto invoke_itr = options_map.find("invoke");
+        if (invoke_itr != options_map.end()) {
+            const std::string invoke = invoke_itr->second.as<std::string>();
+            if (invoke == "roundrobin") {
+                options.set_invoke(autobahn::wamp_invoke::roundrobin);
+            } else if (invoke == "random") {
+                options.set_invoke(autobahn::wamp_invoke::random);
+            } else if (invoke == "first") {
+                options.set_invoke(autobahn::wamp_invoke::first);
+            } else if (invoke == "last") {
+                options.set_invoke(autobahn::wamp_invoke::last);
+            } else {
+                options.set_invoke(autobahn::wamp_invoke::single);
+            }
+        }
+
+        const auto concurrency_itr = options_map.find("concurrency");
+        if (concurrency_itr != options_map.end()) {
+            options.set_concurrency(concurrency_itr->second.as<uint32_t>());
+        }
+
+        return object;
+    }
+};
+
+template<>
+struct pack<autobahn::wamp_register_options>
+{
+    template <typename Stream>
+    msgpack::packer<Stream>& operator()(
+            msgpack::packer<Stream>& packer,
+            autobahn::wamp_register_options const& options) const
+    {
+        const bool match = options.match() != autobahn::wamp_match::exact;
+        const bool invoke = options.invoke() != autobahn::wamp_invoke::single;
+        const bool concurrency = options.concurrency() != 0;
+
+        packer.pack_map((match ? 1 : 0) + (invoke ? 1 : 0) + (concurrency ? 1 : 0));
+        if (match) {
+            packer.pack(std::string("match"));
+            packer.pack(std::string(autobahn::to_string(options.match())));
+        }
+        if (invoke) {
+            packer.pack(std::string("invoke"));
+            packer.pack(std::string(autobahn::to_string(options.invoke())));
+        }
+        if (concurrency) {
+            packer.pack(std::string("concurrency"));
+            packer.pack(options.concurrency());
+        }
+
+        return packer;
+    }
+};
+
+template <>
+struct object_with_zone<autobahn::wamp_register_options>
+{
+    void operator()(
+            msgpack::object::with_zone& object,
+            const autobahn::wamp_register_options& options)
+    {
+        std::map<std::string, msgpack::object> options_map;
+
+        if (options.match() != autobahn::wamp_match::exact) {
+            options_map["match"] = msgpack::object(
+                    std::string(autobahn::to_string(options.match())), object.zone);
+        }
+        if (options.invoke() != autobahn::wamp_invoke::single) {
+            options_map["invoke"] = msgpack::object(
+                    std::string(autobahn::to_string(options.invoke())), object.zone);
+        }
+        if (options.concurrency() != 0) {
+            options_map["concurrency"] = msgpack::object(options.concurrency(), object.zone);
+        }
+
+        object << options_map;
+    }
+};
+
+} // namespace adaptor
+} // MSGPACK_API_VERSION_NAMESPACE(MSGPACK_DEFAULT_API_NS)
+} // namespace msgpack
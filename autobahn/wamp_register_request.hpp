@@ -31,11 +31,11 @@
 #ifndef AUTOBAHN_WAMP_REGISTER_REQUEST_HPP
 #define AUTOBAHN_WAMP_REGISTER_REQUEST_HPP
 
+#include "wamp_completion.hpp"
 #include "wamp_procedure.hpp"
 #include "wamp_registration.hpp"
-#include "boost_config.hpp"
 
-#include <boost/thread/future.hpp>
+#include <string>
 
 namespace autobahn {
 
@@ -45,16 +45,31 @@ class wamp_register_request
 public:
     wamp_register_request();
     wamp_register_request(const wamp_procedure& procedure);
+    wamp_register_request(
+            const wamp_procedure& procedure,
+            wamp_completion<wamp_registration>&& response);
     wamp_register_request(wamp_register_request&& other);
 
     const wamp_procedure& procedure() const;
-    boost::promise<wamp_registration>& response();
+    wamp_completion<wamp_registration>& response();
     void set_procedure(wamp_procedure procedure) const;
     void set_response(const wamp_registration& registration);
 
+    /// The URI of a procedure registered for exact matches, which calls
+    /// from the same session may be dispatched to locally. Empty for
+    /// pattern-based registrations.
+    const std::string& local_uri() const;
+
+    /// Whether or not the registration may be shared with other callees.
+    bool shared() const;
+
+    void set_local_uri(const std::string& uri, bool shared);
+
 private:
     wamp_procedure m_procedure;
-    boost::promise<wamp_registration> m_response;
+    wamp_completion<wamp_registration> m_response;
+    std::string m_local_uri;
+    bool m_shared;
 };
 
 } // namespace autobahn
@@ -33,18 +33,34 @@ namespace autobahn {
 inline wamp_register_request::wamp_register_request()
     : m_procedure()
     , m_response()
+    , m_local_uri()
+    , m_shared(false)
 {
 }
 
 inline wamp_register_request::wamp_register_request(const wamp_procedure& procedure)
     : m_procedure(procedure)
     , m_response()
+    , m_local_uri()
+    , m_shared(false)
+{
+}
+
+inline wamp_register_request::wamp_register_request(
+        const wamp_procedure& procedure,
+        wamp_completion<wamp_registration>&& response)
+    : m_procedure(procedure)
+    , m_response(std::move(response))
+    , m_local_uri()
+    , m_shared(false)
 {
 }
 
 inline wamp_register_request::wamp_register_request(wamp_register_request&& other)
     : m_procedure(std::move(other.m_procedure))
     , m_response(std::move(other.m_response))
+    , m_local_uri(std::move(other.m_local_uri))
+    , m_shared(other.m_shared)
 {
 }
 
@@ -53,7 +69,7 @@ inline const wamp_procedure& wamp_register_request::procedure() const
     return m_procedure;
 }
 
-inline boost::promise<wamp_registration>& wamp_register_request::response()
+inline wamp_completion<wamp_registration>& wamp_register_request::response()
 {
     return m_response;
 }
@@ -63,4 +79,20 @@ inline void wamp_register_request::set_response(const wamp_registration& registr
     m_response.set_value(registration);
 }
 
+inline const std::string& wamp_register_request::local_uri() const
+{
+    return m_local_uri;
+}
+
+inline bool wamp_register_request::shared() const
+{
+    return m_shared;
+}
+
+inline void wamp_register_request::set_local_uri(const std::string& uri, bool shared)
+{
+    m_local_uri = uri;
+    m_shared = shared;
+}
+
 } // namespace autobahn
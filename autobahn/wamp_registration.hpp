@@ -41,10 +41,17 @@ class wamp_registration
 public:
     wamp_registration();
     wamp_registration(uint64_t id);
+    wamp_registration(uint64_t id, uint64_t session_id);
+
     uint64_t id() const;
 
+    /// The id of the session the procedure was registered in, 0 for a
+    /// registration constructed from a bare id.
+    uint64_t session_id() const;
+
 private:
     uint64_t m_id;
+    uint64_t m_session_id;
 };
 
 } // namespace autobahn
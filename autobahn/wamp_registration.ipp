@@ -32,11 +32,19 @@ namespace autobahn {
 
 inline wamp_registration::wamp_registration()
     : m_id(0)
+    , m_session_id(0)
 {
 }
 
 inline wamp_registration::wamp_registration(uint64_t id)
     : m_id(id)
+    , m_session_id(0)
+{
+}
+
+inline wamp_registration::wamp_registration(uint64_t id, uint64_t session_id)
+    : m_id(id)
+    , m_session_id(session_id)
 {
 }
 
@@ -45,4 +53,9 @@ inline uint64_t wamp_registration::id() const
     return m_id;
 }
 
+inline uint64_t wamp_registration::session_id() const
+{
+    return m_session_id;
+}
+
 } // namespace autobahn
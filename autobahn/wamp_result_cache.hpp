@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_RESULT_CACHE_HPP
+#define AUTOBAHN_WAMP_RESULT_CACHE_HPP
+
+#include "wamp_call_result.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace autobahn {
+
+/*!
+ * A snapshot of the effectiveness of a result cache.
+ */
+struct wamp_result_cache_metrics
+{
+    wamp_result_cache_metrics()
+        : size(0)
+        , hits(0)
+        , misses(0)
+        , evictions(0)
+    {
+    }
+
+    /*!
+     * The number of cached results.
+     */
+    std::size_t size;
+
+    /*!
+     * The number of calls answered from the cache.
+     */
+    uint64_t hits;
+
+    /*!
+     * The number of calls that had to go to the router, including those
+     * that found an expired result.
+     */
+    uint64_t misses;
+
+    /*!
+     * The number of results dropped to make room for newer ones.
+     */
+    uint64_t evictions;
+};
+
+/*!
+ * The results of one procedure, by the packed arguments they were called
+ * with, for answering repeated calls without a round-trip. Only suitable
+ * for idempotent procedures.
+ *
+ * Results expire a fixed time after they arrived. Once the cache is full,
+ * the least recently used result is evicted. The cache keeps its own copy
+ * of every result and hands out copies, so results stay valid for as long
+ * as their callers hold them.
+ *
+ * All methods are thread-safe.
+ */
+class wamp_result_cache
+{
+public:
+    /*!
+     * Creates an empty cache.
+     *
+     * @param capacity The maximum number of results, at least one.
+     * @param ttl How long a result is valid, zero for no limit.
+     */
+    wamp_result_cache(std::size_t capacity, std::chrono::milliseconds ttl);
+
+    /*!
+     * Looks up the result for a call and counts the hit or miss.
+     *
+     * @param key The packed arguments of the call.
+     * @param result Receives a copy of the result on a hit.
+     *
+     * @return Whether or not an unexpired result was found.
+     */
+    bool find(const std::string& key, wamp_call_result& result);
+
+    /*!
+     * The generation of the cache, which clear() advances. Calls remember
+     * it when they miss so that results requested before a clear() are not
+     * inserted after it.
+     */
+    uint64_t generation() const;
+
+    /*!
+     * Caches a copy of a result, evicting the least recently used result
+     * if the cache is full.
+     *
+     * @param key The packed arguments of the call.
+     * @param result The result of the call.
+     * @param generation The generation the call missed in.
+     */
+    void insert(const std::string& key, const wamp_call_result& result, uint64_t generation);
+
+    /*!
+     * Drops all results, e.g. when the data behind the procedure changed.
+     */
+    void clear();
+
+    std::size_t capacity() const;
+
+    const std::chrono::milliseconds& ttl() const;
+
+    wamp_result_cache_metrics metrics() const;
+
+private:
+    wamp_result_cache(const wamp_result_cache&) = delete;
+    wamp_result_cache& operator=(const wamp_result_cache&) = delete;
+
+    struct entry
+    {
+        std::string key;
+        wamp_call_result result;
+        std::chrono::steady_clock::time_point expires;
+    };
+
+    using entry_list = std::list<entry>;
+
+    void erase(entry_list::iterator position);
+
+private:
+    const std::size_t m_capacity;
+    const std::chrono::milliseconds m_ttl;
+
+    mutable std::mutex m_mutex;
+
+    // Most recently used first.
+    entry_list m_entries;
+    std::unordered_map<std::string, entry_list::iterator> m_index;
+
+    uint64_t m_generation;
+    uint64_t m_hits;
+    uint64_t m_misses;
+    uint64_t m_evictions;
+};
+
+} // namespace autobahn
+
+#include "wamp_result_cache.ipp"
+
+#endif // AUTOBAHN_WAMP_RESULT_CACHE_HPP
@@ -0,0 +1,146 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iterator>
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_result_cache::wamp_result_cache(std::size_t capacity, std::chrono::milliseconds ttl)
+    : m_capacity(capacity)
+    , m_ttl(ttl)
+    , m_mutex()
+    , m_entries()
+    , m_index()
+    , m_generation(0)
+    , m_hits(0)
+    , m_misses(0)
+    , m_evictions(0)
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("result cache capacity must be at least one");
+    }
+}
+
+inline bool wamp_result_cache::find(const std::string& key, wamp_call_result& result)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto found = m_index.find(key);
+    if (found == m_index.end()) {
+        ++m_misses;
+        return false;
+    }
+
+    entry_list::iterator position = found->second;
+    if (m_ttl.count() > 0 && position->expires <= std::chrono::steady_clock::now()) {
+        erase(position);
+        ++m_misses;
+        return false;
+    }
+
+    m_entries.splice(m_entries.begin(), m_entries, position);
+    result = position->result.clone();
+    ++m_hits;
+
+    return true;
+}
+
+inline uint64_t wamp_result_cache::generation() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_generation;
+}
+
+inline void wamp_result_cache::insert(
+        const std::string& key, const wamp_call_result& result, uint64_t generation)
+{
+    // Copy outside of the lock, results may be large.
+    wamp_call_result copy = result.clone();
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (generation != m_generation) {
+        return;
+    }
+
+    auto found = m_index.find(key);
+    if (found != m_index.end()) {
+        erase(found->second);
+    } else if (m_entries.size() >= m_capacity) {
+        erase(std::prev(m_entries.end()));
+        ++m_evictions;
+    }
+
+    entry cached;
+    cached.key = key;
+    cached.result = std::move(copy);
+    cached.expires = std::chrono::steady_clock::now() + m_ttl;
+    m_entries.push_front(std::move(cached));
+    m_index.emplace(key, m_entries.begin());
+}
+
+inline void wamp_result_cache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_entries.clear();
+    m_index.clear();
+    ++m_generation;
+}
+
+inline std::size_t wamp_result_cache::capacity() const
+{
+    return m_capacity;
+}
+
+inline const std::chrono::milliseconds& wamp_result_cache::ttl() const
+{
+    return m_ttl;
+}
+
+inline wamp_result_cache_metrics wamp_result_cache::metrics() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    wamp_result_cache_metrics metrics;
+    metrics.size = m_entries.size();
+    metrics.hits = m_hits;
+    metrics.misses = m_misses;
+    metrics.evictions = m_evictions;
+    return metrics;
+}
+
+inline void wamp_result_cache::erase(entry_list::iterator position)
+{
+    m_index.erase(position->key);
+    m_entries.erase(position);
+}
+
+} // namespace autobahn
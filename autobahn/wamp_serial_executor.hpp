@@ -0,0 +1,65 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_SERIAL_EXECUTOR_HPP
+#define AUTOBAHN_WAMP_SERIAL_EXECUTOR_HPP
+
+#include "wamp_limited_executor.hpp"
+
+#include <memory>
+
+namespace autobahn {
+
+/*!
+ * Runs tasks on another executor one at a time, in the order they were
+ * posted. Each task happens-before the next one, so state only touched by
+ * the tasks needs no further synchronization.
+ *
+ * Any number of serial executors can share one thread pool: tasks of the
+ * same serial executor stay ordered while different serial executors run in
+ * parallel.
+ *
+ * Must be owned by a std::shared_ptr, as running tasks keep it alive.
+ */
+class wamp_serial_executor : public wamp_limited_executor
+{
+public:
+    /*!
+     * @param executor The executor to run tasks on.
+     */
+    explicit wamp_serial_executor(const std::shared_ptr<wamp_executor>& executor)
+        : wamp_limited_executor(executor, 1)
+    {
+    }
+};
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_WAMP_SERIAL_EXECUTOR_HPP
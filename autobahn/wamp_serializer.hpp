@@ -0,0 +1,95 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_SERIALIZER_HPP
+#define AUTOBAHN_WAMP_SERIALIZER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <msgpack.hpp>
+#include <string>
+
+namespace autobahn {
+
+class wamp_message;
+
+/*!
+ * Provides an abstraction for the format used to encode wamp messages on the
+ * wire. Transports use a serializer to turn a wamp message into octets and back,
+ * so that the serialization format can be chosen per connection.
+ *
+ * Messages are always represented as msgpack objects in memory, regardless of
+ * the format being used on the wire.
+ */
+class wamp_serializer
+{
+public:
+    /*!
+     * Default virtual destructor.
+     */
+    virtual ~wamp_serializer() = default;
+
+    /*!
+     * The serializer identifier announced in the rawsocket handshake.
+     *
+     * @return The 4 bit rawsocket serializer identifier.
+     */
+    virtual uint8_t rawsocket_serializer_id() const = 0;
+
+    /*!
+     * The websocket subprotocol announced when opening a websocket connection.
+     *
+     * @return The subprotocol name, e.g. "wamp.2.msgpack".
+     */
+    virtual std::string websocket_subprotocol() const = 0;
+
+    /*!
+     * Serializes a message and appends the resulting octets to the given buffer.
+     *
+     * @param message The message to serialize.
+     * @param buffer The buffer to append the serialized message to.
+     */
+    virtual void serialize(const wamp_message& message, msgpack::sbuffer& buffer) const = 0;
+
+    /*!
+     * Deserializes a single, complete message. Throws a protocol_error if the
+     * octets do not represent a valid message.
+     *
+     * @param data The serialized message.
+     * @param length The length of the serialized message in octets.
+     *
+     * @return The deserialized message.
+     */
+    virtual wamp_message deserialize(const char* data, std::size_t length) const = 0;
+};
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_WAMP_SERIALIZER_HPP
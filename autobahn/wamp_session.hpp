@@ -31,26 +31,53 @@
 #ifndef AUTOBAHN_SESSION_HPP
 #define AUTOBAHN_SESSION_HPP
 
+#include "wamp_call.hpp"
+#include "wamp_call_handle.hpp"
 #include "wamp_call_options.hpp"
 #include "wamp_call_result.hpp"
+#include "wamp_completion.hpp"
 #include "wamp_event_handler.hpp"
+#include "wamp_execution_policy.hpp"
+#include "wamp_id_map.hpp"
+#include "wamp_logger.hpp"
 #include "wamp_message.hpp"
+#include "wamp_mpsc_queue.hpp"
 #include "wamp_procedure.hpp"
+#include "wamp_publication.hpp"
+#include "wamp_publish_options.hpp"
+#include "wamp_publish_request.hpp"
+#include "wamp_register_options.hpp"
+#include "wamp_register_request.hpp"
+#include "wamp_result_cache.hpp"
+#include "wamp_serial_executor.hpp"
+#include "wamp_serializer.hpp"
 #include "wamp_subscribe_options.hpp"
+#include "wamp_subscribe_request.hpp"
+#include "wamp_timer_wheel.hpp"
 #include "wamp_transport_handler.hpp"
+#include "wamp_unregister_request.hpp"
+#include "wamp_unsubscribe_request.hpp"
+#include "wamp_uri_trie.hpp"
 #include "boost_config.hpp"
 
 #include <boost/asio.hpp>
+#include <boost/container/small_vector.hpp>
 #include <boost/thread/future.hpp>
+#include <boost/version.hpp>
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <istream>
 #include <ostream>
 #include <map>
 #include <memory>
 #include <msgpack.hpp>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -78,7 +105,41 @@ class wamp_unsubscribe_request;
 class wamp_authenticate;
 class wamp_challenge;
 
-/// Representation of a WAMP session.
+/*!
+ * Whether calls to procedures that the calling session registered itself
+ * are dispatched locally, see wamp_session::set_local_calls().
+ */
+enum class wamp_local_calls
+{
+    /// Every call goes through the router. The default.
+    disabled,
+    /// Calls are dispatched locally once the router has allowed one call to
+    /// the procedure from this session, so the router's authorization of
+    /// the caller still applies.
+    authorized,
+    /// Calls are dispatched locally right away, bypassing the router's
+    /// authorization.
+    trusted
+};
+
+/*!
+ * Representation of a WAMP session.
+ *
+ * Thread safety: the session is driven by its io service. The methods that
+ * issue requests (publish, subscribe, unsubscribe, call, provide, unprovide)
+ * as well as start, stop, join, leave and is_connected may be called from any
+ * thread, concurrently. They encode the request on the calling thread and hand
+ * it to the io service through a lock-free queue, which the io service drains
+ * in batches. With set_caller_encoding() the request is also serialized into
+ * its wire frame on the calling thread. Requests submitted by one thread are
+ * sent in the order they were submitted; there is no ordering between
+ * threads. Request ids are unique within the session but, with several
+ * submitting threads, are not sent in increasing order.
+ *
+ * Event handlers, procedures and on_challenge run on a thread running the io
+ * service. Continuations chained on the futures returned by the session run
+ * on the continuation executor if one is set, see set_continuation_executor().
+ */
 class wamp_session :
         public wamp_transport_handler,
         public std::enable_shared_from_this<wamp_session>
@@ -89,18 +150,98 @@ public:
      * Create a new WAMP session.
      *
      * \param io_service The io service to drive event dispatching.
-     * \param debug_enabled Whether or not to run in debug mode.
+     * \param debug_enabled Whether or not to log at trace level. Warnings are
+     *        always logged to the default sink.
      */
     wamp_session(
             boost::asio::io_service& io_service,
             bool debug_enabled = false);
 
+    /*!
+     * Destroys the session. Requests that were submitted but not yet sent
+     * are dropped and their futures fail with a broken promise.
+     *
+     * Not thread-safe: no other thread may use the session concurrently.
+     */
     ~wamp_session();
 
+    /*!
+     * The logger used by the session. Its level and sink may be changed
+     * before the session is started.
+     *
+     * Not thread-safe: configure the logger before starting the session.
+     */
+    wamp_logger& logger();
+
+    /*!
+     * The io service the session runs on.
+     */
+    boost::asio::io_service& io_service();
+
+    /*!
+     * Whether or not requests are serialized into wire frames on the calling
+     * thread, so that only the encoded bytes are handed to the io service.
+     * This spreads encoding over the application threads rather than doing
+     * all of it on the io service. Disabled by default.
+     *
+     * Only takes effect while the session is running on a transport that
+     * supports pre-encoded frames, see wamp_transport::serializer().
+     *
+     * \param enabled Whether or not to encode on the calling thread.
+     *
+     * Thread-safe. Applies to requests submitted after the change has been
+     * processed by the io service.
+     */
+    void set_caller_encoding(bool enabled);
+
+    /*!
+     * Whether calls to procedures this session has registered run the
+     * procedure directly, with the caller's argument objects, instead of
+     * taking the round-trip through the router. Disabled by default.
+     *
+     * Only exact registrations are dispatched locally, and only calls
+     * that are not progressive. Call timeouts and cancel() apply, both
+     * interrupt the local invocation like the router would. Calls are
+     * encoded on the io service while local calls are enabled, overriding
+     * set_caller_encoding().
+     *
+     * \param mode Whether, and after which authorization, calls are
+     *        dispatched locally.
+     * \param shared Whether procedures registered with an invocation policy
+     *        other than wamp_invoke::single are dispatched locally too. The
+     *        router would spread their calls over all callees, in the order
+     *        given by the policy, whereas local calls always run here.
+     *
+     * Thread-safe. Applies to calls submitted after the change has been
+     * processed by the io service.
+     */
+    void set_local_calls(wamp_local_calls mode, bool shared = false);
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    /*!
+     * Sets the executor that continuations chained with then() on the
+     * futures returned by the session are run on, e.g. a
+     * wamp_future_executor for the io service or a thread pool. Running a
+     * continuation then costs a post rather than a new thread. Continuations
+     * chained on those continuations inherit the executor.
+     *
+     * Only available with AUTOBAHN_FUTURE_EXECUTORS defined, see
+     * boost_config.hpp.
+     *
+     * \param executor The executor, which has to outlive the futures, or
+     *        nullptr for the default boost launch policy.
+     *
+     * Not thread-safe: set the executor before using the session.
+     */
+    void set_continuation_executor(const boost::executor_ptr_type& executor);
+#endif
+
     /*!
      * Establishes a session with the router.
      *
      * \return A future that indicates if the session was successfully started.
+     *
+     * Thread-safe.
      */
     boost::future<void> start();
 
@@ -108,6 +249,8 @@ public:
      * Stops the session with the router.
      *
      * \return A future that indicates if the session was successfully stopped.
+     *
+     * Thread-safe.
      */
     boost::future<void> stop();
 
@@ -118,6 +261,8 @@ public:
      * \param authmethods The authentication methods this instance support e.g. "wampcra","ticket"
      * \param authid The username or maybe an other identifier for the user to join.
      * \return A future that resolves with the session ID when the realm was joined.
+     *
+     * Thread-safe.
      */
     boost::future<uint64_t> join(
             const std::string& realm,
@@ -129,6 +274,8 @@ public:
      *
      * \param reason An optional WAMP URI providing a reason for leaving.
      * \return A future that resolves with the reason sent by the peer.
+     *
+     * Thread-safe.
      */
     boost::future<std::string> leave(
             const std::string& reason = std::string("wamp.error.close_realm"));
@@ -136,6 +283,8 @@ public:
 	/*!
 	 * \brief is_connected
 	 * \return true if there is a valid session
+	 *
+	 * Thread-safe, the result is a snapshot.
 	 */
 	bool is_connected()
 	{
@@ -147,6 +296,8 @@ public:
      *
      * \param topic The URI of the topic to publish to.
      * \return A future that resolves once the the topic has been published to.
+     *
+     * Thread-safe.
      */
     boost::future<void> publish(const std::string& topic);
 
@@ -156,6 +307,8 @@ public:
      * \param topic The URI of the topic to publish to.
      * \param arguments The positional payload for the event.
      * \return A future that resolves once the the topic has been published to.
+     *
+     * Thread-safe.
      */
     template <typename List>
     boost::future<void> publish(const std::string& topic, const List& arguments);
@@ -167,6 +320,8 @@ public:
      * \param arguments The positional payload for the event.
      * \param kw_arguments The keyword payload for the event.
      * \return A future that resolves once the the topic has been published to.
+     *
+     * Thread-safe.
      */
     template <typename List, typename Map>
     boost::future<void> publish(
@@ -174,33 +329,170 @@ public:
             const List& arguments,
             const Map& kw_arguments);
 
+    /*!
+     * Publish an event with positional payload and options to a topic.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param arguments The positional payload for the event.
+     * \param options The options for the publish.
+     * \return A future that resolves to the publication. With acknowledge
+     *         set it resolves once the router accepted the event, or fails
+     *         with the router's error. Otherwise it resolves once the event
+     *         has been sent.
+     *
+     * Thread-safe. With local delivery the session's own handlers for the
+     * topic receive the event on the io service before it is sent, see
+     * wamp_publish_options::set_local_delivery().
+     */
+    template <typename List>
+    boost::future<wamp_publication> publish(
+            const std::string& topic,
+            const List& arguments,
+            const wamp_publish_options& options);
+
+    /*!
+     * Publish an event with both positional and keyword payload and options
+     * to a topic.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param arguments The positional payload for the event.
+     * \param kw_arguments The keyword payload for the event.
+     * \param options The options for the publish.
+     * \return A future that resolves to the publication.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename Map>
+    boost::future<wamp_publication> publish(
+            const std::string& topic,
+            const List& arguments,
+            const Map& kw_arguments,
+            const wamp_publish_options& options);
+
+    /*!
+     * Limits the number of acknowledged publishes awaiting the router's
+     * acknowledgement. Further acknowledged publishes wait, in order, until
+     * an acknowledgement makes room. This lets a publisher pipeline many
+     * publishes without flooding the router. Unacknowledged publishes are
+     * not held back and may overtake waiting ones.
+     *
+     * \param window The maximum number of acknowledged publishes in flight,
+     *        or 0 for no limit, which is the default.
+     *
+     * Thread-safe. Applies once the change has been processed by the io
+     * service.
+     */
+    void set_publish_window(std::size_t window);
+
+    /*!
+     * The number of acknowledged publishes that have not completed yet,
+     * both in flight and waiting for the publish window. Publishers may hold
+     * back while it is high.
+     *
+     * Thread-safe, the result is a snapshot.
+     */
+    std::size_t pending_publications() const;
+
     /*!
      * Subscribe a handler to a topic to receive events.
      *
+     * Handlers subscribing to the same topic with the same match policy
+     * share a single subscription at the router. Only the first of them
+     * sends a SUBSCRIBE, later ones join the existing subscription without
+     * a round-trip. All subscriptions end when the transport disconnects,
+     * the handlers are not invoked again. Subscribe again after joining
+     * the next session.
+     *
      * \param topic The URI of the topic to subscribe to.
      * \param handler The handler that will receive events under the subscription.
      * \param options The options to pass in the subscribe request to the router.
      * \return A future that resolves to the autobahn::subscription.
+     *
+     * Thread-safe. The handler is invoked on the io service.
+     */
+    boost::future<wamp_subscription> subscribe(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            const wamp_subscribe_options& options = wamp_subscribe_options());
+
+    /*!
+     * Subscribe a handler to a topic to receive events on an executor.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive events under the subscription.
+     * \param executor The executor to run the handler on, e.g. a thread pool.
+     * \param options The options to pass in the subscribe request to the router.
+     * \return A future that resolves to the autobahn::subscription.
+     *
+     * Thread-safe. The handler is invoked on the executor, one event at a
+     * time and in the order the events were received, while handlers of other
+     * subscriptions may run in parallel on the same executor.
      */
     boost::future<wamp_subscription> subscribe(
             const std::string& topic,
             const wamp_event_handler& handler,
+            const std::shared_ptr<wamp_executor>& executor,
             const wamp_subscribe_options& options = wamp_subscribe_options());
 
     /*!
      * Unubscribe a handler to previosuly subscribed topic.
      *
+     * Detaches the handler the subscription was returned for. The router
+     * subscription is only released, with an UNSUBSCRIBE, once its last
+     * handler has been detached, until then the future is ready right away.
+     * A subscription constructed from a bare id detaches all handlers.
+     * Unsubscribing a handler that is no longer attached, e.g. because its
+     * subscription ended with an earlier session, fails with a wamp_error
+     * of wamp.error.no_such_subscription without contacting the router.
+     *
      * \param subscription The subscription to unsubscribe from.
      * \return A future that resolves to the unsubscribed response.
+     *
+     * Thread-safe.
      */
     boost::future<void> unsubscribe(const wamp_subscription& subscription);
 
+    /*!
+     * Routes the events of pattern-based subscriptions to local handlers by
+     * their topic. This lets a single router subscription, e.g. a prefix
+     * subscription to "com.example", feed any number of narrow consumers.
+     * An event is passed to the handlers of every route matching its topic
+     * in place of the subscription's own handlers, which only receive the
+     * events no route matches. A publication received through several
+     * overlapping subscriptions is routed once. The lookup takes time linear
+     * in the length of the topic.
+     *
+     * \param topic The topic or topic pattern to route.
+     * \param handler The handler to pass the events to.
+     * \param match How the topic of an event is matched against the route.
+     *
+     * Thread-safe. Applies to events received after the change has been
+     * processed by the io service. Routed handlers are invoked on the io
+     * service.
+     */
+    void add_event_route(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            wamp_match match = wamp_match::exact);
+
+    /*!
+     * Removes all handlers routed under a topic with add_event_route().
+     *
+     * Thread-safe.
+     */
+    void remove_event_route(const std::string& topic, wamp_match match = wamp_match::exact);
+
     /*!
      * Calls a remote procedure with no arguments.
      *
      * \param procedure The URI of the remote procedure to call.
-     * \param options The options to pass in the call to the router.
+     * \param options The options to pass in the call to the router. A timeout
+     *        is also enforced by the session, which then fails the call with
+     *        a timeout_error. Progressive results are passed to the progress
+     *        handler of the options.
      * \return A future that resolves to the result of the remote procedure call.
+     *
+     * Thread-safe.
      */
     boost::future<wamp_call_result> call(
             const std::string& procedure,
@@ -211,8 +503,13 @@ public:
      *
      * \param procedure The URI of the remote procedure to call.
      * \param arguments The positional arguments for the call.
-     * \param options The options to pass in the call to the router.
+     * \param options The options to pass in the call to the router. A timeout
+     *        is also enforced by the session, which then fails the call with
+     *        a timeout_error. Progressive results are passed to the progress
+     *        handler of the options.
      * \return A future that resolves to the result of the remote procedure call.
+     *
+     * Thread-safe.
      */
     template <typename List>
     boost::future<wamp_call_result> call(
@@ -226,8 +523,13 @@ public:
      * \param procedure The URI of the remote procedure to call.
      * \param arguments The positional arguments for the call.
      * \param kw_arguments The keyword arguments for the call.
-     * \param options The options to pass in the call to the router.
+     * \param options The options to pass in the call to the router. A timeout
+     *        is also enforced by the session, which then fails the call with
+     *        a timeout_error. Progressive results are passed to the progress
+     *        handler of the options.
      * \return A future that resolves to the result of the remote procedure call.
+     *
+     * Thread-safe.
      */
     template<typename List, typename Map>
     boost::future<wamp_call_result> call(
@@ -235,23 +537,363 @@ public:
             const List& arguments, const Map& kw_arguments,
             const wamp_call_options& options = wamp_call_options());
 
+    /*!
+     * Caches the results of an idempotent procedure, so that calls repeating
+     * the arguments of an earlier call are answered without a round-trip.
+     * Results are looked up by the packed arguments of the call, see
+     * wamp_result_cache. Calls with progressive results or chunked
+     * arguments always go to the router.
+     *
+     * Replaces any cache the procedure already had.
+     *
+     * \param procedure The URI of the procedure, as passed to call().
+     * \param capacity The maximum number of results, at least one.
+     * \param ttl How long a result is valid, zero for no limit.
+     * \return The cache, e.g. for its metrics.
+     *
+     * Thread-safe. Applies to call(), call_many() and async_call() made
+     * after it returns. A cache hit completes the future on the calling
+     * thread, a completion handler on the io service.
+     */
+    std::shared_ptr<wamp_result_cache> cache_results(
+            const std::string& procedure,
+            std::size_t capacity,
+            std::chrono::milliseconds ttl = std::chrono::milliseconds(0));
+
+    /*!
+     * Stops caching the results of a procedure.
+     *
+     * Thread-safe.
+     */
+    void remove_result_cache(const std::string& procedure);
+
+    /*!
+     * The cache of a procedure, or nullptr if its results are not cached.
+     *
+     * Thread-safe.
+     */
+    std::shared_ptr<wamp_result_cache> result_cache(const std::string& procedure) const;
+
+    /*!
+     * Drops the cached results of a procedure whenever an event is published
+     * to a topic, e.g. one announcing changes to the data behind it.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param procedure The procedure whose cache to clear. The cache is looked
+     *        up by each event, so it may be added or replaced later.
+     * \param options The options to pass in the subscribe request to the router.
+     * \return A future that resolves to the subscription, which can be
+     *         unsubscribed to stop invalidating.
+     *
+     * Thread-safe.
+     */
+    boost::future<wamp_subscription> invalidate_results_on(
+            const std::string& topic,
+            const std::string& procedure,
+            const wamp_subscribe_options& options = wamp_subscribe_options());
+
+    /*!
+     * Calls several remote procedures at once.
+     *
+     * The calls are submitted to the io service together and their messages
+     * are written to the transport in one go, which saves the per call
+     * dispatch and write when issuing many calls.
+     *
+     * \param calls A range of (procedure, arguments) pairs, e.g. a vector of
+     *        std::pair<std::string, std::tuple<...>>.
+     * \param options The options for every call. A handle in the options
+     *        is ignored as it can only refer to a single call.
+     * \return The futures of the calls, in order. Use boost::when_all to
+     *         wait for all of them.
+     *
+     * Thread-safe.
+     */
+    template <typename Range>
+    std::vector<boost::future<wamp_call_result>> call_many(
+            const Range& calls,
+            const wamp_call_options& options = wamp_call_options());
+
+    /*!
+     * Publishes to several topics at once, written to the transport in one
+     * go, see call_many().
+     *
+     * \param events A range of (topic, arguments) pairs.
+     * \return The futures of the publications, in order.
+     *
+     * Thread-safe.
+     */
+    template <typename Range>
+    std::vector<boost::future<void>> publish_many(const Range& events);
+
+    /*!
+     * Sends a further chunk of the arguments of a progressive call.
+     *
+     * A progressive call is made with a handle and progress set in its
+     * options, and continued with chunks until one without progress set in
+     * its options. The callee receives the chunks through its invocation's
+     * chunk handler as they arrive, so the arguments never have to be held
+     * in a single message.
+     *
+     * \param handle The handle passed in the options of the call.
+     * \param arguments The positional arguments of the chunk.
+     * \param options Whether or not more chunks follow.
+     *
+     * Thread-safe. Chunks are sent in the order they are submitted from a
+     * thread and are dropped once the call is no longer pending.
+     */
+    template <typename List>
+    void call_chunk(
+            const wamp_call_handle& handle,
+            const List& arguments,
+            const wamp_call_options& options = wamp_call_options());
+
+    /*!
+     * Sends a further chunk of the arguments of a progressive call, with
+     * positional and keyword arguments.
+     *
+     * \param handle The handle passed in the options of the call.
+     * \param arguments The positional arguments of the chunk.
+     * \param kw_arguments The keyword arguments of the chunk.
+     * \param options Whether or not more chunks follow.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename Map>
+    void call_chunk(
+            const wamp_call_handle& handle,
+            const List& arguments, const Map& kw_arguments,
+            const wamp_call_options& options = wamp_call_options());
+
+    /*!
+     * Cancels a call made with the given handle in its options.
+     *
+     * If the router supports call canceling, it is asked to cancel the call
+     * and the call fails with the wamp.error.canceled error the router
+     * responds with. Otherwise the call fails locally right away and a late
+     * result is ignored. Nothing happens if the call is no longer pending.
+     *
+     * A call answered by a procedure of this session is canceled by the
+     * session itself, which interrupts the invocation the way the router
+     * would. With kill, the call then completes with the procedure's answer.
+     *
+     * \param handle The handle passed in the options of the call.
+     * \param mode Whether and how the callee is interrupted.
+     *
+     * Thread-safe.
+     */
+    void cancel(const wamp_call_handle& handle, wamp_cancel_mode mode = wamp_cancel_mode::kill);
+
+#if BOOST_VERSION >= 107000
+    //
+    // Completion token overloads. Instead of a boost::future these complete
+    // with an asio completion token: a callback, boost::asio::use_future or,
+    // with Boost 1.80 or later, a boost::asio::yield_context. The handler
+    // signature is void(std::exception_ptr, T) where T is the result and is
+    // default constructed on failure. Handlers are invoked directly on the
+    // io service, without the allocation and locking of a boost::promise.
+
+    /*!
+     * Calls a remote procedure with positional arguments.
+     *
+     * \param procedure The URI of the remote procedure to call.
+     * \param arguments The positional arguments for the call.
+     * \param token The completion token, receiving a wamp_call_result.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const List& arguments,
+            CompletionToken&& token);
+
+    /*!
+     * Calls a remote procedure with positional arguments and options.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const List& arguments,
+            const wamp_call_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Calls a remote procedure with positional and keyword arguments.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename Map, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+    async_call(
+            const std::string& procedure,
+            const List& arguments, const Map& kw_arguments,
+            const wamp_call_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Subscribes a handler to a topic.
+     *
+     * \param topic The URI of the topic to subscribe to.
+     * \param handler The handler that will receive events under the subscription.
+     * \param options The options to pass in the subscribe request to the router.
+     * \param token The completion token, receiving a wamp_subscription.
+     *
+     * Thread-safe.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_subscription))
+    async_subscribe(
+            const std::string& topic,
+            const wamp_event_handler& handler,
+            const wamp_subscribe_options& options,
+            CompletionToken&& token);
+
+    /*!
+     * Publishes an event with positional arguments. Completes once the
+     * event has been sent.
+     *
+     * \param topic The URI of the topic to publish to.
+     * \param arguments The positional arguments for the event.
+     * \param token The completion token, with the signature
+     *        void(std::exception_ptr).
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish(
+            const std::string& topic,
+            const List& arguments,
+            CompletionToken&& token);
+
+    /*!
+     * Publishes an event with positional and keyword arguments.
+     *
+     * Thread-safe.
+     */
+    template <typename List, typename Map, typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+    async_publish(
+            const std::string& topic,
+            const List& arguments, const Map& kw_arguments,
+            CompletionToken&& token);
+
+    /*!
+     * Registers a procedure that can be called remotely.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param options Options for registering the procedure.
+     * \param token The completion token, receiving a wamp_registration.
+     *
+     * Thread-safe. The procedure is invoked on the io service.
+     */
+    template <typename CompletionToken>
+    BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+    async_provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const provide_options& options,
+            CompletionToken&& token);
+#endif
+
     /*!
      * Register a procedure that can be called remotely.
      *
+     * All registrations end when the transport disconnects, the procedure
+     * is not invoked again. Provide it again after joining the next
+     * session.
+     *
+     * \param uri The URI associated with the procedure.
+     * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     *
+     * Thread-safe. The procedure is invoked on the io service.
+     */
+    boost::future<wamp_registration> provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const provide_options& options = provide_options());
+
+    /*!
+     * Register a procedure that can be called remotely, choosing where its
+     * invocations are executed.
+     *
      * \param uri The URI associated with the procedure.
      * \param procedure The procedure to be exposed as a remotely callable procedure.
+     * \param policy Where to execute invocations of the procedure.
      * \param options Options for registering the procedure.
      * \return A future that resolves to a autobahn::registration
+     *
+     * Thread-safe. The procedure is invoked as given by the policy.
      */
     boost::future<wamp_registration> provide(
             const std::string& uri,
             const wamp_procedure& procedure,
+            const wamp_execution_policy& policy,
             const provide_options& options = provide_options());
+
+    /*!
+     * Register a procedure, or with a match policy a pattern of procedures,
+     * that can be called remotely.
+     *
+     * \param uri The URI or URI pattern to register.
+     * \param procedure The procedure invoked for calls that no procedure
+     *        route matches, see add_procedure_route().
+     * \param options Options for registering the procedure.
+     * \return A future that resolves to a autobahn::registration
+     *
+     * Thread-safe. The procedure is invoked on the io service.
+     */
+    boost::future<wamp_registration> provide(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            const wamp_register_options& options);
+
+    /*!
+     * Routes the invocations of pattern-based registrations to a local
+     * procedure by the URI that was called. This lets a single router
+     * registration, e.g. a prefix registration of "com.example", serve any
+     * number of procedures. The procedure matching the called URI best is
+     * invoked in place of the registration's own procedure. Precedence is
+     * exact, then longest prefix, then wildcard. The lookup takes time
+     * linear in the length of the URI.
+     *
+     * \param uri The URI or URI pattern to route.
+     * \param procedure The procedure to invoke.
+     * \param match How the called URI is matched against the route.
+     *
+     * Thread-safe. Applies to invocations received after the change has
+     * been processed by the io service. Routed procedures are invoked on
+     * the io service.
+     */
+    void add_procedure_route(
+            const std::string& uri,
+            const wamp_procedure& procedure,
+            wamp_match match = wamp_match::exact);
+
+    /*!
+     * Removes a route added with add_procedure_route().
+     *
+     * Thread-safe.
+     */
+    void remove_procedure_route(const std::string& uri, wamp_match match = wamp_match::exact);
     /*!
     * Unregister a provider handler to previosuly provided registration.
     *
+    * Unregistering a registration of an earlier session fails with a
+    * wamp_error of wamp.error.no_such_registration without contacting the
+    * router.
+    *
     * \param registration The registration to stop providing.
     * \return A future that synchronizes to the unregister response.
+    *
+    * Thread-safe.
     */
     boost::future<void> unprovide(const wamp_registration& registration);
     /*!
@@ -261,6 +903,8 @@ public:
      * \param challenge The challenge from the router containing enough information
      *        for the system to prove membership.
      * \return A future that resolves to an authentication response.
+     *
+     * Called on the io service.
      */
     virtual boost::future<wamp_authenticate> on_challenge(const wamp_challenge& challenge);
 
@@ -277,16 +921,208 @@ private:
     void process_abort(wamp_message&& message);
     void process_challenge(wamp_message&& message);
     void process_call_result(wamp_message&& message);
+    void process_published(wamp_message&& message);
     void process_subscribed(wamp_message&& message);
     void process_unsubscribed(wamp_message&& message);
     void process_event(wamp_message&& message);
+
+    // The handlers of a subscription, see m_subscription_handlers.
+    struct subscribed_handler;
+    using subscribed_handlers = boost::container::small_vector<subscribed_handler, 1>;
+
+    // Passes an event to the routes matching its topic, returns whether
+    // any did.
+    bool route_event(const wamp_event& event, uint64_t subscription_id);
+
+    // Passes an event to the handlers of a subscription. The event is moved
+    // to shared_event for the first handler running on an executor.
+    void dispatch_event(
+            uint64_t subscription_id,
+            const subscribed_handlers& handlers,
+            wamp_event& event,
+            std::shared_ptr<const wamp_event>& shared_event);
+
+    // Delivers a published event to the session's own subscriptions. The
+    // event takes over the message's zone if the message is not sent.
+    void deliver_local_event(wamp_message& message, bool take_zone);
+    void deliver_local_event(msgpack::sbuffer& frame, bool take_zone);
     void process_registered(wamp_message&& message);
     void process_unregistered(wamp_message&& message);
     void process_invocation(wamp_message&& message);
+    void process_interrupt(wamp_message&& message);
+    void process_invocation_chunk(
+            const std::shared_ptr<wamp_invocation_impl>& invocation, wamp_message&& message);
+
+    // Sends a chunk of a progressive call if the call is still pending.
+    void submit_call_chunk(const wamp_call_handle& handle, const std::shared_ptr<wamp_message>& message);
+
+    // Whether or not a YIELD or ERROR completes its invocation.
+    static bool is_final_answer(const wamp_message& message);
+
+    // Takes a pending call out of the table and stops its timeout.
+    wamp_call take_call(uint64_t request_id);
+
+    // Asks the router to cancel a pending call.
+    void send_cancel(uint64_t request_id, wamp_cancel_mode mode);
+
+    // Interrupts the invocation answering a local call, in place of the
+    // INTERRUPT the router would send.
+    void interrupt_local_call(uint64_t request_id,
+            const std::shared_ptr<wamp_invocation_impl>& invocation, wamp_cancel_mode mode);
+
+    // Fails the calls whose timeout has passed.
+    void schedule_call_timeouts();
+    void expire_call_timeouts();
+
+    // Runs a procedure, answering the invocation with an error if it throws.
+    static void invoke_procedure(const wamp_procedure& procedure, const wamp_invocation& invocation);
     void process_goodbye(wamp_message&& message);
 
+    // Commands submitted by application threads and executed on the io
+    // service. Each command owns the encoded message and the pending request
+    // state, so submitting a request is a single allocation.
+    class command : public wamp_mpsc_node
+    {
+    public:
+        virtual ~command() = default;
+        virtual void execute(wamp_session& session) = 0;
+    };
+
+    template <typename Request, typename Payload>
+    class request_command;
+
+    template <typename Function>
+    class function_command;
+    template <typename Request>
+    class batch_command;
+
+#if BOOST_VERSION >= 107000
+    // Initiations of the completion token overloads, which submit the
+    // request with the completion handler in place of a promise.
+    struct initiate_call;
+    struct initiate_cached_call;
+    struct initiate_subscribe;
+    struct initiate_provide;
+    struct initiate_publish;
+
+    template <typename Handler>
+    class publish_command;
+#endif
+
+    template <typename Request>
+    void submit_request(uint64_t request_id, wamp_message&& message, Request&& request);
+
+    template <typename Function>
+    void submit_function(Function&& function);
+
+    void submit(std::unique_ptr<command> command);
+    void schedule_commands();
+    void drain_commands();
+
+    // Takes a request id from the calling thread's block of ids.
+    uint64_t next_request_id();
+    static uint64_t next_instance_id();
+
+    // Identifies a router subscription for sharing it between handlers.
+    static std::string subscription_key(
+            const std::string& topic, const wamp_subscribe_options& options);
+
+    // Splits a subscription key into its topic and match policy.
+    static std::string subscription_topic(const std::string& key, wamp_match& match);
+
+    // Runs a call on a procedure registered by this session if local calls
+    // allow it. Frames encoded by the caller are always sent.
+    bool dispatch_local_call(uint64_t request_id, wamp_message& message, wamp_call& call);
+    bool dispatch_local_call(uint64_t request_id, msgpack::sbuffer& frame, wamp_call& call);
+    void send_call_batch(
+            const std::vector<uint64_t>& request_ids,
+            std::vector<wamp_message>&& messages,
+            std::vector<wamp_call>& calls);
+
+    // Records the URI of an exact registration for local calls.
+    static void set_local_uri(wamp_register_request& register_request,
+            const std::string& uri, const provide_options& options);
+    static void set_local_uri(wamp_register_request& register_request,
+            const std::string& uri, const wamp_register_options& options);
+
+    // The result cache for a call, or nullptr if it must go to the router.
+    std::shared_ptr<wamp_result_cache> find_result_cache(
+            const std::string& procedure, const wamp_call_options& options) const;
+
+    // The packed arguments of a call, which key its result in the cache.
+    template <typename List>
+    static std::string pack_arguments(const List& arguments);
+    template <typename List, typename Map>
+    static std::string pack_arguments(const List& arguments, const Map& kw_arguments);
+
+    // Looks up a cached result, along with the generation of the cache to
+    // store the result under on a miss.
+    static bool find_cached_result(const std::shared_ptr<wamp_result_cache>& cache,
+            const std::string& key, uint64_t& generation, wamp_call_result& result);
+
+    // Completes a call from the cache on a hit and otherwise lets the call
+    // store its result.
+    static bool answer_from_cache(
+            const std::shared_ptr<wamp_result_cache>& cache, std::string&& key, wamp_call& call);
+
+    // Passes the answer of a local invocation to its call.
+    void process_local_answer(uint64_t request_id, wamp_message&& message);
+
+    // Adds the handler of a subscribe request to a router subscription.
+    wamp_subscription attach_subscriber(
+            uint64_t subscription_id, const wamp_subscribe_request& subscribe_request);
+
+    // Sends a request, either a message or a frame encoded by the submitting
+    // thread, and tracks it until the response arrives.
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, boost::promise<void>& published);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_publish_request& publish_request);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_subscribe_request& subscribe_request);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_unsubscribe_request& unsubscribe_request);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_call& call);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_register_request& register_request);
+    template <typename Payload>
+    void issue(uint64_t request_id, Payload&& message, wamp_unregister_request& unregister_request);
+
+    // Sends a batch of requests in one write and tracks them.
+    void issue_batch(
+            const std::vector<uint64_t>& request_ids,
+            std::vector<wamp_message>&& messages,
+            std::vector<boost::promise<void>>& published);
+    void issue_batch(
+            const std::vector<uint64_t>& request_ids,
+            std::vector<wamp_message>&& messages,
+            std::vector<wamp_call>& calls);
+
+    // Sends an acknowledged publish and tracks it until PUBLISHED or ERROR.
+    template <typename Payload>
+    void send_publication(uint64_t request_id, Payload&& message, wamp_publish_request& publish_request);
+
+    // Sends the publishes waiting for the publish window while it has room.
+    void release_publications();
+
+    // Adds a sent call to the pending calls, starting its timeout if any.
+    void track_call(uint64_t request_id, wamp_call&& call);
+
+    // Publishes the serializer submitting threads encode with, if any.
+    void update_caller_serializer();
+
+    // The future of a promise, bound to the continuation executor if any.
+    template <typename T>
+    boost::future<T> bind_future(boost::promise<T>& promise);
+    boost::future<void> bind_future(boost::promise<void>& promise);
+    template <typename T>
+    boost::future<T> bind_future(wamp_completion<T>& completion);
+
     // Transmitting/receiving messages
     void send_message(wamp_message&& message, bool session_established = true);
+    void send_message(msgpack::sbuffer&& frame);
+    void send_messages(std::vector<wamp_message>&& messages);
     void receive_message();
 
     void got_handshake_reply(const boost::system::error_code& error);
@@ -294,18 +1130,40 @@ private:
     void got_message_body(const boost::system::error_code& error);
     void got_message(wamp_message&& message);
 
-    bool m_debug_enabled;
+    wamp_logger m_logger;
 
     boost::asio::io_service& m_io_service;
 
     // The transport this session runs on.
     std::shared_ptr<wamp_transport> m_transport;
 
-    // Last request ID of outgoing WAMP requests.
+    // Last request ID handed out to a thread's block of request IDs.
     std::atomic<uint64_t> m_request_id;
 
+    // Identifies this session instance in the per-thread request ID blocks.
+    const uint64_t m_instance_id;
+
+    // Commands waiting to be executed on the io service.
+    wamp_mpsc_queue<command> m_commands;
+
+    // Whether or not a drain of the command queue has been posted.
+    std::atomic<bool> m_commands_scheduled;
+
+    // Whether or not encoding on the calling thread has been requested.
+    bool m_caller_encoding;
+
+    // The serializer submitting threads encode requests with, or nullptr to
+    // leave encoding to the io service. Only accessed through std::atomic_load
+    // and std::atomic_store.
+    std::shared_ptr<wamp_serializer> m_caller_serializer;
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    // Where continuations on the returned futures run, if anywhere special.
+    boost::executor_ptr_type m_continuation_executor;
+#endif
+
     // WAMP session ID (if the session is joined to a realm).
-    uint64_t m_session_id;
+    std::atomic<uint64_t> m_session_id;
 
     // Synchronization for dealing with starting the session.
     boost::promise<void> m_session_start;
@@ -321,38 +1179,152 @@ private:
     // Set to true when the session is stopped.
     bool m_running;
 
+    // Whether or not the router announced the call_canceling feature.
+    bool m_router_call_canceling;
+
     // Synchronization for dealing with stopping the session
     boost::promise<void> m_session_stop;
 
     //////////////////////////////////////////////////////////////////////////////////////
     // Caller
 
-    // Track pending calls by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_call>> m_calls;
+    // Track pending calls by request id. Pending requests are stored inline
+    // in flat tables, see wamp_id_map.
+    wamp_id_map<wamp_call> m_calls;
+
+    // Deadlines of pending calls with a timeout, by request id.
+    wamp_timer_wheel m_call_timeouts;
+
+    // Drives m_call_timeouts while any call has a timeout.
+    boost::asio::steady_timer m_call_timer;
+    bool m_call_timer_scheduled;
+
+    using result_caches = std::unordered_map<std::string, std::shared_ptr<wamp_result_cache>>;
+
+    // Result caches by procedure. Calls read the table without locking,
+    // through std::atomic_load. Changes copy it and std::atomic_store the
+    // copy, serialized by the mutex.
+    std::shared_ptr<const result_caches> m_result_caches;
+    std::mutex m_result_caches_mutex;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Publisher
+
+    // Acknowledged publishes awaiting PUBLISHED or ERROR, by request id.
+    wamp_id_map<wamp_publish_request> m_publications;
+
+    // An acknowledged publish held back by the publish window, either as a
+    // message or, with caller encoding, as a frame. The message is empty
+    // when the frame is used.
+    struct queued_publication
+    {
+        queued_publication(uint64_t request_id, wamp_message&& message, wamp_publish_request&& request);
+        queued_publication(uint64_t request_id, msgpack::sbuffer&& frame, wamp_publish_request&& request);
+
+        uint64_t request_id;
+        wamp_message message;
+        msgpack::sbuffer frame;
+        wamp_publish_request request;
+    };
+
+    // Publishes waiting for the publish window, in submission order.
+    std::deque<queued_publication> m_publication_queue;
+
+    // Maximum number of acknowledged publishes in flight, 0 for no limit.
+    std::size_t m_publish_window;
+
+    // Acknowledged publishes submitted but not completed yet.
+    std::atomic<std::size_t> m_pending_publications;
 
     //////////////////////////////////////////////////////////////////////////////////////
     // Subscriber
 
     // Pending subscribe requests by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_subscribe_request>> m_subscribe_requests;
+    wamp_id_map<wamp_subscribe_request> m_subscribe_requests;
 
     // Pending unsubscribe requests by request id.
-    std::map<uint64_t /*request id*/, std::shared_ptr<wamp_unsubscribe_request>> m_unsubscribe_requests;
+    wamp_id_map<wamp_unsubscribe_request> m_unsubscribe_requests;
+
+    // An event handler and, if it does not run on the io service, the
+    // serial executor that keeps its events in order.
+    struct subscribed_handler
+    {
+        uint64_t id;
+        wamp_event_handler handler;
+        std::shared_ptr<wamp_executor> executor;
+    };
+
+    // Event handlers by subscription id. Most subscriptions have a single
+    // handler which is then stored inline in the table slot. Only accessed
+    // on the io service, handlers running on executors get copies.
+    wamp_id_map<subscribed_handlers> m_subscription_handlers;
+
+    // Router subscriptions by key and keys by subscription id, for sharing
+    // subscriptions between handlers. Only accessed on the io service.
+    std::unordered_map<std::string, uint64_t> m_subscription_ids;
+    wamp_id_map<std::string> m_subscription_keys;
+
+    // Subscription ids by topic pattern, for delivering local events.
+    // Only accessed on the io service.
+    wamp_uri_trie<uint64_t> m_subscription_topics;
+
+    // The id given to the last handler attached to a subscription.
+    uint64_t m_last_handler_id;
 
-    // Event handlers by subscription id.
-    std::multimap<uint64_t /*subscription id*/, wamp_event_handler> m_subscription_handlers;
+    // Local handlers for the topics of events received through
+    // pattern-based subscriptions. Only accessed on the io service.
+    using routed_handlers = boost::container::small_vector<wamp_event_handler, 1>;
+    wamp_uri_trie<routed_handlers> m_event_routes;
+
+    // The publication last passed to the routes. Overlapping pattern-based
+    // subscriptions each receive an EVENT for the same publication, which
+    // the router sends back to back.
+    uint64_t m_routed_publication;
 
     //////////////////////////////////////////////////////////////////////////////////////
     // Callee
 
     // Map of outstanding WAMP register requests (request ID -> register request).
-    std::map<uint64_t, std::shared_ptr<wamp_register_request>> m_register_requests;
+    wamp_id_map<wamp_register_request> m_register_requests;
 
     // Map of outstanding WAMP unregister requests (request ID -> unregister request).
-    std::map<uint64_t, std::shared_ptr<wamp_unregister_request>> m_unregister_requests;
+    wamp_id_map<wamp_unregister_request> m_unregister_requests;
+
+    // Registered procedures by registration id. Only accessed on the io
+    // service.
+    wamp_id_map<wamp_procedure> m_procedures;
+
+    // Local procedures for the URIs called through pattern-based
+    // registrations. Only accessed on the io service.
+    wamp_uri_trie<wamp_procedure> m_procedure_routes;
+
+    // Invocations that have not been answered yet, by request id, so that
+    // they can be interrupted when the caller cancels.
+    wamp_id_map<std::weak_ptr<wamp_invocation_impl>> m_invocations;
+
+    //////////////////////////////////////////////////////////////////////////////////////
+    // Local calls
+
+    wamp_local_calls m_local_calls;
+    bool m_local_shared_calls;
+
+    struct local_procedure
+    {
+        uint64_t registration_id;
+        bool shared;
+
+        // Whether or not the router has let this session call the procedure.
+        bool authorized;
+    };
+
+    // Procedures this session registered for exact matches, by URI and the
+    // URIs by registration id. Only accessed on the io service.
+    std::unordered_map<std::string, local_procedure> m_local_procedures;
+    wamp_id_map<std::string> m_local_procedure_uris;
 
-    // Map of registered procedures (registration ID -> procedure)
-    std::map<uint64_t, wamp_procedure> m_procedures;
+    // Calls sent to the router for a local procedure that is not
+    // authorized yet, by request id. Their results authorize the procedure.
+    wamp_id_map<std::string> m_authorizing_calls;
 };
 
 } // namespace autobahn
@@ -29,6 +29,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include "exceptions.hpp"
+#include "wamp_arguments.hpp"
 #include "wamp_call.hpp"
 #include "wamp_error.hpp"
 #include "wamp_event.hpp"
@@ -59,38 +60,647 @@
 #include <cstdint>
 #include <exception>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdlib.h>
+#include <tuple>
+#include <type_traits>
 
 namespace autobahn {
 
 inline wamp_session::wamp_session(
         boost::asio::io_service& io_service,
         bool debug_enabled)
-    : m_debug_enabled(debug_enabled)
+    : m_logger(debug_enabled ? log_level::trace : log_level::warning)
     , m_io_service(io_service)
     , m_transport()
     , m_request_id(ATOMIC_VAR_INIT(0))
-    , m_session_id(0)
+    , m_instance_id(next_instance_id())
+    , m_commands()
+    , m_commands_scheduled(ATOMIC_VAR_INIT(false))
+    , m_caller_encoding(false)
+    , m_caller_serializer()
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    , m_continuation_executor()
+#endif
+    , m_session_id(ATOMIC_VAR_INIT(0))
     , m_goodbye_sent(false)
     , m_running(false)
+    , m_router_call_canceling(false)
+    , m_call_timeouts(std::chrono::milliseconds(10))
+    , m_call_timer(io_service)
+    , m_call_timer_scheduled(false)
+    , m_result_caches()
+    , m_result_caches_mutex()
+    , m_publications()
+    , m_publication_queue()
+    , m_publish_window(0)
+    , m_pending_publications(ATOMIC_VAR_INIT(0))
+    , m_subscription_ids()
+    , m_subscription_keys()
+    , m_subscription_topics()
+    , m_last_handler_id(0)
+    , m_routed_publication(0)
+    , m_local_calls(wamp_local_calls::disabled)
+    , m_local_shared_calls(false)
+    , m_local_procedures()
+    , m_local_procedure_uris()
+    , m_authorizing_calls()
 {
 }
 
 inline wamp_session::~wamp_session()
 {
+    while (command* pending = m_commands.pop()) {
+        delete pending;
+    }
 }
 
-inline boost::future<void> wamp_session::start()
+inline wamp_logger& wamp_session::logger()
 {
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    return m_logger;
+}
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
+inline boost::asio::io_service& wamp_session::io_service()
+{
+    return m_io_service;
+}
+
+inline void wamp_session::set_caller_encoding(bool enabled)
+{
+    submit_function([this, enabled]() {
+        m_caller_encoding = enabled;
+        update_caller_serializer();
+    });
+}
+
+inline void wamp_session::set_local_calls(wamp_local_calls mode, bool shared)
+{
+    submit_function([this, mode, shared]() {
+        m_local_calls = mode;
+        m_local_shared_calls = shared;
+        update_caller_serializer();
+    });
+}
+
+inline void wamp_session::set_publish_window(std::size_t window)
+{
+    submit_function([this, window]() {
+        m_publish_window = window;
+        release_publications();
+    });
+}
+
+inline std::size_t wamp_session::pending_publications() const
+{
+    return m_pending_publications;
+}
+
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+inline void wamp_session::set_continuation_executor(const boost::executor_ptr_type& executor)
+{
+    m_continuation_executor = executor;
+}
+#endif
+
+template <typename Request, typename Payload>
+class wamp_session::request_command : public wamp_session::command
+{
+public:
+    request_command(uint64_t request_id, Payload&& message, Request&& request)
+        : m_request_id(request_id)
+        , m_message(std::move(message))
+        , m_request(std::move(request))
+    {
+    }
+
+    virtual void execute(wamp_session& session) override
+    {
+        session.issue(m_request_id, std::move(m_message), m_request);
+    }
+
+private:
+    uint64_t m_request_id;
+    Payload m_message;
+    Request m_request;
+};
+
+template <typename Function>
+class wamp_session::function_command : public wamp_session::command
+{
+public:
+    explicit function_command(Function&& function)
+        : m_function(std::move(function))
+    {
+    }
+
+    virtual void execute(wamp_session&) override
+    {
+        m_function();
+    }
+
+private:
+    Function m_function;
+};
+
+template <typename Request>
+class wamp_session::batch_command : public wamp_session::command
+{
+public:
+    batch_command(
+            std::vector<uint64_t>&& request_ids,
+            std::vector<wamp_message>&& messages,
+            std::vector<Request>&& requests)
+        : m_request_ids(std::move(request_ids))
+        , m_messages(std::move(messages))
+        , m_requests(std::move(requests))
+    {
+    }
+
+    virtual void execute(wamp_session& session) override
+    {
+        session.issue_batch(m_request_ids, std::move(m_messages), m_requests);
+    }
+
+private:
+    std::vector<uint64_t> m_request_ids;
+    std::vector<wamp_message> m_messages;
+    std::vector<Request> m_requests;
+};
+
+template <typename Request>
+inline void wamp_session::submit_request(
+        uint64_t request_id, wamp_message&& message, Request&& request)
+{
+    std::shared_ptr<wamp_serializer> serializer = std::atomic_load(&m_caller_serializer);
+    if (serializer) {
+        msgpack::sbuffer frame;
+        try {
+            serializer->serialize(message, frame);
+        } catch (const std::exception&) {
+            // Leave it to the io service, which reports the failure through
+            // the request's future.
+            serializer.reset();
+        }
+
+        if (serializer) {
+            submit(std::unique_ptr<command>(new request_command<Request, msgpack::sbuffer>(
+                    request_id, std::move(frame), std::move(request))));
             return;
         }
+    }
+
+    submit(std::unique_ptr<command>(new request_command<Request, wamp_message>(
+            request_id, std::move(message), std::move(request))));
+}
+
+template <typename Function>
+inline void wamp_session::submit_function(Function&& function)
+{
+    typedef typename std::decay<Function>::type function_type;
+    submit(std::unique_ptr<command>(new function_command<function_type>(
+            function_type(std::forward<Function>(function)))));
+}
+
+inline void wamp_session::submit(std::unique_ptr<command> command)
+{
+    m_commands.push(command.release());
+    schedule_commands();
+}
+
+inline void wamp_session::schedule_commands()
+{
+    // Only one drain is ever outstanding, which makes the io service thread
+    // running it the only consumer of the queue.
+    if (m_commands_scheduled.exchange(true)) {
+        return;
+    }
+
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    m_io_service.post([weak_self]() {
+        auto shared_self = weak_self.lock();
+        if (shared_self) {
+            shared_self->drain_commands();
+        }
+    });
+}
+
+inline void wamp_session::drain_commands()
+{
+    // Bound the batch so that a busy producer cannot starve reads.
+    static const std::size_t MAX_COMMANDS_PER_DRAIN = 256;
+
+    for (std::size_t executed = 0; executed < MAX_COMMANDS_PER_DRAIN; ++executed) {
+        std::unique_ptr<command> next(m_commands.pop());
+        if (!next) {
+            break;
+        }
+
+        try {
+            next->execute(*this);
+        } catch (...) {
+            // Keep draining once the exception has been handled.
+            m_commands_scheduled.store(false);
+            schedule_commands();
+            throw;
+        }
+    }
+
+    m_commands_scheduled.store(false);
+
+    // A producer that pushed while the drain was still marked as scheduled
+    // did not post one, so pick up its commands.
+    if (!m_commands.empty()) {
+        schedule_commands();
+    }
+}
+
+inline uint64_t wamp_session::next_instance_id()
+{
+    static std::atomic<uint64_t> instances(ATOMIC_VAR_INIT(0));
+    return ++instances;
+}
+
+inline uint64_t wamp_session::next_request_id()
+{
+    // Each thread takes request ids from m_request_id in blocks so that
+    // concurrent callers do not contend on a single counter. A thread keeps
+    // a block for each of the last few sessions it used, so alternating
+    // between them does not throw blocks away. Beyond that the least
+    // recently created block is replaced and the rest of its ids are lost,
+    // which only leaves gaps in the ids of that session.
+    static const uint64_t REQUEST_ID_BLOCK_SIZE = 64;
+    static const std::size_t REQUEST_ID_BLOCKS = 4;
+
+    struct request_id_block
+    {
+        uint64_t instance_id;
+        uint64_t next;
+        uint64_t end;
+    };
+    static thread_local request_id_block blocks[REQUEST_ID_BLOCKS] = {};
+    static thread_local std::size_t oldest_block = 0;
+
+    request_id_block* block = nullptr;
+    for (std::size_t i = 0; i < REQUEST_ID_BLOCKS; ++i) {
+        if (blocks[i].instance_id == m_instance_id) {
+            block = &blocks[i];
+            break;
+        }
+    }
+
+    if (!block) {
+        block = &blocks[oldest_block];
+        oldest_block = (oldest_block + 1) % REQUEST_ID_BLOCKS;
+        block->instance_id = m_instance_id;
+        block->next = 0;
+        block->end = 0;
+    }
+
+    if (block->next == block->end) {
+        block->next = m_request_id.fetch_add(REQUEST_ID_BLOCK_SIZE) + 1;
+        block->end = block->next + REQUEST_ID_BLOCK_SIZE;
+    }
+
+    return block->next++;
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t, Payload&& message, boost::promise<void>& published)
+{
+    try {
+        send_message(std::move(message));
+        published.set_value();
+    } catch (const std::exception& e) {
+        published.set_exception(boost::copy_exception(e));
+    }
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_publish_request& publish_request)
+{
+    if (publish_request.local_delivery() == wamp_local_delivery::local_only) {
+        deliver_local_event(message, true);
+        publish_request.response().set_value(wamp_publication());
+        return;
+    }
+
+    if (publish_request.local_delivery() == wamp_local_delivery::local_and_router) {
+        deliver_local_event(message, false);
+    }
+
+    if (!publish_request.acknowledge()) {
+        try {
+            send_message(std::move(message));
+            publish_request.response().set_value(wamp_publication());
+        } catch (const std::exception& e) {
+            publish_request.response().set_exception(boost::copy_exception(e));
+        }
+        return;
+    }
+
+    if (m_publish_window != 0 &&
+            (m_publications.size() >= m_publish_window || !m_publication_queue.empty())) {
+        m_publication_queue.emplace_back(
+                request_id, std::move(message), std::move(publish_request));
+        return;
+    }
+
+    send_publication(request_id, std::move(message), publish_request);
+}
+
+template <typename Payload>
+inline void wamp_session::send_publication(
+        uint64_t request_id, Payload&& message, wamp_publish_request& publish_request)
+{
+    try {
+        send_message(std::move(message));
+        publish_request.set_sent(std::chrono::steady_clock::now());
+        m_publications.emplace(request_id, std::move(publish_request));
+    } catch (const std::exception& e) {
+        --m_pending_publications;
+        publish_request.response().set_exception(boost::copy_exception(e));
+    }
+}
+
+inline void wamp_session::release_publications()
+{
+    while (!m_publication_queue.empty() &&
+            (m_publish_window == 0 || m_publications.size() < m_publish_window)) {
+        queued_publication next(std::move(m_publication_queue.front()));
+        m_publication_queue.pop_front();
+
+        if (next.message.size() != 0) {
+            send_publication(next.request_id, std::move(next.message), next.request);
+        } else {
+            send_publication(next.request_id, std::move(next.frame), next.request);
+        }
+    }
+}
+
+inline wamp_session::queued_publication::queued_publication(
+        uint64_t request_id, wamp_message&& message, wamp_publish_request&& request)
+    : request_id(request_id)
+    , message(std::move(message))
+    , frame()
+    , request(std::move(request))
+{
+}
+
+inline wamp_session::queued_publication::queued_publication(
+        uint64_t request_id, msgpack::sbuffer&& frame, wamp_publish_request&& request)
+    : request_id(request_id)
+    , message(0)
+    , frame(std::move(frame))
+    , request(std::move(request))
+{
+}
+
+inline std::string wamp_session::subscription_key(
+        const std::string& topic, const wamp_subscribe_options& options)
+{
+    std::string key = options.is_match_set() ? options.match() : std::string("exact");
+    key += ' ';
+    key += topic;
+    return key;
+}
+
+inline std::string wamp_session::subscription_topic(const std::string& key, wamp_match& match)
+{
+    const std::size_t separator = key.find(' ');
+    const std::string policy = key.substr(0, separator);
+    if (policy == "prefix") {
+        match = wamp_match::prefix;
+    } else if (policy == "wildcard") {
+        match = wamp_match::wildcard;
+    } else {
+        match = wamp_match::exact;
+    }
+
+    return key.substr(separator + 1);
+}
+
+inline wamp_subscription wamp_session::attach_subscriber(
+        uint64_t subscription_id, const wamp_subscribe_request& subscribe_request)
+{
+    subscribed_handler subscribed;
+    subscribed.id = ++m_last_handler_id;
+    subscribed.handler = subscribe_request.handler();
+    subscribed.executor = subscribe_request.executor();
+    m_subscription_handlers.emplace(subscription_id).push_back(subscribed);
+
+    return wamp_subscription(subscription_id, subscribed.id);
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_subscribe_request& subscribe_request)
+{
+    // Join the router subscription if there already is one for the key.
+    // Requests racing for a new one are all sent, the router answers them
+    // with the same subscription id.
+    auto shared = m_subscription_ids.find(subscribe_request.key());
+    if (shared != m_subscription_ids.end()) {
+        subscribe_request.set_response(attach_subscriber(shared->second, subscribe_request));
+        return;
+    }
+
+    try {
+        send_message(std::move(message));
+        m_subscribe_requests.emplace(request_id, std::move(subscribe_request));
+    } catch (const std::exception& e) {
+        subscribe_request.response().set_exception(boost::copy_exception(e));
+    }
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_unsubscribe_request& unsubscribe_request)
+{
+    // Detach the handler right away, events must not reach it after the
+    // unsubscribe was issued even while other handlers keep the router
+    // subscription alive.
+    const wamp_subscription& subscription = unsubscribe_request.subscription();
+    bool last = true;
+    bool attached = subscription.handler_id() == 0;
+    if (subscribed_handlers* subscribed = m_subscription_handlers.find(subscription.id())) {
+        if (subscription.handler_id() != 0) {
+            for (auto itr = subscribed->begin(); itr != subscribed->end(); ++itr) {
+                if (itr->id == subscription.handler_id()) {
+                    subscribed->erase(itr);
+                    attached = true;
+                    break;
+                }
+            }
+            last = subscribed->empty();
+        }
+
+        if (last) {
+            m_subscription_handlers.erase(subscription.id());
+        }
+    }
+
+    // Handler ids are never reused, so a handler that is not attached has
+    // already been unsubscribed or its subscription ended with an earlier
+    // session. Its subscription id may belong to someone else by now.
+    if (!attached) {
+        unsubscribe_request.response().set_exception(wamp_error(message_type::UNSUBSCRIBE,
+                request_id, "wamp.error.no_such_subscription", EMPTY_DETAILS,
+                EMPTY_ARGUMENTS, EMPTY_KW_ARGUMENTS, msgpack::zone()));
+        return;
+    }
+
+    if (!last) {
+        unsubscribe_request.set_response();
+        return;
+    }
+
+    // New subscribers for the key have to subscribe again from now on.
+    if (const std::string* key = m_subscription_keys.find(subscription.id())) {
+        wamp_match match;
+        const std::string topic = subscription_topic(*key, match);
+        m_subscription_topics.erase(topic, match);
+        m_subscription_ids.erase(*key);
+        m_subscription_keys.erase(subscription.id());
+    }
+
+    try {
+        send_message(std::move(message));
+        m_unsubscribe_requests.emplace(request_id, std::move(unsubscribe_request));
+    } catch (const std::exception& e) {
+        unsubscribe_request.response().set_exception(boost::copy_exception(e));
+    }
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_call& call)
+{
+    if (dispatch_local_call(request_id, message, call)) {
+        return;
+    }
+
+    try {
+        send_message(std::move(message));
+        track_call(request_id, std::move(call));
+    } catch (const std::exception& e) {
+        call.result().set_exception(boost::copy_exception(e));
+    }
+}
+
+inline void wamp_session::issue_batch(
+        const std::vector<uint64_t>&,
+        std::vector<wamp_message>&& messages,
+        std::vector<boost::promise<void>>& published)
+{
+    try {
+        send_messages(std::move(messages));
+    } catch (const std::exception& e) {
+        for (auto& publication : published) {
+            publication.set_exception(boost::copy_exception(e));
+        }
+        return;
+    }
+
+    for (auto& publication : published) {
+        publication.set_value();
+    }
+}
+
+inline void wamp_session::issue_batch(
+        const std::vector<uint64_t>& request_ids,
+        std::vector<wamp_message>&& messages,
+        std::vector<wamp_call>& calls)
+{
+    if (m_local_calls != wamp_local_calls::disabled) {
+        std::vector<uint64_t> remote_request_ids;
+        std::vector<wamp_message> remote_messages;
+        std::vector<wamp_call> remote_calls;
+        for (std::size_t index = 0; index < calls.size(); ++index) {
+            if (!dispatch_local_call(request_ids[index], messages[index], calls[index])) {
+                remote_request_ids.push_back(request_ids[index]);
+                remote_messages.push_back(std::move(messages[index]));
+                remote_calls.push_back(std::move(calls[index]));
+            }
+        }
+
+        if (!remote_calls.empty()) {
+            send_call_batch(remote_request_ids, std::move(remote_messages), remote_calls);
+        }
+        return;
+    }
+
+    send_call_batch(request_ids, std::move(messages), calls);
+}
+
+inline void wamp_session::send_call_batch(
+        const std::vector<uint64_t>& request_ids,
+        std::vector<wamp_message>&& messages,
+        std::vector<wamp_call>& calls)
+{
+    try {
+        send_messages(std::move(messages));
+    } catch (const std::exception& e) {
+        for (auto& call : calls) {
+            call.result().set_exception(boost::copy_exception(e));
+        }
+        return;
+    }
+
+    for (std::size_t index = 0; index < calls.size(); ++index) {
+        track_call(request_ids[index], std::move(calls[index]));
+    }
+}
+
+inline void wamp_session::track_call(uint64_t request_id, wamp_call&& call)
+{
+    wamp_call& pending = m_calls.emplace(request_id, std::move(call));
+    if (pending.timeout().count() > 0) {
+        pending.set_timer(m_call_timeouts.schedule(
+                request_id, std::chrono::steady_clock::now() + pending.timeout()));
+        schedule_call_timeouts();
+    }
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_register_request& register_request)
+{
+    try {
+        send_message(std::move(message));
+        m_register_requests.emplace(request_id, std::move(register_request));
+    } catch (const std::exception& e) {
+        register_request.response().set_exception(boost::copy_exception(e));
+    }
+}
+
+template <typename Payload>
+inline void wamp_session::issue(
+        uint64_t request_id, Payload&& message, wamp_unregister_request& unregister_request)
+{
+    // The registration ended with the session it was made in, its id may
+    // belong to someone else by now.
+    const uint64_t session_id = unregister_request.registration().session_id();
+    if (session_id != 0 && session_id != m_session_id) {
+        unregister_request.response().set_exception(wamp_error(message_type::UNREGISTER,
+                request_id, "wamp.error.no_such_registration", EMPTY_DETAILS,
+                EMPTY_ARGUMENTS, EMPTY_KW_ARGUMENTS, msgpack::zone()));
+        return;
+    }
 
+    try {
+        send_message(std::move(message));
+        m_unregister_requests.emplace(request_id, std::move(unregister_request));
+    } catch (const std::exception& e) {
+        unregister_request.response().set_exception(boost::copy_exception(e));
+    }
+}
+
+inline boost::future<void> wamp_session::start()
+{
+    submit_function([this]() {
         if (m_running) {
             m_session_start.set_exception(protocol_error("session already started"));
             return;
@@ -102,22 +712,16 @@ inline boost::future<void> wamp_session::start()
         }
 
         m_running = true;
+        update_caller_serializer();
         m_session_start.set_value();
     });
 
-    return m_session_start.get_future();
+    return bind_future(m_session_start);
 }
 
 inline boost::future<void> wamp_session::stop()
 {
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
-
+    submit_function([this]() {
         if (!m_running) {
             m_session_stop.set_exception(protocol_error("session already stopped"));
             return;
@@ -134,11 +738,12 @@ inline boost::future<void> wamp_session::stop()
         }
 
         m_running = false;
+        update_caller_serializer();
         on_disconnect(true, "stop called");
         m_session_stop.set_value();
     });
 
-    return m_session_stop.get_future();
+    return bind_future(m_session_stop);
 }
 
 inline boost::future<uint64_t> wamp_session::join(
@@ -151,12 +756,19 @@ inline boost::future<uint64_t> wamp_session::join(
 
     std::unordered_map<std::string, bool> caller_features;
     caller_features["call_timeout"] = true;
+    caller_features["call_canceling"] = true;
+    caller_features["progressive_call_results"] = true;
+    caller_features["progressive_call_invocations"] = true;
     std::unordered_map<std::string, msgpack::object> caller;
     caller["features"] = msgpack::object(caller_features, zone);
     roles["caller"] = msgpack::object(caller, zone);
 
     std::unordered_map<std::string, bool> callee_features;
     callee_features["call_timeout"] = true;
+    callee_features["call_canceling"] = true;
+    callee_features["progressive_call_invocations"] = true;
+    callee_features["pattern_based_registration"] = true;
+    callee_features["shared_registration"] = true;
     std::unordered_map<std::string, msgpack::object> callee;
     callee["features"] = msgpack::object(callee_features, zone);
     roles["callee"] = msgpack::object(callee, zone);
@@ -177,327 +789,927 @@ inline boost::future<uint64_t> wamp_session::join(
     message->set_field(1, realm);
     message->set_field(2, details);
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
-
+    submit_function([this, message]() {
         if (m_session_id) {
             m_session_join.set_exception(protocol_error("session already joined"));
             return;
         }
 
-        try {
-            send_message(std::move(*message), false);
-        } catch (const std::exception& e) {
-            m_session_join.set_exception(boost::copy_exception(e));
-        }
-    });
+        try {
+            send_message(std::move(*message), false);
+        } catch (const std::exception& e) {
+            m_session_join.set_exception(boost::copy_exception(e));
+        }
+    });
+
+    return bind_future(m_session_join);
+}
+
+inline boost::future<std::string> wamp_session::leave(const std::string& reason)
+{
+    auto message = std::make_shared<wamp_message>(3);
+    message->set_field(0, static_cast<int>(message_type::GOODBYE));
+    message->set_field(1, std::unordered_map<int, int>() /* No Details */);
+    message->set_field(2, reason);
+
+    submit_function([this, message]() {
+        if (m_goodbye_sent) {
+            m_session_leave.set_exception(protocol_error("goodbye already sent"));
+        }
+
+        else {
+            try {
+                send_message(std::move(*message), false);
+                m_goodbye_sent = true;
+                // don't wait for reply to complete the promise, if network connectivity is down it won't get set.
+                m_session_leave.set_value("leaving");
+            } catch (const network_error&) {
+                throw;
+            } catch (const std::exception &e) {
+                m_session_leave.set_exception(boost::copy_exception(e));
+            }
+        }
+
+        m_session_id = 0;
+    });
+
+    return bind_future(m_session_leave);
+}
+
+inline boost::future<void> wamp_session::publish(const std::string& topic)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+    message.set_field(3, topic);
+
+    boost::promise<void> published;
+    auto result = bind_future(published);
+    submit_request(request_id, std::move(message), std::move(published));
+
+    return result;
+}
+
+template <typename List>
+inline boost::future<void> wamp_session::publish(const std::string& topic, const List& arguments)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+
+    boost::promise<void> published;
+    auto result = bind_future(published);
+    submit_request(request_id, std::move(message), std::move(published));
+
+    return result;
+}
+
+template <typename List, typename Map>
+inline boost::future<void> wamp_session::publish(
+        const std::string& topic, const List& arguments, const Map& kw_arguments)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    boost::promise<void> published;
+    auto result = bind_future(published);
+    submit_request(request_id, std::move(message), std::move(published));
+
+    return result;
+}
+
+template <typename List>
+inline boost::future<wamp_publication> wamp_session::publish(
+        const std::string& topic,
+        const List& arguments,
+        const wamp_publish_options& options)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+
+    // Local only publishes are never sent, so they do not take up the
+    // publish window.
+    const bool acknowledge = options.acknowledge()
+            && options.local_delivery() != wamp_local_delivery::local_only;
+    wamp_publish_request publish_request(acknowledge, options.local_delivery());
+    if (acknowledge) {
+        ++m_pending_publications;
+    }
+    auto result = bind_future(publish_request.response());
+
+    // Local delivery needs the arguments, which a frame encoded by the
+    // caller no longer has.
+    if (options.local_delivery() != wamp_local_delivery::none) {
+        submit(std::unique_ptr<command>(new request_command<wamp_publish_request, wamp_message>(
+                request_id, std::move(message), std::move(publish_request))));
+    } else {
+        submit_request(request_id, std::move(message), std::move(publish_request));
+    }
+
+    return result;
+}
+
+template <typename List, typename Map>
+inline boost::future<wamp_publication> wamp_session::publish(
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_publish_options& options)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    // Local only publishes are never sent, so they do not take up the
+    // publish window.
+    const bool acknowledge = options.acknowledge()
+            && options.local_delivery() != wamp_local_delivery::local_only;
+    wamp_publish_request publish_request(acknowledge, options.local_delivery());
+    if (acknowledge) {
+        ++m_pending_publications;
+    }
+    auto result = bind_future(publish_request.response());
+
+    // Local delivery needs the arguments, which a frame encoded by the
+    // caller no longer has.
+    if (options.local_delivery() != wamp_local_delivery::none) {
+        submit(std::unique_ptr<command>(new request_command<wamp_publish_request, wamp_message>(
+                request_id, std::move(message), std::move(publish_request))));
+    } else {
+        submit_request(request_id, std::move(message), std::move(publish_request));
+    }
+
+    return result;
+}
+
+inline void wamp_session::add_event_route(
+        const std::string& topic, const wamp_event_handler& handler, wamp_match match)
+{
+    submit_function([this, topic, handler, match]() {
+        const routed_handlers* existing = m_event_routes.find(topic, match);
+        routed_handlers handlers = existing ? *existing : routed_handlers();
+        handlers.push_back(handler);
+        m_event_routes.insert(topic, match, handlers);
+    });
+}
+
+inline void wamp_session::remove_event_route(const std::string& topic, wamp_match match)
+{
+    submit_function([this, topic, match]() {
+        m_event_routes.erase(topic, match);
+    });
+}
+
+inline boost::future<wamp_subscription> wamp_session::subscribe(
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const wamp_subscribe_options& options)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::SUBSCRIBE));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+
+    wamp_subscribe_request subscribe_request(handler);
+    subscribe_request.set_key(subscription_key(topic, options));
+    auto result = bind_future(subscribe_request.response());
+    submit_request(request_id, std::move(message), std::move(subscribe_request));
+
+    return result;
+}
+
+inline boost::future<wamp_subscription> wamp_session::subscribe(
+        const std::string& topic,
+        const wamp_event_handler& handler,
+        const std::shared_ptr<wamp_executor>& executor,
+        const wamp_subscribe_options& options)
+{
+    if (!executor) {
+        return subscribe(topic, handler, options);
+    }
+
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::SUBSCRIBE));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+
+    wamp_subscribe_request subscribe_request(
+            handler, std::make_shared<wamp_serial_executor>(executor));
+    subscribe_request.set_key(subscription_key(topic, options));
+    auto result = bind_future(subscribe_request.response());
+    submit_request(request_id, std::move(message), std::move(subscribe_request));
+
+    return result;
+}
+
+inline boost::future<void> wamp_session::unsubscribe(const wamp_subscription& subscription)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(3);
+    message.set_field(0, static_cast<int>(message_type::UNSUBSCRIBE));
+    message.set_field(1, request_id);
+    message.set_field(2, subscription.id());
+
+    wamp_unsubscribe_request unsubscribe_request(subscription);
+    auto result = bind_future(unsubscribe_request.response());
+    submit_request(request_id, std::move(message), std::move(unsubscribe_request));
+
+    return result;
+}
+
+inline boost::future<wamp_call_result> wamp_session::call(
+        const std::string& procedure,
+        const wamp_call_options& options)
+{
+    wamp_call call;
+    auto result = bind_future(call.result());
+
+    // A cached result answers the call without taking a request id.
+    std::shared_ptr<wamp_result_cache> cache = find_result_cache(procedure, options);
+    if (cache && answer_from_cache(cache, std::string(), call)) {
+        return result;
+    }
+
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+
+    call.set_timeout(options.timeout());
+    call.set_progress_handler(options.progress_handler());
+    if (options.handle()) {
+        wamp_call_handle(*options.handle()).set_call(request_id, procedure);
+    }
+    submit_request(request_id, std::move(message), std::move(call));
+
+    return result;
+}
+
+template<typename List>
+inline boost::future<wamp_call_result> wamp_session::call(
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options)
+{
+    wamp_call call;
+    auto result = bind_future(call.result());
+
+    // A cached result answers the call without taking a request id.
+    std::shared_ptr<wamp_result_cache> cache = find_result_cache(procedure, options);
+    if (cache && answer_from_cache(cache, pack_arguments(arguments), call)) {
+        return result;
+    }
+
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
+
+    call.set_timeout(options.timeout());
+    call.set_progress_handler(options.progress_handler());
+    if (options.handle()) {
+        wamp_call_handle(*options.handle()).set_call(request_id, procedure);
+    }
+    submit_request(request_id, std::move(message), std::move(call));
+
+    return result;
+}
+
+template<typename List, typename Map>
+inline boost::future<wamp_call_result> wamp_session::call(
+        const std::string& procedure,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_call_options& options)
+{
+    wamp_call call;
+    auto result = bind_future(call.result());
+
+    // A cached result answers the call without taking a request id.
+    std::shared_ptr<wamp_result_cache> cache = find_result_cache(procedure, options);
+    if (cache && answer_from_cache(cache, pack_arguments(arguments, kw_arguments), call)) {
+        return result;
+    }
+
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    call.set_timeout(options.timeout());
+    call.set_progress_handler(options.progress_handler());
+    if (options.handle()) {
+        wamp_call_handle(*options.handle()).set_call(request_id, procedure);
+    }
+    submit_request(request_id, std::move(message), std::move(call));
+
+    return result;
+}
+
+inline std::shared_ptr<wamp_result_cache> wamp_session::cache_results(
+        const std::string& procedure, std::size_t capacity, std::chrono::milliseconds ttl)
+{
+    auto cache = std::make_shared<wamp_result_cache>(capacity, ttl);
+
+    std::lock_guard<std::mutex> lock(m_result_caches_mutex);
+    std::shared_ptr<const result_caches> current = std::atomic_load(&m_result_caches);
+    auto caches = current ? std::make_shared<result_caches>(*current)
+            : std::make_shared<result_caches>();
+    (*caches)[procedure] = cache;
+    std::atomic_store(&m_result_caches, std::shared_ptr<const result_caches>(std::move(caches)));
+
+    return cache;
+}
+
+inline void wamp_session::remove_result_cache(const std::string& procedure)
+{
+    std::lock_guard<std::mutex> lock(m_result_caches_mutex);
+    std::shared_ptr<const result_caches> current = std::atomic_load(&m_result_caches);
+    if (!current || current->count(procedure) == 0) {
+        return;
+    }
 
-    return m_session_join.get_future();
+    auto caches = std::make_shared<result_caches>(*current);
+    caches->erase(procedure);
+    std::atomic_store(&m_result_caches, std::shared_ptr<const result_caches>(std::move(caches)));
 }
 
-inline boost::future<std::string> wamp_session::leave(const std::string& reason)
+inline std::shared_ptr<wamp_result_cache> wamp_session::result_cache(
+        const std::string& procedure) const
 {
-    auto message = std::make_shared<wamp_message>(3);
-    message->set_field(0, static_cast<int>(message_type::GOODBYE));
-    message->set_field(1, std::unordered_map<int, int>() /* No Details */);
-    message->set_field(2, reason);
+    std::shared_ptr<const result_caches> caches = std::atomic_load(&m_result_caches);
+    if (!caches) {
+        return nullptr;
+    }
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    auto found = caches->find(procedure);
+    return found == caches->end() ? nullptr : found->second;
+}
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
+inline boost::future<wamp_subscription> wamp_session::invalidate_results_on(
+        const std::string& topic,
+        const std::string& procedure,
+        const wamp_subscribe_options& options)
+{
+    auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+    return subscribe(topic, [weak_this, procedure](const wamp_event&) {
+        auto shared_this = weak_this.lock();
+        if (!shared_this) {
             return;
         }
 
-        if (m_goodbye_sent) {
-            m_session_leave.set_exception(protocol_error("goodbye already sent"));
+        if (std::shared_ptr<wamp_result_cache> cache = shared_this->result_cache(procedure)) {
+            cache->clear();
         }
+    }, options);
+}
 
-        else {
-            try {
-                send_message(std::move(*message), false);
-                m_goodbye_sent = true;
-                // don't wait for reply to complete the promise, if network connectivity is down it won't get set.
-                m_session_leave.set_value("leaving");
-            } catch (const network_error&) {
-                throw;
-            } catch (const std::exception &e) {
-                m_session_leave.set_exception(boost::copy_exception(e));
-            }
+#if BOOST_VERSION >= 107000
+struct wamp_session::initiate_call
+{
+    wamp_session* session;
+    uint64_t request_id;
+    wamp_message message;
+    std::chrono::milliseconds timeout;
+    wamp_progress_handler progress_handler;
+    std::shared_ptr<wamp_result_cache> cache;
+    std::string cache_key;
+    uint64_t cache_generation;
+
+    template <typename Handler>
+    void operator()(Handler&& handler)
+    {
+        wamp_call call(wamp_completion<wamp_call_result>(std::forward<Handler>(handler)));
+        call.set_timeout(timeout);
+        call.set_progress_handler(progress_handler);
+        if (cache) {
+            call.set_cache(cache, std::move(cache_key), cache_generation);
         }
+        session->submit_request(request_id, std::move(message), std::move(call));
+    }
+};
 
-        m_session_id = 0;
-    });
+struct wamp_session::initiate_cached_call
+{
+    // Completes the call on the io service, where handlers always run.
+    struct answer
+    {
+        wamp_call call;
+        wamp_call_result result;
+
+        void operator()()
+        {
+            call.set_result(std::move(result));
+        }
+    };
 
-    return m_session_leave.get_future();
-}
+    wamp_session* session;
+    wamp_call_result result;
 
-inline boost::future<void> wamp_session::publish(const std::string& topic)
-{
-    uint64_t request_id = ++m_request_id;
+    template <typename Handler>
+    void operator()(Handler&& handler)
+    {
+        session->submit_function(answer{
+                wamp_call(wamp_completion<wamp_call_result>(std::forward<Handler>(handler))),
+                std::move(result)});
+    }
+};
 
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, std::unordered_map<int, int>() /* No Options */);
-    message->set_field(3, topic);
+struct wamp_session::initiate_subscribe
+{
+    wamp_session* session;
+    uint64_t request_id;
+    wamp_message message;
+    wamp_event_handler handler;
+    std::string key;
+
+    template <typename Handler>
+    void operator()(Handler&& completion_handler)
+    {
+        wamp_subscribe_request subscribe_request(handler, nullptr,
+                wamp_completion<wamp_subscription>(std::forward<Handler>(completion_handler)));
+        subscribe_request.set_key(key);
+        session->submit_request(request_id, std::move(message), std::move(subscribe_request));
+    }
+};
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+struct wamp_session::initiate_provide
+{
+    wamp_session* session;
+    uint64_t request_id;
+    wamp_message message;
+    wamp_procedure procedure;
+    std::string local_uri;
+    bool shared;
+
+    template <typename Handler>
+    void operator()(Handler&& handler)
+    {
+        wamp_register_request register_request(procedure,
+                wamp_completion<wamp_registration>(std::forward<Handler>(handler)));
+        register_request.set_local_uri(local_uri, shared);
+        session->submit_request(request_id, std::move(message), std::move(register_request));
+    }
+};
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+template <typename Handler>
+class wamp_session::publish_command : public wamp_session::command
+{
+public:
+    publish_command(wamp_message&& message, Handler&& handler)
+        : m_message(std::move(message))
+        , m_handler(std::move(handler))
+    {
+    }
 
+    virtual void execute(wamp_session& session) override
+    {
+        std::exception_ptr error;
         try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
+            session.send_message(std::move(m_message));
+        } catch (const std::exception&) {
+            error = std::current_exception();
         }
-    });
 
-    return result->get_future();
-}
+        Handler handler(std::move(m_handler));
+        handler(error);
+    }
 
-template <typename List>
-inline boost::future<void> wamp_session::publish(const std::string& topic, const List& arguments)
+private:
+    wamp_message m_message;
+    Handler m_handler;
+};
+
+struct wamp_session::initiate_publish
 {
-    uint64_t request_id = ++m_request_id;
+    wamp_session* session;
+    wamp_message message;
+
+    template <typename Handler>
+    void operator()(Handler&& handler)
+    {
+        typedef typename std::decay<Handler>::type handler_type;
+        session->submit(std::unique_ptr<command>(new publish_command<handler_type>(
+                std::move(message), handler_type(std::forward<Handler>(handler)))));
+    }
+};
 
-    auto message = std::make_shared<wamp_message>(5);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, std::unordered_map<int, int>() /* No Options */);
-    message->set_field(3, topic);
-    message->set_field(4, arguments);
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish(
+        const std::string& topic,
+        const List& arguments,
+        CompletionToken&& token)
+{
+    uint64_t request_id = next_request_id();
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            initiate_publish{this, std::move(message)}, token);
+}
 
-        try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
-        }
-    });
+template <typename List, typename Map, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr))
+wamp_session::async_publish(
+        const std::string& topic,
+        const List& arguments,
+        const Map& kw_arguments,
+        CompletionToken&& token)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::PUBLISH));
+    message.set_field(1, request_id);
+    message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+    message.set_field(3, topic);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr)>(
+            initiate_publish{this, std::move(message)}, token);
+}
 
-    return result->get_future();
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
+        const std::string& procedure,
+        const List& arguments,
+        CompletionToken&& token)
+{
+    return async_call(procedure, arguments, wamp_call_options(),
+            std::forward<CompletionToken>(token));
 }
 
-template <typename List, typename Map>
-inline boost::future<void> wamp_session::publish(
-        const std::string& topic, const List& arguments, const Map& kw_arguments)
+template <typename List, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
+        const std::string& procedure,
+        const List& arguments,
+        const wamp_call_options& options,
+        CompletionToken&& token)
 {
-    uint64_t request_id = ++m_request_id;
+    // A cached result answers the call without taking a request id.
+    std::shared_ptr<wamp_result_cache> cache = find_result_cache(procedure, options);
+    std::string cache_key;
+    uint64_t cache_generation = 0;
+    if (cache) {
+        cache_key = pack_arguments(arguments);
+        wamp_call_result cached;
+        if (find_cached_result(cache, cache_key, cache_generation, cached)) {
+            return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+                    initiate_cached_call{this, std::move(cached)}, token);
+        }
+    }
 
-    auto message = std::make_shared<wamp_message>(6);
-    message->set_field(0, static_cast<int>(message_type::PUBLISH));
-    message->set_field(1, request_id);
-    message->set_field(2, std::unordered_map<int, int>() /* No Options */);
-    message->set_field(3, topic);
-    message->set_field(4, arguments);
-    message->set_field(5, kw_arguments);
+    uint64_t request_id = next_request_id();
 
-    auto result = std::make_shared<boost::promise<void>>();
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    wamp_message message(5);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    if (options.handle()) {
+        wamp_call_handle(*options.handle()).set_call(request_id, procedure);
+    }
 
-        try {
-            send_message(std::move(*message));
-            result->set_value();
-        } catch (const std::exception& e) {
-            result->set_exception(boost::copy_exception(e));
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+            initiate_call{this, request_id, std::move(message),
+                    options.timeout(), options.progress_handler(),
+                    std::move(cache), std::move(cache_key), cache_generation},
+            token);
+}
+
+template <typename List, typename Map, typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_call_result))
+wamp_session::async_call(
+        const std::string& procedure,
+        const List& arguments,
+        const Map& kw_arguments,
+        const wamp_call_options& options,
+        CompletionToken&& token)
+{
+    // A cached result answers the call without taking a request id.
+    std::shared_ptr<wamp_result_cache> cache = find_result_cache(procedure, options);
+    std::string cache_key;
+    uint64_t cache_generation = 0;
+    if (cache) {
+        cache_key = pack_arguments(arguments, kw_arguments);
+        wamp_call_result cached;
+        if (find_cached_result(cache, cache_key, cache_generation, cached)) {
+            return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+                    initiate_cached_call{this, std::move(cached)}, token);
         }
-    });
+    }
+
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(6);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, procedure);
+    message.set_field(4, arguments);
+    message.set_field(5, kw_arguments);
 
-    return result->get_future();
+    if (options.handle()) {
+        wamp_call_handle(*options.handle()).set_call(request_id, procedure);
+    }
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_call_result)>(
+            initiate_call{this, request_id, std::move(message),
+                    options.timeout(), options.progress_handler(),
+                    std::move(cache), std::move(cache_key), cache_generation},
+            token);
 }
 
-inline boost::future<wamp_subscription> wamp_session::subscribe(
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_subscription))
+wamp_session::async_subscribe(
         const std::string& topic,
         const wamp_event_handler& handler,
-        const wamp_subscribe_options& options)
+        const wamp_subscribe_options& options,
+        CompletionToken&& token)
 {
-    uint64_t request_id = ++m_request_id;
-
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::SUBSCRIBE));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, topic);
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::SUBSCRIBE));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, topic);
+
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_subscription)>(
+            initiate_subscribe{this, request_id, std::move(message), handler,
+                    subscription_key(topic, options)},
+            token);
+}
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto subscribe_request = std::make_shared<wamp_subscribe_request>(handler);
+template <typename CompletionToken>
+inline BOOST_ASIO_INITFN_RESULT_TYPE(CompletionToken, void(std::exception_ptr, wamp_registration))
+wamp_session::async_provide(
+        const std::string& uri,
+        const wamp_procedure& procedure,
+        const provide_options& options,
+        CompletionToken&& token)
+{
+    uint64_t request_id = next_request_id();
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::REGISTER));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, uri);
 
-        try {
-            send_message(std::move(*message));
-            m_subscribe_requests.emplace(request_id, subscribe_request);
-        } catch (const std::exception& e) {
-            subscribe_request->response().set_exception(boost::copy_exception(e));
-        }
-    });
+    wamp_register_request local;
+    set_local_uri(local, uri, options);
 
-    return subscribe_request->response().get_future();
+    return boost::asio::async_initiate<CompletionToken, void(std::exception_ptr, wamp_registration)>(
+            initiate_provide{this, request_id, std::move(message), procedure,
+                    local.local_uri(), local.shared()},
+            token);
 }
+#endif
 
-inline boost::future<void> wamp_session::unsubscribe(const wamp_subscription& subscription)
+template <typename Range>
+inline std::vector<boost::future<wamp_call_result>> wamp_session::call_many(
+        const Range& calls,
+        const wamp_call_options& options)
 {
-    uint64_t request_id = ++m_request_id;
+    std::vector<uint64_t> request_ids;
+    std::vector<wamp_message> messages;
+    std::vector<wamp_call> pending;
+    std::vector<boost::future<wamp_call_result>> results;
+
+    const std::size_t size = std::distance(std::begin(calls), std::end(calls));
+    request_ids.reserve(size);
+    messages.reserve(size);
+    pending.reserve(size);
+    results.reserve(size);
+
+    for (const auto& entry : calls) {
+        wamp_call call;
+        results.push_back(bind_future(call.result()));
+
+        std::shared_ptr<wamp_result_cache> cache = find_result_cache(std::get<0>(entry), options);
+        if (cache && answer_from_cache(cache, pack_arguments(std::get<1>(entry)), call)) {
+            continue;
+        }
 
-    auto message = std::make_shared<wamp_message>(3);
-    message->set_field(0, static_cast<int>(message_type::UNSUBSCRIBE));
-    message->set_field(1, request_id);
-    message->set_field(2, subscription.id());
+        uint64_t request_id = next_request_id();
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto unsubscribe_request = std::make_shared<wamp_unsubscribe_request>(subscription);
+        wamp_message message(5);
+        message.set_field(0, static_cast<int>(message_type::CALL));
+        message.set_field(1, request_id);
+        message.set_field(2, options);
+        message.set_field(3, std::get<0>(entry));
+        message.set_field(4, std::get<1>(entry));
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+        call.set_timeout(options.timeout());
+        call.set_progress_handler(options.progress_handler());
 
-        try {
-            send_message(std::move(*message));
-            m_unsubscribe_requests.emplace(request_id, unsubscribe_request);
-        } catch (const std::exception& e) {
-            unsubscribe_request->response().set_exception(boost::copy_exception(e));
-        }
-    });
+        request_ids.push_back(request_id);
+        messages.push_back(std::move(message));
+        pending.push_back(std::move(call));
+    }
+
+    if (!pending.empty()) {
+        submit(std::unique_ptr<command>(new batch_command<wamp_call>(
+                std::move(request_ids), std::move(messages), std::move(pending))));
+    }
 
-    return unsubscribe_request->response().get_future();
+    return results;
 }
 
-inline boost::future<wamp_call_result> wamp_session::call(
-        const std::string& procedure,
-        const wamp_call_options& options)
+template <typename Range>
+inline std::vector<boost::future<void>> wamp_session::publish_many(const Range& events)
 {
-    uint64_t request_id = ++m_request_id;
-
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, procedure);
-
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
-
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    std::vector<uint64_t> request_ids;
+    std::vector<wamp_message> messages;
+    std::vector<boost::promise<void>> published;
+    std::vector<boost::future<void>> results;
+
+    const std::size_t size = std::distance(std::begin(events), std::end(events));
+    request_ids.reserve(size);
+    messages.reserve(size);
+    published.reserve(size);
+    results.reserve(size);
+
+    for (const auto& entry : events) {
+        uint64_t request_id = next_request_id();
+
+        wamp_message message(5);
+        message.set_field(0, static_cast<int>(message_type::PUBLISH));
+        message.set_field(1, request_id);
+        message.set_field(2, std::unordered_map<int, int>() /* No Options */);
+        message.set_field(3, std::get<0>(entry));
+        message.set_field(4, std::get<1>(entry));
+
+        boost::promise<void> publication;
+        results.push_back(bind_future(publication));
+
+        request_ids.push_back(request_id);
+        messages.push_back(std::move(message));
+        published.push_back(std::move(publication));
+    }
 
-        try {
-            send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
-        } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
-        }
-    });
+    if (!published.empty()) {
+        submit(std::unique_ptr<command>(new batch_command<boost::promise<void>>(
+                std::move(request_ids), std::move(messages), std::move(published))));
+    }
 
-    return call->result().get_future();
+    return results;
 }
 
 template<typename List>
-inline boost::future<wamp_call_result> wamp_session::call(
-        const std::string& procedure,
+inline void wamp_session::call_chunk(
+        const wamp_call_handle& handle,
         const List& arguments,
         const wamp_call_options& options)
 {
-    uint64_t request_id = ++m_request_id;
-
     auto message = std::make_shared<wamp_message>(5);
     message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
     message->set_field(2, options);
-    message->set_field(3, procedure);
     message->set_field(4, arguments);
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
-
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
-
-        try {
-            send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
-        } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
-        }
-    });
-
-    return call->result().get_future();
+    submit_call_chunk(handle, message);
 }
 
 template<typename List, typename Map>
-inline boost::future<wamp_call_result> wamp_session::call(
-        const std::string& procedure,
+inline void wamp_session::call_chunk(
+        const wamp_call_handle& handle,
         const List& arguments,
         const Map& kw_arguments,
         const wamp_call_options& options)
 {
-    uint64_t request_id = ++m_request_id;
-
     auto message = std::make_shared<wamp_message>(6);
     message->set_field(0, static_cast<int>(message_type::CALL));
-    message->set_field(1, request_id);
     message->set_field(2, options);
-    message->set_field(3, procedure);
     message->set_field(4, arguments);
     message->set_field(5, kw_arguments);
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto call = std::make_shared<wamp_call>();
+    submit_call_chunk(handle, message);
+}
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
+inline void wamp_session::submit_call_chunk(
+        const wamp_call_handle& handle, const std::shared_ptr<wamp_message>& message)
+{
+    // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list, ...]
+    // with the request id of the call being continued.
+    const uint64_t request_id = handle.request_id();
+    if (request_id == 0) {
+        throw std::logic_error("call chunk for a call that has not been made");
+    }
+    message->set_field(1, request_id);
+    message->set_field(3, handle.procedure());
+
+    submit_function([this, request_id, message]() {
+        if (!m_calls.find(request_id)) {
+            AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                    "dropping chunk for non-pending call", request_id);
             return;
         }
 
         try {
             send_message(std::move(*message));
-            m_calls.emplace(request_id, call);
         } catch (const std::exception& e) {
-            call->result().set_exception(boost::copy_exception(e));
+            wamp_call call = take_call(request_id);
+            call.result().set_exception(boost::copy_exception(e));
         }
     });
+}
+
+inline void wamp_session::cancel(const wamp_call_handle& handle, wamp_cancel_mode mode)
+{
+    const uint64_t request_id = handle.request_id();
+    if (request_id == 0) {
+        return;
+    }
 
-    return call->result().get_future();
+    submit_function([this, request_id, mode]() {
+        const wamp_call* pending = m_calls.find(request_id);
+        if (!pending) {
+            return;
+        }
+
+        // Local calls never reached the router, so their invocation is
+        // interrupted here. With kill, its answer completes the call, unless
+        // the invocation is gone already.
+        std::shared_ptr<wamp_invocation_impl> invocation;
+        if (pending->local()) {
+            invocation = pending->local_invocation().lock();
+            if (invocation && mode == wamp_cancel_mode::kill) {
+                interrupt_local_call(request_id, invocation, mode);
+                return;
+            }
+        } else if (m_router_call_canceling) {
+            send_cancel(request_id, mode);
+            return;
+        }
+
+        wamp_call call = take_call(request_id);
+        call.result().set_exception(wamp_error(message_type::CALL, request_id,
+                "wamp.error.canceled", EMPTY_DETAILS, EMPTY_ARGUMENTS,
+                EMPTY_KW_ARGUMENTS, msgpack::zone()));
+
+        if (invocation && mode != wamp_cancel_mode::skip) {
+            interrupt_local_call(request_id, invocation, mode);
+        }
+    });
 }
 
 inline boost::future<wamp_registration> wamp_session::provide(
@@ -505,61 +1717,92 @@ inline boost::future<wamp_registration> wamp_session::provide(
         const wamp_procedure& procedure,
         const provide_options& options)
 {
-    uint64_t request_id = ++m_request_id;
+    uint64_t request_id = next_request_id();
 
-    auto message = std::make_shared<wamp_message>(4);
-    message->set_field(0, static_cast<int>(message_type::REGISTER));
-    message->set_field(1, request_id);
-    message->set_field(2, options);
-    message->set_field(3, name);
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::REGISTER));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, name);
 
-    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-    auto register_request = std::make_shared<wamp_register_request>(procedure);
+    wamp_register_request register_request(procedure);
+    set_local_uri(register_request, name, options);
+    auto result = bind_future(register_request.response());
+    submit_request(request_id, std::move(message), std::move(register_request));
 
-    m_io_service.dispatch([=]() {
-        auto shared_self = weak_self.lock();
-        if (!shared_self) {
-            return;
-        }
+    return result;
+}
 
-        try {
-            send_message(std::move(*message));
-            m_register_requests.emplace(request_id, register_request);
-        } catch (const std::exception& e) {
-            register_request->response().set_exception(boost::copy_exception(e));
-        }
-    });
+inline boost::future<wamp_registration> wamp_session::provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const wamp_execution_policy& policy,
+        const provide_options& options)
+{
+    std::shared_ptr<wamp_executor> executor = policy.executor();
+    if (!executor) {
+        return provide(name, procedure, options);
+    }
 
-    return register_request->response().get_future();
+    // The invocation carries everything needed to answer it, so the
+    // procedure can run anywhere and its result is sent back through the
+    // io service by the invocation's send_result_fn.
+    return provide(name, [executor, procedure](wamp_invocation invocation) {
+        executor->post([procedure, invocation]() {
+            invoke_procedure(procedure, invocation);
+        });
+    }, options);
 }
 
-inline boost::future<void> wamp_session::unprovide(const wamp_registration& registration){
-    uint64_t request_id = ++m_request_id;
+inline boost::future<wamp_registration> wamp_session::provide(
+        const std::string& name,
+        const wamp_procedure& procedure,
+        const wamp_register_options& options)
+{
+    uint64_t request_id = next_request_id();
+
+    wamp_message message(4);
+    message.set_field(0, static_cast<int>(message_type::REGISTER));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+    message.set_field(3, name);
+
+    wamp_register_request register_request(procedure);
+    set_local_uri(register_request, name, options);
+    auto result = bind_future(register_request.response());
+    submit_request(request_id, std::move(message), std::move(register_request));
+
+    return result;
+}
+
+inline void wamp_session::add_procedure_route(
+        const std::string& uri, const wamp_procedure& procedure, wamp_match match)
+{
+    submit_function([this, uri, procedure, match]() {
+        m_procedure_routes.insert(uri, match, procedure);
+    });
+}
 
-	auto message = std::make_shared<wamp_message>(3);
-	message->set_field(0, static_cast<int>(message_type::UNREGISTER));
-	message->set_field(1, request_id);
-	message->set_field(2, registration.id());
+inline void wamp_session::remove_procedure_route(const std::string& uri, wamp_match match)
+{
+    submit_function([this, uri, match]() {
+        m_procedure_routes.erase(uri, match);
+    });
+}
 
-	auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-	auto unregister_request = std::make_shared<wamp_unregister_request>(registration);
+inline boost::future<void> wamp_session::unprovide(const wamp_registration& registration){
+	uint64_t request_id = next_request_id();
 
-	m_io_service.dispatch([=]() {
-		auto shared_self = weak_self.lock();
-		if (!shared_self) {
-			return;
-		}
+	wamp_message message(3);
+	message.set_field(0, static_cast<int>(message_type::UNREGISTER));
+	message.set_field(1, request_id);
+	message.set_field(2, registration.id());
 
-		try {
-			send_message(std::move(*message));
-			m_unregister_requests.emplace(request_id, unregister_request);
-		}
-		catch (const std::exception& e) {
-			unregister_request->response().set_exception(boost::copy_exception(e));
-		}
-	});
+	wamp_unregister_request unregister_request(registration);
+	auto result = bind_future(unregister_request.response());
+	submit_request(request_id, std::move(message), std::move(unregister_request));
 
-	return unregister_request->response().get_future();
+	return result;
 }
 
 inline boost::future<wamp_authenticate> wamp_session::on_challenge(const wamp_challenge& challenge)
@@ -609,48 +1852,100 @@ inline void wamp_session::on_detach(bool was_clean, const std::string& reason)
     assert(!m_running);
 
     m_transport.reset();
+    update_caller_serializer();
 }
 
 inline void wamp_session::on_disconnect(bool was_clean, const std::string& reason)
 {
     m_session_id = 0;
     network_error error(reason);
+
+    // Swap the pending requests out first, failing them runs continuations
+    // that may issue new requests.
+    wamp_id_map<wamp_subscribe_request> subscribe_requests;
+    wamp_id_map<wamp_unsubscribe_request> unsubscribe_requests;
+    wamp_id_map<wamp_register_request> register_requests;
+    wamp_id_map<wamp_unregister_request> unregister_requests;
+    wamp_id_map<wamp_call> calls;
+    wamp_id_map<wamp_publish_request> publications;
+    std::deque<queued_publication> publication_queue;
+    subscribe_requests.swap(m_subscribe_requests);
+    unsubscribe_requests.swap(m_unsubscribe_requests);
+    register_requests.swap(m_register_requests);
+    unregister_requests.swap(m_unregister_requests);
+    calls.swap(m_calls);
+    publications.swap(m_publications);
+    publication_queue.swap(m_publication_queue);
+    m_pending_publications -= publications.size() + publication_queue.size();
+    m_call_timeouts.clear();
+    m_invocations.clear();
+    m_router_call_canceling = false;
+
+    // Router subscriptions and registrations end with the session. The
+    // router may hand out their ids again, so nothing must be dispatched
+    // to the old handlers and procedures. Routes added by the application
+    // are kept.
+    m_subscription_ids.clear();
+    m_subscription_keys.clear();
+    m_subscription_topics.clear();
+    m_subscription_handlers.clear();
+    m_procedures.clear();
+    m_local_procedures.clear();
+    m_local_procedure_uris.clear();
+    m_authorizing_calls.clear();
+
     try {
-        for (auto subscribe_request : m_subscribe_requests) {
+        subscribe_requests.for_each([&](uint64_t, wamp_subscribe_request& subscribe_request) {
+            try {
+                subscribe_request.response().set_exception(error);
+            }
+            catch (boost::promise_already_satisfied &) {
+                // ignore this exception
+            }
+        });
+        unsubscribe_requests.for_each([&](uint64_t, wamp_unsubscribe_request& unsubscribe_request) {
             try {
-                subscribe_request.second->response().set_exception(error);
+                unsubscribe_request.response().set_exception(error);
             }
             catch (boost::promise_already_satisfied &) {
                 // ignore this exception
             }
-        }
-        for (auto unsubscribe_request : m_unsubscribe_requests) {
+        });
+        register_requests.for_each([&](uint64_t, wamp_register_request& register_request) {
             try {
-                unsubscribe_request.second->response().set_exception(error);
+                register_request.response().set_exception(error);
             }
             catch (boost::promise_already_satisfied &) {
                 // ignore this exception
             }
-        }
-        for (auto register_request : m_register_requests) {
+        });
+        unregister_requests.for_each([&](uint64_t, wamp_unregister_request& unregister_request) {
             try {
-                register_request.second->response().set_exception(error);
+                unregister_request.response().set_exception(error);
             }
             catch (boost::promise_already_satisfied &) {
                 // ignore this exception
             }
-        }
-        for (auto unregister_request : m_unregister_requests) {
+        });
+        calls.for_each([&](uint64_t, wamp_call& call) {
             try {
-                unregister_request.second->response().set_exception(error);
+                call.result().set_exception(error);
             }
             catch (boost::promise_already_satisfied &) {
                 // ignore this exception
             }
-        }
-        for (auto call : m_calls) {
+        });
+        publications.for_each([&](uint64_t, wamp_publish_request& publish_request) {
             try {
-                call.second->result().set_exception(error);
+                publish_request.response().set_exception(error);
+            }
+            catch (boost::promise_already_satisfied &) {
+                // ignore this exception
+            }
+        });
+        for (auto& queued : publication_queue) {
+            try {
+                queued.request.response().set_exception(error);
             }
             catch (boost::promise_already_satisfied &) {
                 // ignore this exception
@@ -721,7 +2016,7 @@ inline void wamp_session::on_message(wamp_message&& message)
         case message_type::PUBLISH:
             throw protocol_error("received PUBLISH message unexpected for WAMP client roles");
         case message_type::PUBLISHED:
-            // FIXME
+            process_published(std::move(message));
             break;
         case message_type::SUBSCRIBE:
             throw protocol_error("received SUBSCRIBE message unexpected for WAMP client roles");
@@ -757,7 +2052,8 @@ inline void wamp_session::on_message(wamp_message&& message)
             process_invocation(std::move(message));
             break;
         case message_type::INTERRUPT:
-            throw protocol_error("received INTERRUPT message - not implemented");
+            process_interrupt(std::move(message));
+            break;
         case message_type::YIELD:
             throw protocol_error("received YIELD message unexpected for WAMP client roles");
     }
@@ -816,9 +2112,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
             challenge_object = wamp_challenge("wampcra",challenge,salt,iterations,keylen);
 
         } catch (const std::exception& e) {
-            if (m_debug_enabled) {
-                std::cerr << "failed to parse challenge details" << std::endl;
-            }
+            AUTOBAHN_LOG(m_logger, log_level::warning, log_event::session, "failed to parse challenge details");
 			std::string message("wampcra authentication: Failed parse challange details:");
 			message += e.what();
 			throw protocol_error(message);
@@ -841,7 +2135,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
     std::shared_ptr< boost::future< void > > context_response = std::make_shared< boost::future<void> >();
 
     // call the context, to get a signature...
-    (*context_response) = on_challenge(challenge_object).then([=]( boost::future<wamp_authenticate> fu_auth) {
+    (*context_response) = on_challenge(challenge_object).then([this, context_response]( boost::future<wamp_authenticate> fu_auth) {
         try {
             const wamp_authenticate sig = fu_auth.get();
 
@@ -851,7 +2145,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
             message->set_field(2, std::unordered_map<int, int>() /* No Extra/Dict */);
 
             auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
-            m_io_service.dispatch([=]() {
+            m_io_service.dispatch([this, weak_self, message]() {
                 auto shared_self = weak_self.lock();
                 if (!shared_self) {
                     return;
@@ -860,9 +2154,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
                 try {
                     send_message(std::move(*message), false);
                 } catch (const std::exception& e) {
-                    if (m_debug_enabled) {
-                        std::cerr << "failed to handle authentication" << std::endl;
-                    }
+                    AUTOBAHN_LOG(m_logger, log_level::warning, log_event::session, "failed to handle authentication");
 					std::string message("authentication error: failed send signature:");
 					message += e.what();
 					throw protocol_error(message);
@@ -872,9 +2164,7 @@ inline void wamp_session::process_challenge(wamp_message&& message)
             // make sure the context_response is copied into this lambda...
             context_response.get();
         } catch (const std::exception& e) {
-            if (m_debug_enabled) {
-                std::cerr << "failed to handle authentication" << std::endl;
-            }
+            AUTOBAHN_LOG(m_logger, log_level::warning, log_event::session, "failed to handle authentication");
 			std::string message("authentication error: failed send signature:");
 			message += e.what();
             throw protocol_error(message);
@@ -884,8 +2174,25 @@ inline void wamp_session::process_challenge(wamp_message&& message)
 
 inline void wamp_session::process_welcome(wamp_message&& message)
 {
+    // [WELCOME, Session|id, Details|dict]
+
+    m_router_call_canceling = false;
+    if (message.size() > 2 && message.is_field_type(2, msgpack::type::MAP)) {
+        try {
+            msgpack::object roles = value_for_key_or<msgpack::object>(
+                    message.field(2), "roles", EMPTY_DETAILS);
+            msgpack::object dealer = value_for_key_or<msgpack::object>(
+                    roles, "dealer", EMPTY_DETAILS);
+            msgpack::object features = value_for_key_or<msgpack::object>(
+                    dealer, "features", EMPTY_DETAILS);
+            m_router_call_canceling = value_for_key_or<bool>(features, "call_canceling", false);
+        } catch (const std::exception&) {
+            AUTOBAHN_LOG(m_logger, log_level::warning, log_event::session, "failed to parse router roles");
+        }
+    }
+
     m_session_id = message.field<uint64_t>(1);
-    m_session_join.set_value(m_session_id);
+    m_session_join.set_value(m_session_id.load());
 }
 
 inline void wamp_session::process_abort(wamp_message&& message)
@@ -967,156 +2274,582 @@ inline void wamp_session::process_error(wamp_message&& message)
     if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
         throw protocol_error("invalid ERROR message structure - REQUEST.Request must be an integer");
     }
-    auto request_id = message.field<uint64_t>(2);
+    auto request_id = message.field<uint64_t>(2);
+
+    // Details
+    if (!message.is_field_type(3, msgpack::type::MAP)) {
+        throw protocol_error("invalid ERROR message structure - Details must be a dictionary");
+    }
+
+    details = message.field(3);
+
+    // Error|uri
+    if (!message.is_field_type(4, msgpack::type::STR)) {
+        throw protocol_error("invalid ERROR message - Error must be a string (URI)");
+    }
+    auto error_uri = std::move(message.field<std::string>(4));
+
+    // Arguments|list
+    if (message.size() > 5) {
+        if (!message.is_field_type(5, msgpack::type::ARRAY)) {
+            throw protocol_error("invalid ERROR message structure - Arguments must be a list");
+        }
+        args = message.field(5);
+    }
+
+    // ArgumentsKw|list
+    if (message.size() > 6) {
+        if (!message.is_field_type(6, msgpack::type::MAP)) {
+            throw protocol_error("invalid ERROR message structure - ArgumentsKw must be a dictionary");
+        }
+        kw_args = message.field(6);
+    }
+
+    switch (request_type) {
+
+        case message_type::CALL:
+            {
+                //
+                // process CALL ERROR
+                //
+                if (m_calls.find(request_id)) {
+                    wamp_call call = take_call(request_id);
+                    call.result().set_exception(wamp_error(request_type, request_id, error_uri, details, args, kw_args, std::move(message.zone())));
+                } else {
+                    // The call may have been cancelled or timed out locally.
+                    AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                            "ignoring ERROR for non-pending call", request_id);
+                }
+            }
+            break;
+
+        case message_type::PUBLISH:
+            {
+                //
+                // process PUBLISH ERROR
+                //
+                if (m_publications.find(request_id)) {
+                    wamp_publish_request publish_request = m_publications.take(request_id);
+                    release_publications();
+                    --m_pending_publications;
+                    publish_request.response().set_exception(wamp_error(request_type, request_id, error_uri, details, args, kw_args, std::move(message.zone())));
+                } else {
+                    AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                            "ignoring ERROR for non-pending publish", request_id);
+                }
+            }
+            break;
+
+        // FIXME: handle other error messages
+        default:
+            throw protocol_error("unhandled ERROR message");
+            break;
+    }
+}
+
+
+inline void wamp_session::process_invocation(wamp_message&& message)
+{
+    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict]
+    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict, CALL.Arguments|list]
+    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict, CALL.Arguments|list, CALL.ArgumentsKw|dict]
+
+    if (message.size() < 4 || message.size() > 6) {
+        throw protocol_error("INVOCATION message length must be 4, 5 or 6");
+    }
+
+    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("INVOCATION.Request must be an integer");
+    }
+    uint64_t request_id = message.field<uint64_t>(1);
+
+    if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("INVOCATION.Registration must be an integer");
+    }
+    uint64_t registration_id = message.field<uint64_t>(2);
+
+    // Further chunks of a progressive call continue the invocation with the
+    // same request id.
+    if (std::weak_ptr<wamp_invocation_impl>* entry = m_invocations.find(request_id)) {
+        std::shared_ptr<wamp_invocation_impl> invocation = entry->lock();
+        if (!invocation) {
+            // Released before its last chunk, which ends the call.
+            if (!message.is_field_type(3, msgpack::type::MAP)) {
+                throw protocol_error("INVOCATION.Details must be a map");
+            }
+            if (!value_for_key_or<bool>(message.field(3), "progress", false)) {
+                m_invocations.erase(request_id);
+            }
+            AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                    "ignoring chunk for released invocation", request_id);
+            return;
+        }
+        process_invocation_chunk(invocation, std::move(message));
+        return;
+    }
+
+    const wamp_procedure* procedure = m_procedures.find(registration_id);
+    if (procedure) {
+        if (!message.is_field_type(3, msgpack::type::MAP)) {
+            throw protocol_error("INVOCATION.Details must be a map");
+        }
+
+        wamp_invocation invocation = std::make_shared<wamp_invocation_impl>();
+        invocation->set_request_id(request_id);
+        invocation->set_details(message.field(3));
+        if (message.size() > 4) {
+            if (!message.is_field_type(4, msgpack::type::ARRAY)) {
+                throw protocol_error("INVOCATION.Arguments must be an array/vector");
+            }
+            invocation->set_arguments(message.field(4));
+
+            if (message.size() > 5) {
+                if (!message.is_field_type(5, msgpack::type::MAP)) {
+                    throw protocol_error("INVOCATION.KwArguments must be a map");
+                }
+                invocation->set_kw_arguments(message.field(5));
+            }
+        }
+
+        invocation->set_zone(std::move(message.zone()));
+
+        auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+
+        auto send_result_fn = [weak_this, request_id] (const std::shared_ptr<wamp_message>& message) {
+            // Make sure the session still exists, since the invocation could run
+            // on a different thread.
+            auto shared_this = weak_this.lock();
+            if (!shared_this) {
+                return; // FIXME: or throw exception?
+            }
+
+            // Send to the io_service thread, and make sure the session still exists (again).
+            shared_this->m_io_service.dispatch([weak_this, request_id, message] {
+                auto shared_this = weak_this.lock();
+                if (!shared_this) {
+                    return; // FIXME: or throw exception?
+                }
+                if (is_final_answer(*message)) {
+                    shared_this->m_invocations.erase(request_id);
+                }
+                shared_this->send_message(std::move(*message));
+            });
+        };
+
+        // An invocation released without a final answer is removed here,
+        // unless the request id has been taken by a live invocation since.
+        auto release_fn = [weak_this, request_id] () {
+            auto shared_this = weak_this.lock();
+            if (!shared_this) {
+                return;
+            }
+
+            shared_this->m_io_service.post([weak_this, request_id] {
+                auto shared_this = weak_this.lock();
+                if (!shared_this) {
+                    return;
+                }
+                std::weak_ptr<wamp_invocation_impl>* entry =
+                        shared_this->m_invocations.find(request_id);
+                if (entry && entry->expired()) {
+                    shared_this->m_invocations.erase(request_id);
+                }
+            });
+        };
+
+        invocation->set_send_result_fn(std::move(send_result_fn));
+        invocation->set_release_fn(std::move(release_fn));
+        m_invocations.emplace(request_id, invocation);
+
+        // Invocations of pattern-based registrations carry the called URI,
+        // which may be routed to a more specific local procedure.
+        if (!m_procedure_routes.empty() && !invocation->uri().empty()) {
+            if (const wamp_procedure* routed = m_procedure_routes.match(invocation->uri())) {
+                procedure = routed;
+            }
+        }
+
+        AUTOBAHN_LOG(m_logger, log_level::trace, log_event::dispatch, "invoking procedure", registration_id);
+        invoke_procedure(*procedure, invocation);
+    } else {
+        throw protocol_error("bogus INVOCATION message for non-registered registration ID");
+    }
+}
+
+inline void wamp_session::process_invocation_chunk(
+        const std::shared_ptr<wamp_invocation_impl>& invocation, wamp_message&& message)
+{
+    if (!message.is_field_type(3, msgpack::type::MAP)) {
+        throw protocol_error("INVOCATION.Details must be a map");
+    }
+    const bool progress = value_for_key_or<bool>(message.field(3), "progress", false);
+
+    wamp_call_result chunk(std::move(message.zone()));
+    if (message.size() > 4) {
+        if (!message.is_field_type(4, msgpack::type::ARRAY)) {
+            throw protocol_error("INVOCATION.Arguments must be an array/vector");
+        }
+        chunk.set_arguments(message.field(4));
+
+        if (message.size() > 5) {
+            if (!message.is_field_type(5, msgpack::type::MAP)) {
+                throw protocol_error("INVOCATION.KwArguments must be a map");
+            }
+            chunk.set_kw_arguments(message.field(5));
+        }
+    }
+
+    try {
+        invocation->add_chunk(std::move(chunk), !progress);
+    } catch (...) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                "chunk handler threw exception", invocation->get_request_id());
+    }
+}
+
+inline void wamp_session::process_interrupt(wamp_message&& message)
+{
+    // [INTERRUPT, INVOCATION.Request|id, Options|dict]
+
+    if (message.size() != 3) {
+        throw protocol_error("INTERRUPT message length must be 3");
+    }
+
+    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("INTERRUPT.Request must be an integer");
+    }
+    uint64_t request_id = message.field<uint64_t>(1);
+
+    if (!message.is_field_type(2, msgpack::type::MAP)) {
+        throw protocol_error("INTERRUPT.Options must be a map");
+    }
+    std::string mode = value_for_key_or<std::string>(message.field(2), "mode", "kill");
+
+    // The procedure still answers the invocation itself, typically with
+    // wamp.error.canceled, the router takes care of the caller.
+    std::weak_ptr<wamp_invocation_impl>* entry = m_invocations.find(request_id);
+    std::shared_ptr<wamp_invocation_impl> invocation = entry ? entry->lock() : nullptr;
+    if (!invocation) {
+        if (entry) {
+            m_invocations.erase(request_id);
+        }
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                "ignoring INTERRUPT for unknown invocation", request_id);
+        return;
+    }
+
+    try {
+        invocation->interrupt(mode);
+    } catch (const std::exception&) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                "interrupt handler failed", request_id);
+    }
+}
+
+inline bool wamp_session::is_final_answer(const wamp_message& message)
+{
+    // Only a YIELD with progress=true leaves the invocation open.
+    if (message.size() < 3
+            || message.field(0).as<int>() != static_cast<int>(message_type::YIELD)) {
+        return true;
+    }
+
+    try {
+        return !value_for_key_or<bool>(message.field(2), "progress", false);
+    } catch (const std::exception&) {
+        return true;
+    }
+}
+
+inline void wamp_session::send_cancel(uint64_t request_id, wamp_cancel_mode mode)
+{
+    // [CANCEL, CALL.Request|id, Options|dict]
+    std::unordered_map<std::string, std::string> options;
+    options["mode"] = to_string(mode);
+
+    wamp_message message(3);
+    message.set_field(0, static_cast<int>(message_type::CANCEL));
+    message.set_field(1, request_id);
+    message.set_field(2, options);
+
+    try {
+        send_message(std::move(message));
+    } catch (const std::exception&) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch, "failed to send CANCEL", request_id);
+    }
+}
+
+inline wamp_call wamp_session::take_call(uint64_t request_id)
+{
+    if (!m_authorizing_calls.empty()) {
+        m_authorizing_calls.erase(request_id);
+    }
+
+    wamp_call call = m_calls.take(request_id);
+    m_call_timeouts.cancel(call.timer());
+    return call;
+}
+
+inline void wamp_session::schedule_call_timeouts()
+{
+    if (m_call_timer_scheduled || m_call_timeouts.empty()) {
+        return;
+    }
+    m_call_timer_scheduled = true;
+
+    auto weak_self = std::weak_ptr<wamp_session>(this->shared_from_this());
+    m_call_timer.expires_at(std::chrono::steady_clock::now() + m_call_timeouts.resolution());
+    m_call_timer.async_wait([weak_self](const boost::system::error_code& error) {
+        auto shared_self = weak_self.lock();
+        if (!shared_self || error == boost::asio::error::operation_aborted) {
+            return;
+        }
+        shared_self->expire_call_timeouts();
+    });
+}
+
+inline void wamp_session::expire_call_timeouts()
+{
+    m_call_timer_scheduled = false;
+
+    m_call_timeouts.expire(std::chrono::steady_clock::now(), [this](uint64_t request_id) {
+        const wamp_call* pending = m_calls.find(request_id);
+        if (!pending) {
+            return;
+        }
+
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch, "call timed out", request_id);
+
+        // Let the callee stop early, its answer is ignored.
+        std::shared_ptr<wamp_invocation_impl> invocation;
+        if (pending->local()) {
+            invocation = pending->local_invocation().lock();
+        } else if (m_router_call_canceling) {
+            send_cancel(request_id, wamp_cancel_mode::killnowait);
+        }
+
+        wamp_call call = take_call(request_id);
+        call.result().set_exception(timeout_error("call timed out"));
+
+        if (invocation) {
+            interrupt_local_call(request_id, invocation, wamp_cancel_mode::killnowait);
+        }
+    });
+
+    schedule_call_timeouts();
+}
+
+inline void wamp_session::set_local_uri(wamp_register_request& register_request,
+        const std::string& uri, const provide_options& options)
+{
+    auto option = [&](const char* key) {
+        const auto itr = options.find(key);
+        return itr != options.end() && itr->second.type == msgpack::type::STR
+                ? itr->second.as<std::string>() : std::string();
+    };
+
+    const std::string match = option("match");
+    if (match.empty() || match == "exact") {
+        const std::string invoke = option("invoke");
+        register_request.set_local_uri(uri, !invoke.empty() && invoke != "single");
+    }
+}
+
+inline void wamp_session::set_local_uri(wamp_register_request& register_request,
+        const std::string& uri, const wamp_register_options& options)
+{
+    if (options.match() == wamp_match::exact) {
+        register_request.set_local_uri(uri, options.invoke() != wamp_invoke::single);
+    }
+}
+
+inline bool wamp_session::dispatch_local_call(
+        uint64_t request_id, wamp_message& message, wamp_call& call)
+{
+    // [CALL, Request|id, Options|dict, Procedure|uri]
+    // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list]
+    // [CALL, Request|id, Options|dict, Procedure|uri, Arguments|list, ArgumentsKw|dict]
+    if (m_local_calls == wamp_local_calls::disabled || m_local_procedures.empty()) {
+        return false;
+    }
+
+    auto local = m_local_procedures.find(message.field<std::string>(3));
+    if (local == m_local_procedures.end() || (local->second.shared && !m_local_shared_calls)) {
+        return false;
+    }
 
-    // Details
-    if (!message.is_field_type(3, msgpack::type::MAP)) {
-        throw protocol_error("invalid ERROR message structure - Details must be a dictionary");
+    // Progressive calls continue with further CALL messages, which only
+    // the router can match up with the invocation.
+    const msgpack::object& options = message.field(2);
+    if (value_for_key_or<bool>(options, "progress", false)) {
+        return false;
     }
 
-    details = message.field(3);
+    if (m_local_calls == wamp_local_calls::authorized && !local->second.authorized) {
+        m_authorizing_calls.emplace(request_id, local->first);
+        return false;
+    }
 
-    // Error|uri
-    if (!message.is_field_type(4, msgpack::type::STR)) {
-        throw protocol_error("invalid ERROR message - Error must be a string (URI)");
+    const wamp_procedure* procedure = m_procedures.find(local->second.registration_id);
+    if (!procedure) {
+        return false;
     }
-    auto error_uri = std::move(message.field<std::string>(4));
 
-    // Arguments|list
-    if (message.size() > 5) {
-        if (!message.is_field_type(5, msgpack::type::ARRAY)) {
-            throw protocol_error("invalid ERROR message structure - Arguments must be a list");
+    // The call options carry receive_progress just like the details of an
+    // INVOCATION, and the arguments stay in the call's zone.
+    wamp_invocation invocation = std::make_shared<wamp_invocation_impl>();
+    invocation->set_request_id(request_id);
+    invocation->set_details(options);
+    if (message.size() > 4) {
+        invocation->set_arguments(message.field(4));
+        if (message.size() > 5) {
+            invocation->set_kw_arguments(message.field(5));
         }
-        args = message.field(5);
     }
+    invocation->set_zone(std::move(message.zone()));
 
-    // ArgumentsKw|list
-    if (message.size() > 6) {
-        if (!message.is_field_type(6, msgpack::type::MAP)) {
-            throw protocol_error("invalid ERROR message structure - ArgumentsKw must be a dictionary");
+    auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+    invocation->set_send_result_fn([weak_this, request_id](const std::shared_ptr<wamp_message>& message) {
+        auto shared_this = weak_this.lock();
+        if (!shared_this) {
+            return;
         }
-        kw_args = message.field(6);
-    }
 
-    switch (request_type) {
+        shared_this->m_io_service.dispatch([weak_this, request_id, message] {
+            auto shared_this = weak_this.lock();
+            if (shared_this) {
+                shared_this->process_local_answer(request_id, std::move(*message));
+            }
+        });
+    });
 
-        case message_type::CALL:
-            {
-                //
-                // process CALL ERROR
-                //
-                auto call_itr = m_calls.find(request_id);
+    call.set_local_invocation(invocation);
+    track_call(request_id, std::move(call));
 
-                if (call_itr != m_calls.end()) {
-                    call_itr->second->result().set_exception(wamp_error(request_type, request_id, error_uri, details, args, kw_args, std::move(message.zone())));
-                    m_calls.erase(call_itr);
-                } else {
-                    throw protocol_error("bogus ERROR message for non-pending CALL request ID");
-                }
-            }
-            break;
+    AUTOBAHN_LOG(m_logger, log_level::trace, log_event::dispatch,
+            "invoking local procedure", local->second.registration_id);
+    invoke_procedure(*procedure, invocation);
 
-        // FIXME: handle other error messages
-        default:
-            throw protocol_error("unhandled ERROR message");
-            break;
-    }
+    return true;
 }
 
-
-inline void wamp_session::process_invocation(wamp_message&& message)
+inline bool wamp_session::dispatch_local_call(uint64_t, msgpack::sbuffer&, wamp_call&)
 {
-    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict]
-    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict, CALL.Arguments|list]
-    // [INVOCATION, Request|id, REGISTERED.Registration|id, Details|dict, CALL.Arguments|list, CALL.ArgumentsKw|dict]
+    return false;
+}
 
-    if (message.size() < 4 || message.size() > 6) {
-        throw protocol_error("INVOCATION message length must be 4, 5 or 6");
+inline void wamp_session::interrupt_local_call(uint64_t request_id,
+        const std::shared_ptr<wamp_invocation_impl>& invocation, wamp_cancel_mode mode)
+{
+    try {
+        invocation->interrupt(to_string(mode));
+    } catch (const std::exception&) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                "interrupt handler failed", request_id);
     }
+}
 
-    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
-        throw protocol_error("INVOCATION.Request must be an integer");
+inline std::shared_ptr<wamp_result_cache> wamp_session::find_result_cache(
+        const std::string& procedure, const wamp_call_options& options) const
+{
+    // Progressive results and chunked arguments are a conversation with
+    // the callee that a cached result cannot stand in for.
+    if (options.progress() || options.progress_handler()) {
+        return nullptr;
     }
-    uint64_t request_id = message.field<uint64_t>(1);
 
-    if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
-        throw protocol_error("INVOCATION.Registration must be an integer");
-    }
-    uint64_t registration_id = message.field<uint64_t>(2);
+    return result_cache(procedure);
+}
 
-    auto procedure_itr = m_procedures.find(registration_id);
-    if (procedure_itr != m_procedures.end()) {
-        if (!message.is_field_type(3, msgpack::type::MAP)) {
-            throw protocol_error("INVOCATION.Details must be a map");
-        }
+template <typename List>
+inline std::string wamp_session::pack_arguments(const List& arguments)
+{
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack(arguments);
 
-        wamp_invocation invocation = std::make_shared<wamp_invocation_impl>();
-        invocation->set_request_id(request_id);
-        invocation->set_details(message.field(3));
-        if (message.size() > 4) {
-            if (!message.is_field_type(4, msgpack::type::ARRAY)) {
-                throw protocol_error("INVOCATION.Arguments must be an array/vector");
-            }
-            invocation->set_arguments(message.field(4));
+    return std::string(buffer.data(), buffer.size());
+}
 
-            if (message.size() > 5) {
-                if (!message.is_field_type(5, msgpack::type::MAP)) {
-                    throw protocol_error("INVOCATION.KwArguments must be a map");
-                }
-                invocation->set_kw_arguments(message.field(5));
-            }
-        }
+template <typename List, typename Map>
+inline std::string wamp_session::pack_arguments(const List& arguments, const Map& kw_arguments)
+{
+    msgpack::sbuffer buffer;
+    msgpack::packer<msgpack::sbuffer> packer(buffer);
+    packer.pack(arguments);
+    packer.pack(kw_arguments);
 
-        invocation->set_zone(std::move(message.zone()));
+    return std::string(buffer.data(), buffer.size());
+}
 
-        auto weak_this = std::weak_ptr<wamp_session>(this->shared_from_this());
+inline bool wamp_session::find_cached_result(const std::shared_ptr<wamp_result_cache>& cache,
+        const std::string& key, uint64_t& generation, wamp_call_result& result)
+{
+    // Read the generation first, so that a clear() racing with the call
+    // keeps its result out of the cache.
+    generation = cache->generation();
 
-        auto send_result_fn = [weak_this] (const std::shared_ptr<wamp_message>& message) {
-            // Make sure the session still exists, since the invocation could run
-            // on a different thread.
-            auto shared_this = weak_this.lock();
-            if (!shared_this) {
-                return; // FIXME: or throw exception?
-            }
+    return cache->find(key, result);
+}
 
-            // Send to the io_service thread, and make sure the session still exists (again).
-            shared_this->m_io_service.dispatch([weak_this, message] {
-                auto shared_this = weak_this.lock();
-                if (!shared_this) {
-                    return; // FIXME: or throw exception?
-                }
-                shared_this->send_message(std::move(*message));
-            });
-        };
+inline bool wamp_session::answer_from_cache(
+        const std::shared_ptr<wamp_result_cache>& cache, std::string&& key, wamp_call& call)
+{
+    uint64_t generation = 0;
+    wamp_call_result result;
+    if (find_cached_result(cache, key, generation, result)) {
+        call.set_result(std::move(result));
+        return true;
+    }
 
-        invocation->set_send_result_fn(std::move(send_result_fn));
+    call.set_cache(cache, std::move(key), generation);
+    return false;
+}
 
-        try {
-            if (m_debug_enabled) {
-                std::cerr << "Invoking procedure registered under " << registration_id << std::endl;
-            }
-            procedure_itr->second(invocation);
+inline void wamp_session::process_local_answer(uint64_t request_id, wamp_message&& message)
+{
+    // [YIELD, INVOCATION.Request|id, Options|dict, Arguments|list, ArgumentsKw|dict]
+    // [ERROR, INVOCATION, INVOCATION.Request|id, Details|dict, Error|uri, Arguments|list, ArgumentsKw|dict]
+    //
+    // The invocation was given the call's request id, so both only differ
+    // from the RESULT or ERROR the router would send in their type.
+    try {
+        if (message.field(0).as<int>() == static_cast<int>(message_type::YIELD)) {
+            message.set_field(0, static_cast<int>(message_type::RESULT));
+            process_call_result(std::move(message));
+        } else {
+            message.set_field(1, static_cast<int>(message_type::CALL));
+            process_error(std::move(message));
         }
+    } catch (const std::exception&) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                "invalid answer to local call", request_id);
+    }
+}
 
-        // FIXME: implement Autobahn-specific exception with error URI
-        catch (const std::exception& e) {
-            // we can at least describe the error with e.what()
-            //
-            if (invocation->sendable()) {
-                std::map<std::string, std::string> error_kw_arguments;
-                error_kw_arguments["what"] = e.what();
-                invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
-            }
+inline void wamp_session::invoke_procedure(
+        const wamp_procedure& procedure, const wamp_invocation& invocation)
+{
+    try {
+        procedure(invocation);
+    }
+
+    // FIXME: implement Autobahn-specific exception with error URI
+    catch (const std::exception& e) {
+        // we can at least describe the error with e.what()
+        //
+        if (invocation->sendable()) {
+            std::map<std::string, std::string> error_kw_arguments;
+            error_kw_arguments["what"] = e.what();
+            invocation->error("wamp.error.runtime_error", EMPTY_ARGUMENTS, error_kw_arguments);
         }
-        catch (...) {
-            // no information available on actual error
-            //
-            if (invocation->sendable()) {
-                invocation->error("wamp.error.runtime_error");
-            }
+    }
+    catch (...) {
+        // no information available on actual error
+        //
+        if (invocation->sendable()) {
+            invocation->error("wamp.error.runtime_error");
         }
-    } else {
-        throw protocol_error("bogus INVOCATION message for non-registered registration ID");
     }
 }
 
@@ -1135,12 +2868,20 @@ inline void wamp_session::process_call_result(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto call_itr = m_calls.find(request_id);
-    if (call_itr != m_calls.end()) {
+    if (wamp_call* pending = m_calls.find(request_id)) {
         if (!message.is_field_type(2, msgpack::type::MAP)) {
             throw protocol_error("RESULT - Details must be a dictionary");
         }
 
+        // The router let the call through, so later ones may stay local.
+        if (const std::string* uri = m_authorizing_calls.find(request_id)) {
+            auto local = m_local_procedures.find(*uri);
+            if (local != m_local_procedures.end()) {
+                local->second.authorized = true;
+            }
+        }
+        const bool progress = value_for_key_or<bool>(message.field(2), "progress", false);
+
         wamp_call_result result(std::move(message.zone()));
         if (message.size() > 3) {
             if (!message.is_field_type(3, msgpack::type::ARRAY)) {
@@ -1155,11 +2896,71 @@ inline void wamp_session::process_call_result(wamp_message&& message)
                 result.set_kw_arguments(message.field(4));
             }
         }
-        call_itr->second->set_result(std::move(result));
-        m_calls.erase(call_itr);
+
+        // A progressive result leaves the call pending. The handler is
+        // copied as it may issue requests, which can move the call.
+        if (progress) {
+            wamp_progress_handler handler = pending->progress_handler();
+            if (!handler) {
+                AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                        "ignoring unrequested progressive RESULT", request_id);
+                return;
+            }
+
+            try {
+                handler(result);
+            } catch (...) {
+                AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                        "progress handler threw exception", request_id);
+            }
+            return;
+        }
+
+        // Take the call out of the table before completing it as the
+        // continuation may issue further requests.
+        wamp_call call = take_call(request_id);
+        if (call.cache()) {
+            call.cache()->insert(call.cache_key(), result, call.cache_generation());
+        }
+        call.set_result(std::move(result));
     } else {
-        throw protocol_error("bogus RESULT message for non-pending request ID");
+        // The call may have been cancelled or timed out locally.
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                "ignoring RESULT for non-pending call", request_id);
+    }
+}
+
+inline void wamp_session::process_published(wamp_message&& message)
+{
+    // [PUBLISHED, PUBLISH.Request|id, Publication|id]
+    if (message.size() != 3) {
+        throw protocol_error("PUBLISHED - length must be 3");
+    }
+
+    if (!message.is_field_type(1, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("PUBLISHED - PUBLISHED.Request must be an integer");
+    }
+    uint64_t request_id = message.field<uint64_t>(1);
+
+    if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
+        throw protocol_error("PUBLISHED - PUBLISHED.Publication must be an integer");
+    }
+    uint64_t publication_id = message.field<uint64_t>(2);
+
+    if (!m_publications.find(request_id)) {
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                "ignoring PUBLISHED for non-pending publish", request_id);
+        return;
     }
+
+    wamp_publish_request publish_request = m_publications.take(request_id);
+    std::chrono::nanoseconds latency = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - publish_request.sent());
+
+    // Refill the window before completing, whose continuations may block.
+    release_publications();
+    --m_pending_publications;
+    publish_request.response().set_value(wamp_publication(publication_id, latency));
 }
 
 inline void wamp_session::process_subscribed(wamp_message&& message)
@@ -1174,17 +2975,22 @@ inline void wamp_session::process_subscribed(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto subscribe_request_itr = m_subscribe_requests.find(request_id);
-    if (subscribe_request_itr != m_subscribe_requests.end()) {
+    if (m_subscribe_requests.find(request_id)) {
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("SUBSCRIBED - SUBSCRIBED.Subscription must be an integer");
         }
 
         uint64_t subscription_id = message.field<uint64_t>(2);
-        m_subscription_handlers.insert(
-                std::make_pair(subscription_id, subscribe_request_itr->second->handler()));
-        subscribe_request_itr->second->set_response(wamp_subscription(subscription_id));
-        m_subscribe_requests.erase(request_id);
+        wamp_subscribe_request subscribe_request = m_subscribe_requests.take(request_id);
+        if (!subscribe_request.key().empty() && !m_subscription_keys.find(subscription_id)) {
+            m_subscription_keys.emplace(subscription_id, subscribe_request.key());
+            m_subscription_ids[subscribe_request.key()] = subscription_id;
+
+            wamp_match match;
+            const std::string topic = subscription_topic(subscribe_request.key(), match);
+            m_subscription_topics.insert(topic, match, subscription_id);
+        }
+        subscribe_request.set_response(attach_subscriber(subscription_id, subscribe_request));
     } else {
         throw protocol_error("SUBSCRIBED - no pending request ID");
     }
@@ -1201,12 +3007,10 @@ inline void wamp_session::process_unsubscribed(wamp_message&& message)
         throw protocol_error("UNSUBSCRIBED - UNSUBSCRIBED.Request must be an integer");
     }
     uint64_t request_id = message.field<uint64_t>(1);
-    auto unsubscribe_request_itr = m_unsubscribe_requests.find(request_id);
-    if (unsubscribe_request_itr != m_unsubscribe_requests.end()) {
-        uint64_t subscription_id = unsubscribe_request_itr->second->subscription().id();
-        m_subscription_handlers.erase(subscription_id);
-        unsubscribe_request_itr->second->set_response();
-        m_unsubscribe_requests.erase(request_id);
+    if (m_unsubscribe_requests.find(request_id)) {
+        // The handlers were already detached when the request was issued.
+        wamp_unsubscribe_request unsubscribe_request = m_unsubscribe_requests.take(request_id);
+        unsubscribe_request.set_response();
     } else {
         throw protocol_error("UNSUBSCRIBED - no pending request ID");
     }
@@ -1227,16 +3031,14 @@ inline void wamp_session::process_event(wamp_message&& message)
     }
     uint64_t subscription_id = message.field<uint64_t>(1);
 
-    auto subscription_handlers_itr = m_subscription_handlers.lower_bound(subscription_id);
-    auto subscription_handlers_end = m_subscription_handlers.upper_bound(subscription_id);
+    const subscribed_handlers* subscription_handlers = m_subscription_handlers.find(subscription_id);
 
-    if (subscription_handlers_itr != m_subscription_handlers.end() &&
-            subscription_handlers_itr != subscription_handlers_end) {
+    if (subscription_handlers && !subscription_handlers->empty()) {
 
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("EVENT - PUBLISHED.Publication must be an id");
         }
-        //uint64_t publication_id = message[2].as<uint64_t>();
+        uint64_t publication_id = message.field<uint64_t>(2);
 
         if (!message.is_field_type(3, msgpack::type::MAP)) {
             throw protocol_error("EVENT - Details must be a dictionary");
@@ -1260,29 +3062,175 @@ inline void wamp_session::process_event(wamp_message&& message)
             }
         }
 
-        try {
-            // now trigger the user supplied event handler ..
-            //
-            while (subscription_handlers_itr != subscription_handlers_end) {
-                 (subscription_handlers_itr->second)(event);
-                 ++subscription_handlers_itr;
+        // Events of pattern-based subscriptions carry their topic, which
+        // may be routed to more specific local handlers. The routes stand
+        // in for every subscription the publication matched, so its EVENTs
+        // through other subscriptions are dropped.
+        if (!event.uri().empty() && !m_event_routes.empty()) {
+            if (publication_id == m_routed_publication) {
+                return;
             }
-        } catch (...) {
-            if (m_debug_enabled) {
-                std::cerr << "Warning: event handler threw exception" << std::endl;
+            if (route_event(event, subscription_id)) {
+                m_routed_publication = publication_id;
+                return;
             }
         }
 
+        std::shared_ptr<const wamp_event> shared_event;
+        dispatch_event(subscription_id, *subscription_handlers, event, shared_event);
     } else {
         // silently swallow EVENT for non-existent subscription IDs.
         // We may have just unsubscribed, this EVENT might be have
         // already been in-flight.
-        if (m_debug_enabled) {
-            std::cerr << "EVENT - non-existent subscription ID " << subscription_id << std::endl;
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::dispatch,
+                "EVENT for non-existent subscription", subscription_id);
+    }
+}
+
+inline bool wamp_session::route_event(const wamp_event& event, uint64_t subscription_id)
+{
+    if (m_event_routes.empty()) {
+        return false;
+    }
+
+    // A handler that throws must not keep the event from the others.
+    bool routed = false;
+    m_event_routes.for_each_match(event.uri(), [&](wamp_match, const routed_handlers& route) {
+        for (const auto& handler : route) {
+            routed = true;
+            try {
+                handler(event);
+            } catch (...) {
+                AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                        "event handler threw exception", subscription_id);
+            }
+        }
+    });
+
+    return routed;
+}
+
+inline void wamp_session::dispatch_event(
+        uint64_t subscription_id,
+        const subscribed_handlers& handlers,
+        wamp_event& event,
+        std::shared_ptr<const wamp_event>& shared_event)
+{
+    // Handlers running on an executor share the event, it is only moved
+    // to the heap once the first of them is found.
+    const wamp_event* dispatched_event = shared_event ? shared_event.get() : &event;
+
+    try {
+        // now trigger the user supplied event handler ..
+        //
+        for (const auto& subscribed : handlers) {
+            if (!subscribed.executor) {
+                try {
+                    subscribed.handler(*dispatched_event);
+                } catch (...) {
+                    AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                            "event handler threw exception", subscription_id);
+                }
+                continue;
+            }
+
+            if (!shared_event) {
+                shared_event = std::make_shared<wamp_event>(std::move(event));
+                dispatched_event = shared_event.get();
+            }
+
+            const wamp_event_handler& handler = subscribed.handler;
+            std::shared_ptr<const wamp_event> posted_event = shared_event;
+            subscribed.executor->post([handler, posted_event]() {
+                handler(*posted_event);
+            });
+        }
+    } catch (...) {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::dispatch,
+                "failed to post event handler", subscription_id);
+    }
+}
+
+inline void wamp_session::deliver_local_event(wamp_message& message, bool take_zone)
+{
+    // [PUBLISH, Request|id, Options|dict, Topic|uri, Arguments|list]
+    // [PUBLISH, Request|id, Options|dict, Topic|uri, Arguments|list, ArgumentsKw|dict]
+    if (m_subscription_topics.empty()) {
+        return;
+    }
+
+    const std::string topic = message.field<std::string>(3);
+
+    struct local_subscription
+    {
+        uint64_t id;
+        bool pattern;
+    };
+    boost::container::small_vector<local_subscription, 4> subscriptions;
+    m_subscription_topics.for_each_match(topic, [&](wamp_match match, const uint64_t& id) {
+        subscriptions.push_back(local_subscription{id, match != wamp_match::exact});
+    });
+
+    if (subscriptions.empty()) {
+        return;
+    }
+
+    // The event takes the message's zone, or a copy of the arguments if
+    // the message is still to be sent. Either way nothing is serialized.
+    msgpack::zone&& message_zone = message.zone();
+    msgpack::zone copied_zone;
+    msgpack::zone& zone = take_zone ? message_zone : copied_zone;
+
+    std::map<std::string, std::string> details;
+    details["topic"] = topic;
+    msgpack::object details_object(details, zone);
+
+    msgpack::object arguments;
+    msgpack::object kw_arguments;
+    if (message.size() > 4) {
+        arguments = take_zone ? message.field(4) : msgpack::object(message.field(4), zone);
+        if (message.size() > 5) {
+            kw_arguments = take_zone ? message.field(5) : msgpack::object(message.field(5), zone);
+        }
+    }
+
+    wamp_event event(std::move(zone));
+    event.set_details(details_object);
+    if (message.size() > 4) {
+        event.set_arguments(arguments);
+        if (message.size() > 5) {
+            event.set_kw_arguments(kw_arguments);
+        }
+    }
+
+    // Routes stand in for the pattern subscriptions, as for their EVENTs
+    // from the router.
+    bool routed = false;
+    for (const auto& subscription : subscriptions) {
+        if (subscription.pattern) {
+            routed = route_event(event, subscription.id);
+            break;
+        }
+    }
+
+    std::shared_ptr<const wamp_event> shared_event;
+    for (const auto& subscription : subscriptions) {
+        if (subscription.pattern && routed) {
+            continue;
+        }
+
+        const subscribed_handlers* subscription_handlers = m_subscription_handlers.find(subscription.id);
+        if (subscription_handlers) {
+            dispatch_event(subscription.id, *subscription_handlers, event, shared_event);
         }
     }
 }
 
+inline void wamp_session::deliver_local_event(msgpack::sbuffer&, bool)
+{
+    // Publishes with local delivery are always submitted as messages.
+}
+
 inline void wamp_session::process_registered(wamp_message&& message)
 {
     // [REGISTERED, REGISTER.Request|id, Registration|id]
@@ -1296,15 +3244,22 @@ inline void wamp_session::process_registered(wamp_message&& message)
     }
     uint64_t request_id = message.field<uint64_t>(1);
 
-    auto register_request_itr = m_register_requests.find(request_id);
-    if (register_request_itr != m_register_requests.end()) {
+    if (m_register_requests.find(request_id)) {
         if (!message.is_field_type(2, msgpack::type::POSITIVE_INTEGER)) {
             throw protocol_error("REGISTERED - REGISTERED.Registration must be an integer");
         }
         uint64_t registration_id = message.field<uint64_t>(2);
-        m_procedures[registration_id] = register_request_itr->second->procedure();
-        register_request_itr->second->set_response(wamp_registration(registration_id));
-        m_register_requests.erase(register_request_itr);
+        wamp_register_request register_request = m_register_requests.take(request_id);
+        const wamp_procedure& procedure = register_request.procedure();
+        m_procedures.emplace(registration_id) = procedure;
+        if (!register_request.local_uri().empty()) {
+            local_procedure& local = m_local_procedures[register_request.local_uri()];
+            local.registration_id = registration_id;
+            local.shared = register_request.shared();
+            local.authorized = false;
+            m_local_procedure_uris.emplace(registration_id, register_request.local_uri());
+        }
+        register_request.set_response(wamp_registration(registration_id, m_session_id));
     } else {
         throw protocol_error("REGISTERED - no pending request ID");
     }
@@ -1322,12 +3277,15 @@ inline void wamp_session::process_unregistered(wamp_message&& message)
     }
 
     uint64_t request_id = message.field<uint64_t>(1);
-    auto unregister_request_itr = m_unregister_requests.find(request_id);
-    if (unregister_request_itr != m_unregister_requests.end()) {
-        uint64_t registration_id = unregister_request_itr->second->registration().id();
+    if (m_unregister_requests.find(request_id)) {
+        wamp_unregister_request unregister_request = m_unregister_requests.take(request_id);
+        uint64_t registration_id = unregister_request.registration().id();
         m_procedures.erase(registration_id);
-        unregister_request_itr->second->set_response();
-        m_unregister_requests.erase(request_id);
+        if (const std::string* uri = m_local_procedure_uris.find(registration_id)) {
+            m_local_procedures.erase(*uri);
+            m_local_procedure_uris.erase(registration_id);
+        }
+        unregister_request.set_response();
     } else {
         throw protocol_error("UNREGISTERED - no pending request ID");
     }
@@ -1350,4 +3308,87 @@ inline void wamp_session::send_message(wamp_message&& message, bool session_esta
     m_transport->send_message(std::move(message));
 }
 
+inline void wamp_session::send_message(msgpack::sbuffer&& frame)
+{
+    if (!m_running) {
+        throw protocol_error("session not running");
+    }
+
+    if (!m_transport) {
+        throw no_transport_error();
+    }
+
+    if (!m_session_id) {
+        throw no_session_error();
+    }
+
+    m_transport->send_frame(std::move(frame));
+}
+
+inline void wamp_session::send_messages(std::vector<wamp_message>&& messages)
+{
+    if (!m_running) {
+        throw protocol_error("session not running");
+    }
+
+    if (!m_transport) {
+        throw no_transport_error();
+    }
+
+    if (!m_session_id) {
+        throw no_session_error();
+    }
+
+    m_transport->send_messages(std::move(messages));
+}
+
+inline void wamp_session::update_caller_serializer()
+{
+    std::shared_ptr<wamp_serializer> serializer;
+    // Local calls need the call message to dispatch on.
+    if (m_caller_encoding && m_local_calls == wamp_local_calls::disabled
+            && m_running && m_transport) {
+        serializer = m_transport->serializer();
+    }
+
+    std::atomic_store(&m_caller_serializer, serializer);
+}
+
+template <typename T>
+inline boost::future<T> wamp_session::bind_future(boost::promise<T>& promise)
+{
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    if (m_continuation_executor) {
+        promise.set_executor(m_continuation_executor);
+    }
+#endif
+    return promise.get_future();
+}
+
+inline boost::future<void> wamp_session::bind_future(boost::promise<void>& promise)
+{
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    // Only typed promises take an executor, so void futures reach it
+    // through a forwarding continuation. That costs a post, which is only
+    // paid while an executor is set.
+    if (m_continuation_executor) {
+        return promise.get_future().then(*m_continuation_executor, [](boost::future<void> done) {
+            done.get();
+        });
+    }
+#endif
+    return promise.get_future();
+}
+
+template <typename T>
+inline boost::future<T> wamp_session::bind_future(wamp_completion<T>& completion)
+{
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+    if (m_continuation_executor) {
+        completion.set_executor(m_continuation_executor);
+    }
+#endif
+    return completion.get_future();
+}
+
 } // namespace autobahn
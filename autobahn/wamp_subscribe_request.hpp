@@ -31,11 +31,13 @@
 #ifndef AUTOBAHN_WAMP_SUBSCRIBE_REQUEST_HPP
 #define AUTOBAHN_WAMP_SUBSCRIBE_REQUEST_HPP
 
+#include "wamp_completion.hpp"
 #include "wamp_event_handler.hpp"
+#include "wamp_executor.hpp"
 #include "wamp_subscription.hpp"
-#include "boost_config.hpp"
 
-#include <boost/thread/future.hpp>
+#include <memory>
+#include <string>
 
 namespace autobahn {
 
@@ -45,15 +47,30 @@ class wamp_subscribe_request
 public:
     wamp_subscribe_request();
     wamp_subscribe_request(const wamp_event_handler& handler);
+    wamp_subscribe_request(
+            const wamp_event_handler& handler,
+            const std::shared_ptr<wamp_executor>& executor);
+    wamp_subscribe_request(
+            const wamp_event_handler& handler,
+            const std::shared_ptr<wamp_executor>& executor,
+            wamp_completion<wamp_subscription>&& response);
 
     const wamp_event_handler& handler() const;
-    boost::promise<wamp_subscription>& response();
+    const std::shared_ptr<wamp_executor>& executor() const;
+    wamp_completion<wamp_subscription>& response();
     void set_handler(const wamp_event_handler& handler) const;
     void set_response(const wamp_subscription& subscription);
 
+    /// Identifies the router subscription by topic and match policy, so
+    /// that requests for the same one can share it.
+    const std::string& key() const;
+    void set_key(const std::string& key);
+
 private:
+    std::string m_key;
     wamp_event_handler m_handler;
-    boost::promise<wamp_subscription> m_response;
+    std::shared_ptr<wamp_executor> m_executor;
+    wamp_completion<wamp_subscription> m_response;
 };
 
 } // namespace autobahn
@@ -31,23 +31,53 @@
 namespace autobahn {
 
 inline wamp_subscribe_request::wamp_subscribe_request()
-    : m_handler()
+    : m_key()
+    , m_handler()
+    , m_executor()
     , m_response()
 {
 }
 
 inline wamp_subscribe_request::wamp_subscribe_request(const wamp_event_handler& handler)
-    : m_handler(handler)
+    : m_key()
+    , m_handler(handler)
+    , m_executor()
     , m_response()
 {
 }
 
+inline wamp_subscribe_request::wamp_subscribe_request(
+        const wamp_event_handler& handler,
+        const std::shared_ptr<wamp_executor>& executor)
+    : m_key()
+    , m_handler(handler)
+    , m_executor(executor)
+    , m_response()
+{
+}
+
+inline wamp_subscribe_request::wamp_subscribe_request(
+        const wamp_event_handler& handler,
+        const std::shared_ptr<wamp_executor>& executor,
+        wamp_completion<wamp_subscription>&& response)
+    : m_key()
+    , m_handler(handler)
+    , m_executor(executor)
+    , m_response(std::move(response))
+{
+}
+
 inline const wamp_event_handler& wamp_subscribe_request::handler() const
 {
     return m_handler;
 }
 
-inline boost::promise<wamp_subscription>& wamp_subscribe_request::response()
+inline const std::shared_ptr<wamp_executor>& wamp_subscribe_request::executor() const
+{
+    return m_executor;
+}
+
+inline wamp_completion<wamp_subscription>& wamp_subscribe_request::response()
 {
     return m_response;
 }
@@ -57,4 +87,14 @@ inline void wamp_subscribe_request::set_response(const wamp_subscription& subscr
     m_response.set_value(subscription);
 }
 
+inline const std::string& wamp_subscribe_request::key() const
+{
+    return m_key;
+}
+
+inline void wamp_subscribe_request::set_key(const std::string& key)
+{
+    m_key = key;
+}
+
 } // namespace autobahn
@@ -41,10 +41,18 @@ class wamp_subscription
 public:
     wamp_subscription();
     wamp_subscription(uint64_t id);
+    wamp_subscription(uint64_t id, uint64_t handler_id);
+
+    /// The id of the subscription at the router.
     uint64_t id() const;
 
+    /// The id of the local handler among those sharing the router
+    /// subscription, 0 to refer to all of them.
+    uint64_t handler_id() const;
+
 private:
     uint64_t m_id;
+    uint64_t m_handler_id;
 };
 
 } // namespace autobahn
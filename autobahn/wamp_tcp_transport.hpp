@@ -49,7 +49,9 @@ public:
     wamp_tcp_transport(
             boost::asio::io_service& io_service,
             const boost::asio::ip::tcp::endpoint& remote_endpoint,
-            bool debug_enabled=false);
+            bool debug_enabled=false,
+            const std::shared_ptr<wamp_serializer>& serializer =
+                    std::make_shared<wamp_msgpack_serializer>());
     virtual ~wamp_tcp_transport() override;
 
     virtual boost::future<void> connect() override;
@@ -37,9 +37,10 @@ namespace autobahn {
 inline wamp_tcp_transport::wamp_tcp_transport(
         boost::asio::io_service& io_service,
         const boost::asio::ip::tcp::endpoint& remote_endpoint,
-        bool debug_enabled)
+        bool debug_enabled,
+        const std::shared_ptr<wamp_serializer>& serializer)
     : wamp_rawsocket_transport<boost::asio::ip::tcp::socket>(
-            io_service, remote_endpoint, debug_enabled)
+            io_service, remote_endpoint, debug_enabled, serializer)
 {
 }
 
@@ -0,0 +1,153 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_THREAD_POOL_HPP
+#define AUTOBAHN_WAMP_THREAD_POOL_HPP
+
+#include "wamp_executor.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * A fixed size pool of worker threads with work stealing.
+ *
+ * Every worker has its own queue. Tasks posted from a worker go to that
+ * worker's queue, other tasks are spread over the queues round robin. A
+ * worker runs the tasks in its own queue in order and, once that is empty,
+ * steals the most recently queued task from another worker, so a single
+ * long running task only holds up the tasks queued behind it until another
+ * worker becomes idle.
+ *
+ * Tasks still queued when the pool is destroyed are run before its workers
+ * exit.
+ */
+class wamp_thread_pool : public wamp_executor
+{
+public:
+    /*!
+     * Starts a pool.
+     *
+     * @param threads The number of worker threads, at least one.
+     */
+    explicit wamp_thread_pool(std::size_t threads);
+
+    /*!
+     * Runs the remaining tasks and joins the worker threads. Must not be
+     * called from a worker of this pool.
+     */
+    virtual ~wamp_thread_pool() override;
+
+    /*!
+     * @copydoc wamp_executor::post()
+     */
+    virtual void post(task&& task) override;
+
+    /*!
+     * @copydoc wamp_executor::metrics()
+     */
+    virtual wamp_executor_metrics metrics() const override;
+
+    /*!
+     * The number of worker threads.
+     */
+    std::size_t size() const;
+
+    /*!
+     * A pool shared by the whole process with one worker per hardware
+     * thread. It is created on first use.
+     */
+    static std::shared_ptr<wamp_thread_pool> shared();
+
+private:
+    wamp_thread_pool(const wamp_thread_pool&) = delete;
+    wamp_thread_pool& operator=(const wamp_thread_pool&) = delete;
+
+    struct queued_task
+    {
+        task function;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    struct worker
+    {
+        std::mutex mutex;
+        std::deque<queued_task> tasks;
+
+        // Keeps workers that are busy with their own queues off each
+        // other's cache lines.
+        char padding[64];
+    };
+
+    void run(std::size_t index);
+    bool pop(std::size_t index, queued_task& task);
+    void execute(queued_task& task);
+
+    // The pool and worker index of the calling thread, if it is a worker.
+    static wamp_thread_pool*& current_pool();
+    static std::size_t& current_index();
+
+private:
+    std::vector<std::unique_ptr<worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    // Tasks that have been posted but not yet started.
+    std::atomic<std::size_t> m_queued;
+
+    // Round robin position for tasks posted from outside the pool.
+    std::atomic<std::size_t> m_next_worker;
+
+    std::atomic<uint64_t> m_executed;
+    std::atomic<uint64_t> m_failed;
+    std::atomic<uint64_t> m_total_wait;
+    std::atomic<uint64_t> m_max_wait;
+
+    // Idle workers sleep on the condition until tasks are queued.
+    std::mutex m_idle_mutex;
+    std::condition_variable m_idle_condition;
+    std::atomic<std::size_t> m_idle_workers;
+    bool m_stopping;
+};
+
+} // namespace autobahn
+
+#include "wamp_thread_pool.ipp"
+
+#endif // AUTOBAHN_WAMP_THREAD_POOL_HPP
@@ -0,0 +1,218 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_thread_pool::wamp_thread_pool(std::size_t threads)
+    : m_workers()
+    , m_threads()
+    , m_queued(ATOMIC_VAR_INIT(0))
+    , m_next_worker(ATOMIC_VAR_INIT(0))
+    , m_executed(ATOMIC_VAR_INIT(0))
+    , m_failed(ATOMIC_VAR_INIT(0))
+    , m_total_wait(ATOMIC_VAR_INIT(0))
+    , m_max_wait(ATOMIC_VAR_INIT(0))
+    , m_idle_mutex()
+    , m_idle_condition()
+    , m_idle_workers(ATOMIC_VAR_INIT(0))
+    , m_stopping(false)
+{
+    if (threads == 0) {
+        throw std::invalid_argument("thread pool needs at least one thread");
+    }
+
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_workers.emplace_back(new worker());
+    }
+
+    m_threads.reserve(threads);
+    for (std::size_t i = 0; i < threads; ++i) {
+        m_threads.emplace_back(&wamp_thread_pool::run, this, i);
+    }
+}
+
+inline wamp_thread_pool::~wamp_thread_pool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_idle_mutex);
+        m_stopping = true;
+    }
+    m_idle_condition.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+inline void wamp_thread_pool::post(task&& task)
+{
+    queued_task queued;
+    queued.function = std::move(task);
+    queued.queued = std::chrono::steady_clock::now();
+
+    std::size_t index = current_pool() == this
+            ? current_index()
+            : m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_workers[index]->mutex);
+        m_workers[index]->tasks.push_back(std::move(queued));
+    }
+
+    // An idle worker registers itself before checking for queued tasks, so
+    // either it sees this task or we see it and wake it up.
+    m_queued.fetch_add(1);
+    if (m_idle_workers.load() != 0) {
+        std::lock_guard<std::mutex> lock(m_idle_mutex);
+        m_idle_condition.notify_one();
+    }
+}
+
+inline wamp_executor_metrics wamp_thread_pool::metrics() const
+{
+    wamp_executor_metrics metrics;
+    metrics.queue_depth = m_queued.load(std::memory_order_relaxed);
+    metrics.executed = m_executed.load(std::memory_order_relaxed);
+    metrics.failed = m_failed.load(std::memory_order_relaxed);
+    metrics.total_wait = std::chrono::nanoseconds(m_total_wait.load(std::memory_order_relaxed));
+    metrics.max_wait = std::chrono::nanoseconds(m_max_wait.load(std::memory_order_relaxed));
+    return metrics;
+}
+
+inline std::size_t wamp_thread_pool::size() const
+{
+    return m_threads.size();
+}
+
+inline std::shared_ptr<wamp_thread_pool> wamp_thread_pool::shared()
+{
+    static std::shared_ptr<wamp_thread_pool> pool = std::make_shared<wamp_thread_pool>(
+            std::max<std::size_t>(1, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+inline void wamp_thread_pool::run(std::size_t index)
+{
+    current_pool() = this;
+    current_index() = index;
+
+    queued_task task;
+    for (;;) {
+        if (pop(index, task)) {
+            execute(task);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_idle_mutex);
+        if (m_queued.load() != 0) {
+            continue;
+        }
+        if (m_stopping) {
+            break;
+        }
+
+        m_idle_workers.fetch_add(1);
+        m_idle_condition.wait(lock, [this]() {
+            return m_queued.load() != 0 || m_stopping;
+        });
+        m_idle_workers.fetch_sub(1);
+    }
+
+    current_pool() = nullptr;
+}
+
+inline bool wamp_thread_pool::pop(std::size_t index, queued_task& task)
+{
+    {
+        worker& own = *m_workers[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.front());
+            own.tasks.pop_front();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    for (std::size_t i = 1; i < m_workers.size(); ++i) {
+        worker& victim = *m_workers[(index + i) % m_workers.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.back());
+            victim.tasks.pop_back();
+            m_queued.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+inline void wamp_thread_pool::execute(queued_task& task)
+{
+    const uint64_t wait = static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - task.queued).count());
+
+    m_executed.fetch_add(1, std::memory_order_relaxed);
+    m_total_wait.fetch_add(wait, std::memory_order_relaxed);
+    uint64_t max_wait = m_max_wait.load(std::memory_order_relaxed);
+    while (wait > max_wait
+            && !m_max_wait.compare_exchange_weak(max_wait, wait, std::memory_order_relaxed)) {
+    }
+
+    try {
+        task.function();
+    } catch (...) {
+        // A throwing task must not take down its worker. It only shows up
+        // in the metrics.
+        m_failed.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    task.function = nullptr;
+}
+
+inline wamp_thread_pool*& wamp_thread_pool::current_pool()
+{
+    static thread_local wamp_thread_pool* pool = nullptr;
+    return pool;
+}
+
+inline std::size_t& wamp_thread_pool::current_index()
+{
+    static thread_local std::size_t index = 0;
+    return index;
+}
+
+} // namespace autobahn
@@ -0,0 +1,166 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_TIMER_WHEEL_HPP
+#define AUTOBAHN_WAMP_TIMER_WHEEL_HPP
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * A hierarchical timer wheel for deadlines keyed by wamp ids.
+ *
+ * Time is divided into ticks of a fixed resolution. The wheel has four
+ * levels of 256 slots, where a slot of level n covers 256^n ticks; a timer
+ * is placed in the lowest level that reaches its deadline and is cascaded
+ * down a level whenever the level below wraps around. Scheduling and
+ * cancelling a timer are O(1), expiring is O(1) per expired timer plus the
+ * amortized cost of cascading.
+ *
+ * Timers are stored in a pool of nodes which grows to the peak number of
+ * timers and is then reused, so a steady state does not allocate. Deadlines
+ * are rounded up to the next tick, so timers never expire early, but may
+ * expire up to one tick late.
+ *
+ * The wheel is not thread-safe.
+ */
+class wamp_timer_wheel
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    /*!
+     * Identifies a scheduled timer. Zero never identifies a timer, and a
+     * handle remains invalid once its timer has expired or been cancelled,
+     * even if the timer's node is reused.
+     */
+    using handle = uint64_t;
+
+public:
+    /*!
+     * @param resolution The length of a tick.
+     */
+    explicit wamp_timer_wheel(clock::duration resolution);
+
+    /*!
+     * Schedules a timer.
+     *
+     * @param id The id passed to the expiry function when the timer expires.
+     * @param deadline When the timer expires.
+     *
+     * @return The handle to cancel the timer with.
+     */
+    handle schedule(uint64_t id, clock::time_point deadline);
+
+    /*!
+     * Cancels a timer. Does nothing if the timer has already expired or been
+     * cancelled.
+     */
+    void cancel(handle timer);
+
+    /*!
+     * Expires all timers that are due.
+     *
+     * @param now The current time.
+     * @param function Called with the id of each expired timer, after all of
+     *        them have been removed from the wheel. It may schedule and
+     *        cancel timers.
+     */
+    template <typename Function>
+    void expire(clock::time_point now, Function&& function);
+
+    /*!
+     * Removes all timers without expiring them.
+     */
+    void clear();
+
+    std::size_t size() const;
+
+    bool empty() const;
+
+    clock::duration resolution() const;
+
+private:
+    enum : unsigned
+    {
+        LEVELS = 4,
+        SLOT_BITS = 8,
+        SLOTS = 1 << SLOT_BITS
+    };
+
+    // Marks the end of a list and nodes that are not in use.
+    enum : uint32_t
+    {
+        NIL = 0xFFFFFFFF
+    };
+
+    struct node
+    {
+        uint64_t id;
+        uint64_t deadline;
+        uint32_t previous;
+        uint32_t next;
+        uint32_t generation;
+        uint32_t slot;
+    };
+
+    uint64_t to_tick(clock::time_point time, bool round_up) const;
+
+    void insert(uint32_t index);
+    void unlink(uint32_t index);
+    void release(uint32_t index);
+    void cascade(unsigned level);
+    void advance_tick();
+
+private:
+    const clock::duration m_resolution;
+    const clock::time_point m_start;
+
+    // The last tick that has been processed.
+    uint64_t m_current;
+
+    std::vector<uint32_t> m_slots;
+    std::vector<node> m_nodes;
+    uint32_t m_free;
+    std::size_t m_size;
+
+    // Ids of timers expired by the current call to expire().
+    std::vector<uint64_t> m_expired;
+};
+
+} // namespace autobahn
+
+#include "wamp_timer_wheel.ipp"
+
+#endif // AUTOBAHN_WAMP_TIMER_WHEEL_HPP
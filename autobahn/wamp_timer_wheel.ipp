@@ -0,0 +1,262 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <utility>
+
+namespace autobahn {
+
+inline wamp_timer_wheel::wamp_timer_wheel(clock::duration resolution)
+    : m_resolution(resolution)
+    , m_start(clock::now())
+    , m_current(0)
+    , m_slots(LEVELS * SLOTS, NIL)
+    , m_nodes()
+    , m_free(NIL)
+    , m_size(0)
+    , m_expired()
+{
+}
+
+inline wamp_timer_wheel::handle wamp_timer_wheel::schedule(uint64_t id, clock::time_point deadline)
+{
+    uint64_t tick = to_tick(deadline, true);
+    if (tick <= m_current) {
+        tick = m_current + 1;
+    }
+
+    uint32_t index = m_free;
+    if (index != NIL) {
+        m_free = m_nodes[index].next;
+    } else {
+        index = static_cast<uint32_t>(m_nodes.size());
+        node fresh;
+        fresh.generation = 1;
+        m_nodes.push_back(fresh);
+    }
+
+    node& timer = m_nodes[index];
+    timer.id = id;
+    timer.deadline = tick;
+    insert(index);
+    ++m_size;
+
+    return (static_cast<uint64_t>(timer.generation) << 32) | index;
+}
+
+inline void wamp_timer_wheel::cancel(handle timer)
+{
+    const uint32_t index = static_cast<uint32_t>(timer & 0xFFFFFFFF);
+    const uint32_t generation = static_cast<uint32_t>(timer >> 32);
+
+    if (index >= m_nodes.size()) {
+        return;
+    }
+
+    const node& cancelled = m_nodes[index];
+    if (cancelled.generation != generation || cancelled.slot == NIL) {
+        return;
+    }
+
+    unlink(index);
+    release(index);
+}
+
+template <typename Function>
+void wamp_timer_wheel::expire(clock::time_point now, Function&& function)
+{
+    const uint64_t target = to_tick(now, false);
+
+    if (m_size == 0) {
+        if (target > m_current) {
+            m_current = target;
+        }
+        return;
+    }
+
+    m_expired.clear();
+    while (m_current < target) {
+        advance_tick();
+    }
+
+    if (m_expired.empty()) {
+        return;
+    }
+
+    // The function may use the wheel, so work on a list of our own.
+    std::vector<uint64_t> expired;
+    expired.swap(m_expired);
+    for (uint64_t id : expired) {
+        function(id);
+    }
+
+    if (m_expired.empty()) {
+        expired.clear();
+        m_expired.swap(expired);
+    }
+}
+
+inline void wamp_timer_wheel::clear()
+{
+    for (uint32_t index = 0; index < m_nodes.size(); ++index) {
+        if (m_nodes[index].slot != NIL) {
+            release(index);
+        }
+    }
+
+    for (auto& slot : m_slots) {
+        slot = NIL;
+    }
+}
+
+inline std::size_t wamp_timer_wheel::size() const
+{
+    return m_size;
+}
+
+inline bool wamp_timer_wheel::empty() const
+{
+    return m_size == 0;
+}
+
+inline wamp_timer_wheel::clock::duration wamp_timer_wheel::resolution() const
+{
+    return m_resolution;
+}
+
+inline uint64_t wamp_timer_wheel::to_tick(clock::time_point time, bool round_up) const
+{
+    if (time <= m_start) {
+        return 0;
+    }
+
+    const clock::duration elapsed = time - m_start;
+    uint64_t tick = static_cast<uint64_t>(elapsed / m_resolution);
+    if (round_up && elapsed % m_resolution != clock::duration::zero()) {
+        ++tick;
+    }
+
+    return tick;
+}
+
+inline void wamp_timer_wheel::insert(uint32_t index)
+{
+    node& timer = m_nodes[index];
+    const uint64_t delta = timer.deadline - m_current;
+
+    // Timers beyond the range of the top level are parked in it and moved
+    // again every time their slot is cascaded.
+    unsigned level = 0;
+    while (level < LEVELS - 1 && delta >= (UINT64_C(1) << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+
+    const uint32_t slot = level * SLOTS
+            + static_cast<uint32_t>((timer.deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    timer.slot = slot;
+    timer.previous = NIL;
+    timer.next = m_slots[slot];
+    if (timer.next != NIL) {
+        m_nodes[timer.next].previous = index;
+    }
+    m_slots[slot] = index;
+}
+
+inline void wamp_timer_wheel::unlink(uint32_t index)
+{
+    const node& timer = m_nodes[index];
+
+    if (timer.previous != NIL) {
+        m_nodes[timer.previous].next = timer.next;
+    } else {
+        m_slots[timer.slot] = timer.next;
+    }
+
+    if (timer.next != NIL) {
+        m_nodes[timer.next].previous = timer.previous;
+    }
+}
+
+inline void wamp_timer_wheel::release(uint32_t index)
+{
+    node& timer = m_nodes[index];
+
+    // Invalidate outstanding handles, skipping the generation of handle 0.
+    if (++timer.generation == 0) {
+        timer.generation = 1;
+    }
+
+    timer.slot = NIL;
+    timer.next = m_free;
+    m_free = index;
+    --m_size;
+}
+
+inline void wamp_timer_wheel::cascade(unsigned level)
+{
+    const uint32_t slot = level * SLOTS
+            + static_cast<uint32_t>((m_current >> (SLOT_BITS * level)) & (SLOTS - 1));
+
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = NIL;
+
+    while (index != NIL) {
+        const uint32_t next = m_nodes[index].next;
+        insert(index);
+        index = next;
+    }
+}
+
+inline void wamp_timer_wheel::advance_tick()
+{
+    ++m_current;
+
+    // Whenever a level wraps around, move the timers of the next level's
+    // current slot down.
+    for (unsigned level = 1; level < LEVELS; ++level) {
+        if (((m_current >> (SLOT_BITS * (level - 1))) & (SLOTS - 1)) != 0) {
+            break;
+        }
+        cascade(level);
+    }
+
+    const uint32_t slot = static_cast<uint32_t>(m_current & (SLOTS - 1));
+    uint32_t index = m_slots[slot];
+    m_slots[slot] = NIL;
+
+    while (index != NIL) {
+        const uint32_t next = m_nodes[index].next;
+        m_expired.push_back(m_nodes[index].id);
+        release(index);
+        index = next;
+    }
+}
+
+} // namespace autobahn
@@ -32,14 +32,18 @@
 #define AUTOBAHN_WAMP_TRANSPORT_HPP
 
 #include "boost_config.hpp"
+#include "wamp_message.hpp"
 
 #include <boost/thread/future.hpp>
 #include <memory>
+#include <msgpack.hpp>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace autobahn {
 
-class wamp_message;
+class wamp_serializer;
 class wamp_transport_handler;
 
 /*!
@@ -102,6 +106,43 @@ public:
      */
     virtual void send_message(wamp_message&& message) = 0;
 
+    /*!
+     * Send several messages synchronously over the transport, in order.
+     * Transports that can should coalesce them into a single write.
+     *
+     * @param messages The messages to be sent.
+     */
+    virtual void send_messages(std::vector<wamp_message>&& messages)
+    {
+        for (auto& message : messages) {
+            send_message(std::move(message));
+        }
+    }
+
+    /*!
+     * The serializer the transport encodes messages with. Once the transport
+     * is connected the serializer does not change, so messages may be
+     * encoded with it on any thread and sent later with send_frame().
+     *
+     * @return The serializer, or nullptr if the transport does not support
+     *         sending pre-encoded frames.
+     */
+    virtual std::shared_ptr<wamp_serializer> serializer() const
+    {
+        return nullptr;
+    }
+
+    /*!
+     * Send a message that has already been encoded with serializer()
+     * synchronously over the transport.
+     *
+     * @param frame The encoded message to be sent.
+     */
+    virtual void send_frame(msgpack::sbuffer&& frame)
+    {
+        throw std::logic_error("transport does not support pre-encoded frames");
+    }
+
     /*!
      * Set the handler to be invoked when the transport detects congestion
      * sending to the remote peer and needs to apply backpressure on the
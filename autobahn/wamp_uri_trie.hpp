@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_WAMP_URI_TRIE_HPP
+#define AUTOBAHN_WAMP_URI_TRIE_HPP
+
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autobahn {
+
+/*!
+ * How a registration or subscription URI is matched against the URIs of
+ * calls and events.
+ */
+enum class wamp_match
+{
+    /*!
+     * The URI has to be equal.
+     */
+    exact,
+
+    /*!
+     * The URI has to start with the pattern, e.g. "com.example" matches
+     * "com.example.add" and "com.example-low".
+     */
+    prefix,
+
+    /*!
+     * Empty components of the pattern match any one component of the URI,
+     * e.g. "com..add" matches "com.example.add".
+     */
+    wildcard
+};
+
+/*!
+ * The name of a match policy as sent in REGISTER and SUBSCRIBE options.
+ */
+const char* to_string(wamp_match match);
+
+/*!
+ * Maps URI patterns to values and looks up the patterns matching a URI.
+ *
+ * The patterns are stored in a trie of URI characters, with a dedicated
+ * edge for the wildcard components of wildcard patterns. Looking up a URI
+ * walks the trie once, so it takes time linear in the length of the URI
+ * regardless of the number of patterns. Only wildcard patterns branch, at
+ * the start of each component.
+ *
+ * Not thread-safe.
+ *
+ * @tparam T The value type, which must be copy constructible.
+ */
+template <typename T>
+class wamp_uri_trie
+{
+public:
+    wamp_uri_trie();
+    wamp_uri_trie(wamp_uri_trie&& other);
+    wamp_uri_trie& operator=(wamp_uri_trie&& other);
+
+    /*!
+     * Stores a value under a pattern, replacing any value stored under the
+     * same pattern and match policy.
+     *
+     * @return The stored value.
+     */
+    T& insert(const std::string& pattern, wamp_match match, const T& value);
+
+    /*!
+     * Erases the value stored under a pattern.
+     *
+     * @return Whether or not a value was erased.
+     */
+    bool erase(const std::string& pattern, wamp_match match);
+
+    /*!
+     * Looks up the value stored under a pattern itself.
+     *
+     * @return The value, or nullptr if there is none.
+     */
+    const T* find(const std::string& pattern, wamp_match match) const;
+
+    /*!
+     * Looks up the value of the pattern that best matches a URI, following
+     * the precedence used by routers for registrations: an exact match wins
+     * over the longest prefix match, which wins over a wildcard match. Of
+     * several wildcard matches, the one whose first wildcard comes latest
+     * wins.
+     *
+     * @return The value, or nullptr if no pattern matches.
+     */
+    const T* match(const std::string& uri) const;
+
+    /*!
+     * Calls the function with the match policy and value of every pattern
+     * that matches a URI, e.g. to deliver an event to all subscriptions.
+     */
+    template <typename Function>
+    void for_each_match(const std::string& uri, Function&& function) const;
+
+    void clear();
+
+    std::size_t size() const;
+
+    bool empty() const;
+
+private:
+    wamp_uri_trie(const wamp_uri_trie&) = delete;
+    wamp_uri_trie& operator=(const wamp_uri_trie&) = delete;
+
+    // The edge standing for one whole component of a wildcard pattern. URIs
+    // never contain it.
+    enum : char { WILDCARD = '\0' };
+
+    struct node
+    {
+        node* child(char edge) const;
+        node& add_child(char edge);
+        void remove_child(char edge);
+        bool unused() const;
+
+        // Children sorted by their edge.
+        std::vector<std::pair<char, std::unique_ptr<node>>> children;
+
+        // The values of the patterns ending here, by match policy.
+        boost::optional<T> values[3];
+    };
+
+    // The edges spelling out a pattern.
+    static std::string edges(const std::string& pattern, wamp_match match);
+
+    const T* match_wildcard(const node& current, const std::string& uri, std::size_t position) const;
+
+    template <typename Function>
+    void for_each_wildcard(const node& current, const std::string& uri, std::size_t position,
+            Function& function) const;
+
+private:
+    std::unique_ptr<node> m_root;
+    std::size_t m_size;
+};
+
+} // namespace autobahn
+
+#include "wamp_uri_trie.ipp"
+
+#endif // AUTOBAHN_WAMP_URI_TRIE_HPP
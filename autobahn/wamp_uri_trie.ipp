@@ -0,0 +1,332 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+
+namespace autobahn {
+
+inline const char* to_string(wamp_match match)
+{
+    switch (match) {
+        case wamp_match::prefix:
+            return "prefix";
+        case wamp_match::wildcard:
+            return "wildcard";
+        case wamp_match::exact:
+        default:
+            return "exact";
+    }
+}
+
+template <typename T>
+wamp_uri_trie<T>::wamp_uri_trie()
+    : m_root(new node())
+    , m_size(0)
+{
+}
+
+template <typename T>
+wamp_uri_trie<T>::wamp_uri_trie(wamp_uri_trie&& other)
+    : m_root(new node())
+    , m_size(0)
+{
+    m_root.swap(other.m_root);
+    std::swap(m_size, other.m_size);
+}
+
+template <typename T>
+wamp_uri_trie<T>& wamp_uri_trie<T>::operator=(wamp_uri_trie&& other)
+{
+    if (this != &other) {
+        clear();
+        m_root.swap(other.m_root);
+        std::swap(m_size, other.m_size);
+    }
+    return *this;
+}
+
+template <typename T>
+T& wamp_uri_trie<T>::insert(const std::string& pattern, wamp_match match, const T& value)
+{
+    node* current = m_root.get();
+    for (char edge : edges(pattern, match)) {
+        current = &current->add_child(edge);
+    }
+
+    boost::optional<T>& slot = current->values[static_cast<int>(match)];
+    if (!slot) {
+        ++m_size;
+    }
+    slot = value;
+
+    return *slot;
+}
+
+template <typename T>
+bool wamp_uri_trie<T>::erase(const std::string& pattern, wamp_match match)
+{
+    const std::string path = edges(pattern, match);
+
+    std::vector<node*> visited;
+    visited.reserve(path.size() + 1);
+    visited.push_back(m_root.get());
+    for (char edge : path) {
+        node* next = visited.back()->child(edge);
+        if (!next) {
+            return false;
+        }
+        visited.push_back(next);
+    }
+
+    boost::optional<T>& slot = visited.back()->values[static_cast<int>(match)];
+    if (!slot) {
+        return false;
+    }
+    slot = boost::none;
+    --m_size;
+
+    // Prune the nodes that no longer lead to any pattern.
+    for (std::size_t depth = path.size(); depth > 0 && visited[depth]->unused(); --depth) {
+        visited[depth - 1]->remove_child(path[depth - 1]);
+    }
+
+    return true;
+}
+
+template <typename T>
+const T* wamp_uri_trie<T>::find(const std::string& pattern, wamp_match match) const
+{
+    const node* current = m_root.get();
+    for (char edge : edges(pattern, match)) {
+        current = current->child(edge);
+        if (!current) {
+            return nullptr;
+        }
+    }
+
+    const boost::optional<T>& slot = current->values[static_cast<int>(match)];
+    return slot ? &*slot : nullptr;
+}
+
+template <typename T>
+const T* wamp_uri_trie<T>::match(const std::string& uri) const
+{
+    const T* longest_prefix = nullptr;
+
+    const node* current = m_root.get();
+    for (std::size_t position = 0; current; ++position) {
+        const boost::optional<T>& prefix = current->values[static_cast<int>(wamp_match::prefix)];
+        if (prefix) {
+            longest_prefix = &*prefix;
+        }
+
+        if (position == uri.size()) {
+            const boost::optional<T>& exact = current->values[static_cast<int>(wamp_match::exact)];
+            if (exact) {
+                return &*exact;
+            }
+            break;
+        }
+
+        current = current->child(uri[position]);
+    }
+
+    if (longest_prefix) {
+        return longest_prefix;
+    }
+
+    return match_wildcard(*m_root, uri, 0);
+}
+
+template <typename T>
+template <typename Function>
+void wamp_uri_trie<T>::for_each_match(const std::string& uri, Function&& function) const
+{
+    const node* current = m_root.get();
+    for (std::size_t position = 0; current; ++position) {
+        const boost::optional<T>& prefix = current->values[static_cast<int>(wamp_match::prefix)];
+        if (prefix) {
+            function(wamp_match::prefix, *prefix);
+        }
+
+        if (position == uri.size()) {
+            const boost::optional<T>& exact = current->values[static_cast<int>(wamp_match::exact)];
+            if (exact) {
+                function(wamp_match::exact, *exact);
+            }
+            break;
+        }
+
+        current = current->child(uri[position]);
+    }
+
+    for_each_wildcard(*m_root, uri, 0, function);
+}
+
+template <typename T>
+void wamp_uri_trie<T>::clear()
+{
+    m_root.reset(new node());
+    m_size = 0;
+}
+
+template <typename T>
+std::size_t wamp_uri_trie<T>::size() const
+{
+    return m_size;
+}
+
+template <typename T>
+bool wamp_uri_trie<T>::empty() const
+{
+    return m_size == 0;
+}
+
+template <typename T>
+typename wamp_uri_trie<T>::node* wamp_uri_trie<T>::node::child(char edge) const
+{
+    auto itr = std::lower_bound(children.begin(), children.end(), edge,
+            [](const std::pair<char, std::unique_ptr<node>>& entry, char key) {
+                return entry.first < key;
+            });
+    return itr != children.end() && itr->first == edge ? itr->second.get() : nullptr;
+}
+
+template <typename T>
+typename wamp_uri_trie<T>::node& wamp_uri_trie<T>::node::add_child(char edge)
+{
+    auto itr = std::lower_bound(children.begin(), children.end(), edge,
+            [](const std::pair<char, std::unique_ptr<node>>& entry, char key) {
+                return entry.first < key;
+            });
+    if (itr == children.end() || itr->first != edge) {
+        itr = children.emplace(itr, edge, std::unique_ptr<node>(new node()));
+    }
+    return *itr->second;
+}
+
+template <typename T>
+void wamp_uri_trie<T>::node::remove_child(char edge)
+{
+    auto itr = std::lower_bound(children.begin(), children.end(), edge,
+            [](const std::pair<char, std::unique_ptr<node>>& entry, char key) {
+                return entry.first < key;
+            });
+    if (itr != children.end() && itr->first == edge) {
+        children.erase(itr);
+    }
+}
+
+template <typename T>
+bool wamp_uri_trie<T>::node::unused() const
+{
+    return children.empty() && !values[0] && !values[1] && !values[2];
+}
+
+template <typename T>
+std::string wamp_uri_trie<T>::edges(const std::string& pattern, wamp_match match)
+{
+    if (match != wamp_match::wildcard) {
+        return pattern;
+    }
+
+    // Replace every empty component with a single wildcard edge.
+    std::string path;
+    path.reserve(pattern.size() + 1);
+    bool component_start = true;
+    for (char character : pattern) {
+        if (character == '.' && component_start) {
+            path += static_cast<char>(WILDCARD);
+        }
+        path += character;
+        component_start = character == '.';
+    }
+    if (component_start) {
+        path += static_cast<char>(WILDCARD);
+    }
+
+    return path;
+}
+
+template <typename T>
+const T* wamp_uri_trie<T>::match_wildcard(
+        const node& current, const std::string& uri, std::size_t position) const
+{
+    if (position == uri.size()) {
+        const boost::optional<T>& wildcard = current.values[static_cast<int>(wamp_match::wildcard)];
+        return wildcard ? &*wildcard : nullptr;
+    }
+
+    // Literal components are more specific, so try them first.
+    if (const node* next = current.child(uri[position])) {
+        if (const T* value = match_wildcard(*next, uri, position + 1)) {
+            return value;
+        }
+    }
+
+    const bool component_start = position == 0 || uri[position - 1] == '.';
+    if (component_start && uri[position] != '.') {
+        if (const node* next = current.child(WILDCARD)) {
+            std::size_t end = uri.find('.', position);
+            return match_wildcard(*next, uri, end == std::string::npos ? uri.size() : end);
+        }
+    }
+
+    return nullptr;
+}
+
+template <typename T>
+template <typename Function>
+void wamp_uri_trie<T>::for_each_wildcard(
+        const node& current, const std::string& uri, std::size_t position, Function& function) const
+{
+    if (position == uri.size()) {
+        const boost::optional<T>& wildcard = current.values[static_cast<int>(wamp_match::wildcard)];
+        if (wildcard) {
+            function(wamp_match::wildcard, *wildcard);
+        }
+        return;
+    }
+
+    if (const node* next = current.child(uri[position])) {
+        for_each_wildcard(*next, uri, position + 1, function);
+    }
+
+    const bool component_start = position == 0 || uri[position - 1] == '.';
+    if (component_start && uri[position] != '.') {
+        if (const node* next = current.child(WILDCARD)) {
+            std::size_t end = uri.find('.', position);
+            for_each_wildcard(*next, uri, end == std::string::npos ? uri.size() : end, function);
+        }
+    }
+}
+
+} // namespace autobahn
@@ -32,13 +32,17 @@
 #define AUTOBAHN_WEBSOCKET_TRANSPORT_HPP
 
 #include "boost_config.hpp"
+#include "wamp_logger.hpp"
+#include "wamp_msgpack_serializer.hpp"
+#include "wamp_serializer.hpp"
 #include "wamp_transport.hpp"
 
 #include <boost/thread/future.hpp>
 #include <boost/asio/io_service.hpp>
 #include <cstddef>
 #include <memory>
-#include <msgpack.hpp>
+#include <string>
+#include <vector>
 
 namespace autobahn {
 
@@ -60,10 +64,16 @@ namespace autobahn {
         * Constructs a websocket transport.
         *
         * @param uri The remote endpoint to connect to.
+        * @param debug_enabled Whether or not to log every message at debug level.
+        * @param serializers The serializers to offer as websocket subprotocols,
+        *        in order of preference. The router picks one per connection.
         */
         wamp_websocket_transport(
             const std::string& uri,
-            bool debug_enabled = false);
+            bool debug_enabled = false,
+            const std::vector<std::shared_ptr<wamp_serializer>>& serializers =
+                    std::vector<std::shared_ptr<wamp_serializer>>{
+                            std::make_shared<wamp_msgpack_serializer>()});
 
         virtual ~wamp_websocket_transport() override = default;
 
@@ -94,6 +104,16 @@ namespace autobahn {
         */
         virtual void send_message(wamp_message&& message) override;
 
+        /*!
+        * @copydoc wamp_transport::serializer()
+        */
+        virtual std::shared_ptr<wamp_serializer> serializer() const override;
+
+        /*!
+        * @copydoc wamp_transport::send_frame()
+        */
+        virtual void send_frame(msgpack::sbuffer&& frame) override;
+
         /*!
         * @copydoc wamp_transport::set_pause_handler()
         */
@@ -148,6 +168,25 @@ namespace autobahn {
 
         void receive_message(const std::string& msg);
 
+        /*!
+        * The logger used by the transport. Its level and sink may be changed
+        * before connecting.
+        */
+        wamp_logger& logger();
+
+        /*!
+        * The serializers offered when connecting, in order of preference.
+        */
+        const std::vector<std::shared_ptr<wamp_serializer>>& serializers() const;
+
+        /*!
+        * Selects the serializer matching the subprotocol chosen by the router.
+        *
+        * @param subprotocol The negotiated websocket subprotocol.
+        * @return Whether or not a matching serializer was offered.
+        */
+        bool select_serializer(const std::string& subprotocol);
+
         /*!
         * The promise that is fulfilled when the connect attempt is complete.
         */
@@ -180,14 +219,19 @@ namespace autobahn {
             std::shared_ptr<wamp_transport_handler> m_handler;
 
             /*!
-            * Used for unpacking serialized messages.
+            * The serializers offered when connecting.
+            */
+            std::vector<std::shared_ptr<wamp_serializer>> m_serializers;
+
+            /*!
+            * The serializer negotiated for the current connection.
             */
-            msgpack::unpacker m_message_unpacker;
+            std::shared_ptr<wamp_serializer> m_serializer;
 
             /*!
-            * Whether or not debugging is enabled.
+            * The logger for transport events and message summaries.
             */
-            bool m_debug_enabled;
+            wamp_logger m_logger;
             
             /*!
             * Websocket endpoint URI
@@ -36,20 +36,27 @@
 #include <boost/asio/placeholders.hpp>
 #include <boost/asio/read.hpp>
 #include <boost/asio/write.hpp>
+#include <stdexcept>
 #include <system_error>
 
 namespace autobahn {
 
 inline wamp_websocket_transport::wamp_websocket_transport(
     const std::string& uri,
-    bool debug_enabled)
+    bool debug_enabled,
+    const std::vector<std::shared_ptr<wamp_serializer>>& serializers)
     : wamp_transport()
     , m_connect()
     , m_disconnect()
-    , m_message_unpacker()
-    , m_debug_enabled(debug_enabled)
+    , m_serializers(serializers)
+    , m_serializer()
+    , m_logger(debug_enabled ? log_level::trace : log_level::warning)
     , m_uri(uri)
 {
+    if (m_serializers.empty()) {
+        throw std::invalid_argument("at least one serializer is required");
+    }
+    m_serializer = m_serializers.front();
 }
 
 inline boost::future<void> wamp_websocket_transport::connect()
@@ -83,18 +90,26 @@ inline bool wamp_websocket_transport::is_connected() const
 
 inline void wamp_websocket_transport::send_message(wamp_message&& message)
 {
-    auto buffer = std::make_shared<msgpack::sbuffer>();
-    msgpack::packer<msgpack::sbuffer> packer(*buffer);
-    packer.pack(message.fields());
+    msgpack::sbuffer buffer;
+    m_serializer->serialize(message, buffer);
 
-   
     // Write actual serialized message.
-    write(buffer->data(), buffer->size());
+    write(buffer.data(), buffer.size());
 
-    if (m_debug_enabled) {
-        std::cerr << "TX message (" << buffer->size() << " octets) ..." << std::endl;
-        std::cerr << "TX message: " << message << std::endl;
-    }
+    AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_sent, message, buffer.size());
+}
+
+inline std::shared_ptr<wamp_serializer> wamp_websocket_transport::serializer() const
+{
+    return m_serializer;
+}
+
+inline void wamp_websocket_transport::send_frame(msgpack::sbuffer&& frame)
+{
+    write(frame.data(), frame.size());
+
+    AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_sent,
+            "TX pre-encoded frame", 0, frame.size());
 }
 
 inline void wamp_websocket_transport::set_pause_handler(pause_handler&& handler)
@@ -151,32 +166,38 @@ inline bool wamp_websocket_transport::has_handler() const
 
 inline void wamp_websocket_transport::receive_message(const std::string& msg)
 {
-    if (m_debug_enabled) {
-        std::cerr << "RX message received." << std::endl;
-    }
-
     if (m_handler) {
-        m_message_unpacker.reserve_buffer(msg.size());
-        memcpy(m_message_unpacker.buffer(), msg.data(), msg.size());
-        m_message_unpacker.buffer_consumed(msg.size());
+        wamp_message message = m_serializer->deserialize(msg.data(), msg.size());
+        AUTOBAHN_LOG(m_logger, log_level::debug, log_event::message_received, message, msg.size());
 
-        msgpack::unpacked result;
+        m_handler->on_message(std::move(message));
+    }
+    else {
+        AUTOBAHN_LOG(m_logger, log_level::warning, log_event::message_received,
+                "RX message ignored: no handler attached", 0, msg.size());
+    }
+}
 
-        while (m_message_unpacker.next(&result)) {
-            wamp_message::message_fields fields;
-            result.get().convert(fields);
+inline wamp_logger& wamp_websocket_transport::logger()
+{
+    return m_logger;
+}
 
-            wamp_message message(std::move(fields), std::move(*(result.zone())));
-            if (m_debug_enabled) {
-                std::cerr << "RX message: " << message << std::endl;
-            }
+inline const std::vector<std::shared_ptr<wamp_serializer>>& wamp_websocket_transport::serializers() const
+{
+    return m_serializers;
+}
 
-            m_handler->on_message(std::move(message));
+inline bool wamp_websocket_transport::select_serializer(const std::string& subprotocol)
+{
+    for (const auto& serializer : m_serializers) {
+        if (serializer->websocket_subprotocol() == subprotocol) {
+            m_serializer = serializer;
+            return true;
         }
     }
-    else {
-        std::cerr << "RX message ignored: no handler attached" << std::endl;
-    }
+
+    return false;
 }
 
 } //namespace autobahn
\ No newline at end of file
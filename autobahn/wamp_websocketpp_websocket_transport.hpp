@@ -66,7 +66,10 @@ namespace autobahn {
         wamp_websocketpp_websocket_transport(
             client_type& client,
             const std::string& uri,
-            bool debug_enabled = false);
+            bool debug_enabled = false,
+            const std::vector<std::shared_ptr<wamp_serializer>>& serializers =
+                    std::vector<std::shared_ptr<wamp_serializer>>{
+                            std::make_shared<wamp_msgpack_serializer>()});
 
         virtual ~wamp_websocketpp_websocket_transport() override;
 
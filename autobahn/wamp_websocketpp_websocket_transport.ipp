@@ -28,6 +28,7 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include "exceptions.hpp"
 #include "wamp_websocket_transport.hpp"
 
 #include <boost/system/error_code.hpp>
@@ -39,8 +40,9 @@ namespace autobahn {
     inline wamp_websocketpp_websocket_transport<Config>::wamp_websocketpp_websocket_transport(
         client_type& client,
         const std::string& uri,
-        bool debug_enabled)
-        : wamp_websocket_transport(uri, debug_enabled)
+        bool debug_enabled,
+        const std::vector<std::shared_ptr<wamp_serializer>>& serializers)
+        : wamp_websocket_transport(uri, debug_enabled, serializers)
         , m_client(client)
         , m_hdl()
         , m_open(false)
@@ -69,11 +71,19 @@ namespace autobahn {
 
     // The open handler will signal that we are ready to start sending telemetry
     template <class Config>
-    inline void wamp_websocketpp_websocket_transport<Config>::on_ws_open(websocketpp::connection_hdl) {
+    inline void wamp_websocketpp_websocket_transport<Config>::on_ws_open(websocketpp::connection_hdl hdl) {
         scoped_lock guard(m_lock);
-        m_open = true;
 
         //No handshake for websockets beyond declaring sub-protocol
+        typename client_type::connection_ptr con = m_client.get_con_from_hdl(hdl);
+        if (!select_serializer(con->get_subprotocol())) {
+            m_connect.set_exception(protocol_error(
+                    "router selected unsupported subprotocol '" + con->get_subprotocol() + "'"));
+            m_client.close(hdl, websocketpp::close::status::protocol_error, "unsupported subprotocol");
+            return;
+        }
+
+        m_open = true;
         m_connect.set_value();
 
     }
@@ -117,8 +127,10 @@ namespace autobahn {
             return;
         }
 
-        //TODO: need to abstract encoding and get subprotocol
-        con->add_subprotocol("wamp.2.msgpack");
+        // Offer all our serializers, the router selects one of them.
+        for (const auto& serializer : serializers()) {
+            con->add_subprotocol(serializer->websocket_subprotocol());
+        }
 
         // Grab a handle for this connection so we can talk to it in a thread
         // safe manor after the event loop starts.
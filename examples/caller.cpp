@@ -53,6 +53,12 @@ int main(int argc, char** argv)
 
         auto session = std::make_shared<autobahn::wamp_session>(io, debug);
 
+#ifdef AUTOBAHN_FUTURE_EXECUTORS
+        // Run the continuations on the session futures on the io service
+        // rather than on a new thread each.
+        session->set_continuation_executor(autobahn::wamp_future_executor::create(io));
+#endif
+
         transport->attach(std::static_pointer_cast<autobahn::wamp_transport_handler>(session));
 
         // Make sure the continuation futures we use do not run out of scope prematurely.
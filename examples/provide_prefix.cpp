@@ -41,27 +41,30 @@
 
 const std::string PREFIX("com.examples.calculator");
 
-void calculator(autobahn::wamp_invocation invocation)
+void add(autobahn::wamp_invocation invocation)
 {
     auto a = invocation->argument<uint64_t>(0);
     auto b = invocation->argument<uint64_t>(1);
 
-    std::cerr << "Procedure " << invocation->uri() << "invoked: " << a << ", " << b << std::endl;
+    std::cerr << "Procedure " << invocation->uri() << " invoked: " << a << ", " << b << std::endl;
 
-    auto suffix = invocation->uri().substr(PREFIX.size());
+    invocation->result(std::make_tuple(a + b));
+}
 
-    if (suffix == ".add")
-    {
-        invocation->result(std::make_tuple(a + b));
-    }
-    else if (suffix == ".mul2")
-    {
-        invocation->result(std::make_tuple(a * b));
-    }
-    else
-    {
-                throw std::runtime_error("procedure not implemented " + invocation->uri());
-    }
+void mul2(autobahn::wamp_invocation invocation)
+{
+    auto a = invocation->argument<uint64_t>(0);
+    auto b = invocation->argument<uint64_t>(1);
+
+    std::cerr << "Procedure " << invocation->uri() << " invoked: " << a << ", " << b << std::endl;
+
+    invocation->result(std::make_tuple(a * b));
+}
+
+// Invoked for the calls under the prefix that no route matches.
+void calculator(autobahn::wamp_invocation invocation)
+{
+    throw std::runtime_error("procedure not implemented " + invocation->uri());
 }
 
 void on_topic(const autobahn::wamp_event& event)
@@ -127,7 +130,14 @@ int main(int argc, char** argv)
                         io.stop();
                         return;
                     }
-                    provide_future = session->provide(PREFIX, &calculator, { { "match", msgpack::object("prefix") } }).then(
+                    // One prefix registration serves all procedures of the
+                    // calculator, which are dispatched locally by their URI.
+                    session->add_procedure_route(PREFIX + ".add", &add);
+                    session->add_procedure_route(PREFIX + ".mul2", &mul2);
+
+                    autobahn::wamp_register_options register_options;
+                    register_options.set_match(autobahn::wamp_match::prefix);
+                    provide_future = session->provide(PREFIX, &calculator, register_options).then(
                         [&](boost::future<autobahn::wamp_registration> registration) {
                         try {
                             std::cerr << "registered procedure:" << registration.get().id() << std::endl;
@@ -0,0 +1,174 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Compares the throughput of the available wamp serializers.
+//
+// Usage: bench_serializers [corpus] [iterations]
+//
+// The corpus is a file of length prefixed (4 octet, network byte order)
+// msgpack encoded wamp messages as written by serialize.py. Without a
+// corpus a small synthetic set of typical messages is used.
+//
+
+#include <autobahn/wamp_cbor_serializer.hpp>
+#include <autobahn/wamp_message.hpp>
+#include <autobahn/wamp_message_type.hpp>
+#include <autobahn/wamp_msgpack_serializer.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static std::vector<wamp_message> load_corpus(const char* path)
+{
+    std::ifstream file(path, std::ios::binary);
+    std::vector<char> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    wamp_msgpack_serializer serializer;
+    std::vector<wamp_message> messages;
+
+    std::size_t offset = 0;
+    while (offset + 4 <= data.size()) {
+        const uint8_t* header = reinterpret_cast<const uint8_t*>(&data[offset]);
+        std::size_t length = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+        offset += 4;
+        if (offset + length > data.size()) {
+            break;
+        }
+        messages.push_back(serializer.deserialize(&data[offset], length));
+        offset += length;
+    }
+
+    return messages;
+}
+
+static std::vector<wamp_message> synthetic_corpus()
+{
+    std::vector<wamp_message> messages;
+
+    std::map<std::string, msgpack::object> empty;
+
+    wamp_message call(6);
+    call.set_field(0, static_cast<int>(message_type::CALL));
+    call.set_field(1, 4711);
+    call.set_field(2, empty);
+    call.set_field(3, std::string("com.example.add2"));
+    call.set_field(4, std::vector<int>{23, 42});
+    call.set_field(5, std::map<std::string, std::string>{{"unit", "meters"}});
+    messages.push_back(std::move(call));
+
+    wamp_message event(5);
+    event.set_field(0, static_cast<int>(message_type::EVENT));
+    event.set_field(1, 5512315355ULL);
+    event.set_field(2, 4429313566ULL);
+    event.set_field(3, empty);
+    event.set_field(4, std::vector<double>{1.5, -273.15, 3.14159, 2.71828});
+    messages.push_back(std::move(event));
+
+    wamp_message result(4);
+    result.set_field(0, static_cast<int>(message_type::RESULT));
+    result.set_field(1, 4711);
+    result.set_field(2, empty);
+    result.set_field(3, std::vector<std::string>{std::string(256, 'x')});
+    messages.push_back(std::move(result));
+
+    return messages;
+}
+
+static void run(const wamp_serializer& serializer,
+        const std::vector<wamp_message>& messages, std::size_t iterations)
+{
+    using clock = std::chrono::steady_clock;
+
+    std::vector<msgpack::sbuffer> encoded(messages.size());
+    std::size_t octets = 0;
+    for (std::size_t i = 0; i < messages.size(); ++i) {
+        serializer.serialize(messages[i], encoded[i]);
+        octets += encoded[i].size();
+    }
+
+    auto start = clock::now();
+    for (std::size_t n = 0; n < iterations; ++n) {
+        for (const auto& message : messages) {
+            msgpack::sbuffer buffer;
+            serializer.serialize(message, buffer);
+        }
+    }
+    auto serialize_time = clock::now() - start;
+
+    start = clock::now();
+    for (std::size_t n = 0; n < iterations; ++n) {
+        for (const auto& buffer : encoded) {
+            wamp_message message = serializer.deserialize(buffer.data(), buffer.size());
+        }
+    }
+    auto deserialize_time = clock::now() - start;
+
+    const double count = static_cast<double>(iterations * messages.size());
+    std::cout << serializer.websocket_subprotocol()
+            << ": " << octets << " octets per corpus, "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(serialize_time).count() / count
+            << " ns/serialize, "
+            << std::chrono::duration_cast<std::chrono::nanoseconds>(deserialize_time).count() / count
+            << " ns/deserialize" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<wamp_message> messages = argc > 1 ? load_corpus(argv[1]) : synthetic_corpus();
+    std::size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 100000;
+
+    if (messages.empty()) {
+        std::cerr << "empty corpus" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::shared_ptr<wamp_serializer>> serializers {
+        std::make_shared<wamp_msgpack_serializer>(),
+        std::make_shared<wamp_cbor_serializer>()
+    };
+
+    std::cout << messages.size() << " messages, " << iterations << " iterations" << std::endl;
+    for (const auto& serializer : serializers) {
+        run(*serializer, messages, iterations);
+    }
+
+    return 0;
+}
@@ -0,0 +1,370 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that the serializers reproduce every wamp message shape and that
+// the CBOR decoder rejects malformed input.
+//
+// Usage: test_cbor_serializer
+//
+
+#include <autobahn/exceptions.hpp>
+#include <autobahn/wamp_cbor_serializer.hpp>
+#include <autobahn/wamp_message.hpp>
+#include <autobahn/wamp_message_type.hpp>
+#include <autobahn/wamp_msgpack_serializer.hpp>
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static wamp_message make_message(message_type type, std::size_t num_fields)
+{
+    wamp_message message(num_fields);
+    message.set_field(0, static_cast<int>(type));
+    return message;
+}
+
+static std::vector<wamp_message> all_messages()
+{
+    std::vector<wamp_message> messages;
+
+    const std::map<std::string, int> empty;
+    const std::map<std::string, std::string> details{{"authmethod", "wampcra"}};
+    const std::vector<std::string> arguments{"hello", ""};
+    const std::map<std::string, std::vector<int>> kw_arguments{{"values", {1, -1, 0}}};
+
+    wamp_message hello = make_message(message_type::HELLO, 3);
+    hello.set_field(1, std::string("realm1"));
+    hello.set_field(2, details);
+    messages.push_back(std::move(hello));
+
+    wamp_message welcome = make_message(message_type::WELCOME, 3);
+    welcome.set_field(1, UINT64_C(9007199254740992));
+    welcome.set_field(2, empty);
+    messages.push_back(std::move(welcome));
+
+    wamp_message abort = make_message(message_type::ABORT, 3);
+    abort.set_field(1, empty);
+    abort.set_field(2, std::string("wamp.error.no_such_realm"));
+    messages.push_back(std::move(abort));
+
+    wamp_message challenge = make_message(message_type::CHALLENGE, 3);
+    challenge.set_field(1, std::string("wampcra"));
+    challenge.set_field(2, details);
+    messages.push_back(std::move(challenge));
+
+    wamp_message authenticate = make_message(message_type::AUTHENTICATE, 3);
+    authenticate.set_field(1, std::string("signature"));
+    authenticate.set_field(2, empty);
+    messages.push_back(std::move(authenticate));
+
+    wamp_message goodbye = make_message(message_type::GOODBYE, 3);
+    goodbye.set_field(1, empty);
+    goodbye.set_field(2, std::string("wamp.close.normal"));
+    messages.push_back(std::move(goodbye));
+
+    wamp_message error = make_message(message_type::ERROR, 7);
+    error.set_field(1, static_cast<int>(message_type::CALL));
+    error.set_field(2, 4711);
+    error.set_field(3, empty);
+    error.set_field(4, std::string("com.example.error"));
+    error.set_field(5, arguments);
+    error.set_field(6, kw_arguments);
+    messages.push_back(std::move(error));
+
+    wamp_message publish = make_message(message_type::PUBLISH, 6);
+    publish.set_field(1, 1);
+    publish.set_field(2, std::map<std::string, bool>{{"acknowledge", true}});
+    publish.set_field(3, std::string("com.example.topic"));
+    publish.set_field(4, std::vector<double>{1.5, -273.15, 0.0});
+    publish.set_field(5, kw_arguments);
+    messages.push_back(std::move(publish));
+
+    wamp_message published = make_message(message_type::PUBLISHED, 3);
+    published.set_field(1, 1);
+    published.set_field(2, std::numeric_limits<uint64_t>::max());
+    messages.push_back(std::move(published));
+
+    wamp_message subscribe = make_message(message_type::SUBSCRIBE, 4);
+    subscribe.set_field(1, 2);
+    subscribe.set_field(2, std::map<std::string, std::string>{{"match", "prefix"}});
+    subscribe.set_field(3, std::string("com.example"));
+    messages.push_back(std::move(subscribe));
+
+    wamp_message subscribed = make_message(message_type::SUBSCRIBED, 3);
+    subscribed.set_field(1, 2);
+    subscribed.set_field(2, 5512315355ULL);
+    messages.push_back(std::move(subscribed));
+
+    wamp_message unsubscribe = make_message(message_type::UNSUBSCRIBE, 3);
+    unsubscribe.set_field(1, 3);
+    unsubscribe.set_field(2, 5512315355ULL);
+    messages.push_back(std::move(unsubscribe));
+
+    wamp_message unsubscribed = make_message(message_type::UNSUBSCRIBED, 2);
+    unsubscribed.set_field(1, 3);
+    messages.push_back(std::move(unsubscribed));
+
+    wamp_message event = make_message(message_type::EVENT, 6);
+    event.set_field(1, 5512315355ULL);
+    event.set_field(2, 4429313566ULL);
+    event.set_field(3, empty);
+    event.set_field(4, std::vector<int64_t>{std::numeric_limits<int64_t>::min(), -24, -25, -1});
+    event.set_field(5, kw_arguments);
+    messages.push_back(std::move(event));
+
+    wamp_message call = make_message(message_type::CALL, 6);
+    call.set_field(1, 4);
+    call.set_field(2, std::map<std::string, int>{{"timeout", 1000}});
+    call.set_field(3, std::string("com.example.add2"));
+    call.set_field(4, std::vector<float>{1.5f, -0.25f});
+    call.set_field(5, std::map<std::string, std::vector<char>>{{"blob", {'\0', '\xff', 'a'}}});
+    messages.push_back(std::move(call));
+
+    wamp_message cancel = make_message(message_type::CANCEL, 3);
+    cancel.set_field(1, 4);
+    cancel.set_field(2, std::map<std::string, std::string>{{"mode", "kill"}});
+    messages.push_back(std::move(cancel));
+
+    wamp_message result = make_message(message_type::RESULT, 5);
+    result.set_field(1, 4);
+    result.set_field(2, std::map<std::string, bool>{{"progress", false}});
+    result.set_field(3, std::vector<std::string>{std::string(70000, 'x')});
+    result.set_field(4, empty);
+    messages.push_back(std::move(result));
+
+    wamp_message register_message = make_message(message_type::REGISTER, 4);
+    register_message.set_field(1, 5);
+    register_message.set_field(2, empty);
+    register_message.set_field(3, std::string("com.example.add2"));
+    messages.push_back(std::move(register_message));
+
+    wamp_message registered = make_message(message_type::REGISTERED, 3);
+    registered.set_field(1, 5);
+    registered.set_field(2, 255);
+    messages.push_back(std::move(registered));
+
+    wamp_message unregister = make_message(message_type::UNREGISTER, 3);
+    unregister.set_field(1, 6);
+    unregister.set_field(2, 256);
+    messages.push_back(std::move(unregister));
+
+    wamp_message unregistered = make_message(message_type::UNREGISTERED, 2);
+    unregistered.set_field(1, 6);
+    messages.push_back(std::move(unregistered));
+
+    wamp_message invocation = make_message(message_type::INVOCATION, 6);
+    invocation.set_field(1, 65535);
+    invocation.set_field(2, 65536);
+    invocation.set_field(3, empty);
+    invocation.set_field(4, std::vector<bool>{true, false});
+    invocation.set_field(5, kw_arguments);
+    messages.push_back(std::move(invocation));
+
+    wamp_message interrupt = make_message(message_type::INTERRUPT, 3);
+    interrupt.set_field(1, 65535);
+    interrupt.set_field(2, empty);
+    messages.push_back(std::move(interrupt));
+
+    wamp_message yield = make_message(message_type::YIELD, 5);
+    yield.set_field(1, 65535);
+    yield.set_field(2, empty);
+    yield.set_field(3, std::vector<msgpack::object>{msgpack::object()});
+    yield.set_field(4, kw_arguments);
+    messages.push_back(std::move(yield));
+
+    return messages;
+}
+
+static void test_round_trips(const wamp_serializer& serializer)
+{
+    const std::string name = serializer.websocket_subprotocol();
+
+    for (const auto& message : all_messages()) {
+        const std::string what = name + " round trip of message type "
+                + std::to_string(message.field(0).via.u64);
+
+        msgpack::sbuffer buffer;
+        serializer.serialize(message, buffer);
+
+        try {
+            wamp_message decoded = serializer.deserialize(buffer.data(), buffer.size());
+            check(decoded.size() == message.size(), what + ": field count");
+            for (std::size_t i = 0; i < message.size() && i < decoded.size(); ++i) {
+                check(decoded.field(i) == message.field(i),
+                        what + ": field " + std::to_string(i));
+            }
+        } catch (const std::exception& e) {
+            check(false, what + ": " + e.what());
+        }
+    }
+}
+
+static wamp_message decode(const std::vector<uint8_t>& octets)
+{
+    wamp_cbor_serializer serializer;
+    return serializer.deserialize(reinterpret_cast<const char*>(octets.data()), octets.size());
+}
+
+// Decodes a message holding the single float encoded by the given octets.
+static double decode_float(const std::vector<uint8_t>& encoded_float)
+{
+    std::vector<uint8_t> octets{0x81};
+    octets.insert(octets.end(), encoded_float.begin(), encoded_float.end());
+    return decode(octets).field(0).via.f64;
+}
+
+static void test_floats()
+{
+    check(decode_float({0xF9, 0x3C, 0x00}) == 1.0, "half 1.0");
+    check(decode_float({0xF9, 0xC4, 0x00}) == -4.0, "half -4.0");
+    check(decode_float({0xF9, 0x7B, 0xFF}) == 65504.0, "half maximum");
+    check(decode_float({0xF9, 0x00, 0x01}) == std::ldexp(1.0, -24), "half subnormal");
+    check(decode_float({0xF9, 0x80, 0x00}) == 0.0
+            && std::signbit(decode_float({0xF9, 0x80, 0x00})), "half -0.0");
+    check(decode_float({0xF9, 0x7C, 0x00}) == std::numeric_limits<double>::infinity(),
+            "half infinity");
+    check(std::isnan(decode_float({0xF9, 0x7E, 0x00})), "half NaN");
+
+    check(decode_float({0xFA, 0x47, 0xC3, 0x50, 0x00}) == 100000.0, "single 100000.0");
+    check(decode_float({0xFA, 0x7F, 0x80, 0x00, 0x00}) == std::numeric_limits<double>::infinity(),
+            "single infinity");
+
+    check(decode_float({0xFB, 0x3F, 0xF1, 0x99, 0x99, 0x99, 0x99, 0x99, 0x9A}) == 1.1,
+            "double 1.1");
+    check(decode_float({0xFB, 0xC0, 0x10, 0x66, 0x66, 0x66, 0x66, 0x66, 0x66}) == -4.1,
+            "double -4.1");
+
+    // Floats keep their precision through a round trip.
+    wamp_cbor_serializer serializer;
+    wamp_message message(2);
+    message.set_field(0, 0.25f);
+    message.set_field(1, 0.1);
+
+    msgpack::sbuffer buffer;
+    serializer.serialize(message, buffer);
+    check(buffer.size() == 1 + 5 + 9, "single and double encoded sizes");
+
+    wamp_message decoded = serializer.deserialize(buffer.data(), buffer.size());
+    check(decoded.field(0).type == msgpack::type::FLOAT32 && decoded.field(0).via.f64 == 0.25,
+            "single round trip");
+    check(decoded.field(1).type == msgpack::type::FLOAT64 && decoded.field(1).via.f64 == 0.1,
+            "double round trip");
+}
+
+static bool rejects(const std::vector<uint8_t>& octets)
+{
+    try {
+        decode(octets);
+    } catch (const protocol_error&) {
+        return true;
+    }
+    return false;
+}
+
+static void test_truncated_input()
+{
+    wamp_cbor_serializer serializer;
+    for (const auto& message : all_messages()) {
+        msgpack::sbuffer buffer;
+        serializer.serialize(message, buffer);
+
+        const uint8_t* data = reinterpret_cast<const uint8_t*>(buffer.data());
+        bool all_rejected = true;
+        for (std::size_t length = 0; length < buffer.size(); ++length) {
+            all_rejected = all_rejected && rejects(std::vector<uint8_t>(data, data + length));
+        }
+        check(all_rejected, "truncated message type " + std::to_string(message.field(0).via.u64));
+    }
+
+    // Lengths that claim more octets than are left.
+    check(rejects({0x81, 0x5B, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF}), "huge byte string");
+    check(rejects({0x9B, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00}), "huge array");
+    check(rejects({0x81, 0xBA, 0x10, 0x00, 0x00, 0x00, 0x01}), "huge map");
+
+    check(rejects({0x81, 0x01, 0x01}), "trailing octets");
+    check(rejects({0x01}), "message that is not an array");
+    check(rejects({0x9F, 0x01, 0xFF}), "indefinite length array");
+}
+
+static void test_depth_limit()
+{
+    // The message array is at depth 0, so an integer inside CBOR_MAX_DEPTH
+    // nested arrays is the deepest item accepted.
+    std::vector<uint8_t> octets(256, 0x81);
+    octets.push_back(0x01);
+    check(!rejects(octets), "nesting at the depth limit");
+
+    octets.insert(octets.begin(), 0x81);
+    check(rejects(octets), "nesting beyond the depth limit");
+
+    std::vector<uint8_t> maps{0x81};
+    for (int i = 0; i < 100000; ++i) {
+        maps.push_back(0xA1);
+        maps.push_back(0x01);
+    }
+    maps.push_back(0x01);
+    check(rejects(maps), "deeply nested maps");
+}
+
+int main()
+{
+    test_round_trips(wamp_msgpack_serializer());
+    test_round_trips(wamp_cbor_serializer());
+    test_floats();
+    test_truncated_input();
+    test_depth_limit();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
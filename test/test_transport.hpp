@@ -0,0 +1,236 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef AUTOBAHN_TEST_TRANSPORT_HPP
+#define AUTOBAHN_TEST_TRANSPORT_HPP
+
+//
+// An in-memory transport for session tests. The test plays the router: it
+// takes the messages the session sent and delivers the router's replies,
+// running the io service in between with poll().
+//
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+#include <boost/thread/future.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace autobahn {
+
+class test_transport :
+        public wamp_transport,
+        public std::enable_shared_from_this<test_transport>
+{
+public:
+    test_transport()
+        : m_connected(false)
+        , m_handler()
+        , m_sent()
+    {
+    }
+
+    virtual boost::future<void> connect() override
+    {
+        m_connected = true;
+        return boost::make_ready_future();
+    }
+
+    virtual boost::future<void> disconnect() override
+    {
+        m_connected = false;
+        return boost::make_ready_future();
+    }
+
+    virtual bool is_connected() const override
+    {
+        return m_connected;
+    }
+
+    virtual void send_message(wamp_message&& message) override
+    {
+        m_sent.push_back(std::move(message));
+    }
+
+    virtual void set_pause_handler(pause_handler&&) override
+    {
+    }
+
+    virtual void set_resume_handler(resume_handler&&) override
+    {
+    }
+
+    virtual void pause() override
+    {
+    }
+
+    virtual void resume() override
+    {
+    }
+
+    virtual void attach(const std::shared_ptr<wamp_transport_handler>& handler) override
+    {
+        if (m_handler) {
+            throw std::logic_error("handler already attached");
+        }
+
+        m_handler = handler;
+        m_handler->on_attach(shared_from_this());
+    }
+
+    virtual void detach() override
+    {
+        if (!m_handler) {
+            throw std::logic_error("no handler attached");
+        }
+
+        m_handler->on_detach(true, "wamp.error.goodbye");
+        m_handler.reset();
+    }
+
+    virtual bool has_handler() const override
+    {
+        return m_handler != nullptr;
+    }
+
+    /*!
+     * Delivers a message from the router. Must be called on the thread
+     * running the io service, like a real transport would.
+     */
+    void receive(wamp_message&& message)
+    {
+        m_handler->on_message(std::move(message));
+    }
+
+    /*!
+     * Drops the connection without a goodbye. The session fails what is
+     * pending and reports the dropped connection with a network_error.
+     */
+    void drop(const std::string& reason = "connection lost")
+    {
+        try {
+            m_handler->on_disconnect(false, reason);
+        } catch (const network_error&) {
+        }
+    }
+
+    /*!
+     * Takes the messages sent since the last call.
+     */
+    std::vector<wamp_message> take_sent()
+    {
+        std::vector<wamp_message> sent;
+        sent.swap(m_sent);
+        return sent;
+    }
+
+private:
+    bool m_connected;
+    std::shared_ptr<wamp_transport_handler> m_handler;
+    std::vector<wamp_message> m_sent;
+};
+
+inline void set_message_fields(wamp_message&, std::size_t)
+{
+}
+
+template <typename Field, typename... Fields>
+inline void set_message_fields(
+        wamp_message& message, std::size_t index, const Field& field, const Fields&... fields)
+{
+    message.set_field(index, field);
+    set_message_fields(message, index + 1, fields...);
+}
+
+/*!
+ * Builds a message of the given type from the remaining fields.
+ */
+template <typename... Fields>
+inline wamp_message make_message(message_type type, const Fields&... fields)
+{
+    wamp_message message(1 + sizeof...(Fields));
+    message.set_field(0, static_cast<int>(type));
+    set_message_fields(message, 1, fields...);
+    return message;
+}
+
+/*!
+ * An empty dictionary, for the details and options of messages.
+ */
+inline std::map<std::string, std::string> no_details()
+{
+    return std::map<std::string, std::string>();
+}
+
+/*!
+ * Runs the handlers that are ready on the io service.
+ */
+inline void poll(boost::asio::io_service& io)
+{
+    io.reset();
+    io.poll();
+}
+
+/*!
+ * Starts a session on the transport and joins it with the given session id.
+ */
+inline std::shared_ptr<wamp_session> join_session(
+        boost::asio::io_service& io,
+        const std::shared_ptr<test_transport>& transport,
+        uint64_t session_id = 1)
+{
+    auto session = std::make_shared<wamp_session>(io);
+    transport->attach(session);
+
+    boost::future<void> started = session->start();
+    poll(io);
+    started.get();
+
+    boost::future<uint64_t> joined = session->join("realm1");
+    poll(io);
+    transport->take_sent();
+    transport->receive(make_message(message_type::WELCOME, session_id, no_details()));
+    poll(io);
+    joined.get();
+
+    return session;
+}
+
+} // namespace autobahn
+
+#endif // AUTOBAHN_TEST_TRANSPORT_HPP
@@ -0,0 +1,155 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that events received through overlapping pattern-based
+// subscriptions are routed to local handlers once per publication.
+//
+// Usage: test_wamp_event_routes
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Subscribes and answers the SUBSCRIBE with the given subscription id.
+static void subscribe(
+        boost::asio::io_service& io,
+        const std::shared_ptr<test_transport>& transport,
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const std::string& match,
+        const wamp_event_handler& handler,
+        uint64_t subscription_id)
+{
+    wamp_subscribe_options options(match);
+    boost::future<wamp_subscription> subscribed = session->subscribe(topic, handler, options);
+    poll(io);
+
+    std::vector<wamp_message> sent = transport->take_sent();
+    uint64_t request_id = sent.back().field<uint64_t>(1);
+    transport->receive(make_message(message_type::SUBSCRIBED, request_id, subscription_id));
+    poll(io);
+    check(subscribed.get().id() == subscription_id, "subscribed to " + topic);
+}
+
+static wamp_message make_event(uint64_t subscription_id, uint64_t publication_id, const std::string& topic)
+{
+    std::map<std::string, std::string> details;
+    details["topic"] = topic;
+    return make_message(message_type::EVENT, subscription_id, publication_id, details,
+            std::vector<int>{1});
+}
+
+static void test_overlapping_subscriptions()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    int prefix_events = 0;
+    int wildcard_events = 0;
+    subscribe(io, transport, session, "com.example", "prefix",
+            [&](const wamp_event&) { ++prefix_events; }, 100);
+    subscribe(io, transport, session, "com..update", "wildcard",
+            [&](const wamp_event&) { ++wildcard_events; }, 200);
+
+    int routed = 0;
+    int routed_prefix = 0;
+    session->add_event_route("com.example.a.update",
+            [&](const wamp_event& event) {
+                check(event.uri() == "com.example.a.update", "routed event carries its topic");
+                ++routed;
+            });
+    session->add_event_route("com.example.a",
+            [&](const wamp_event&) { ++routed_prefix; }, wamp_match::prefix);
+    poll(io);
+
+    // The router sends one EVENT per matching subscription.
+    transport->receive(make_event(100, 5000, "com.example.a.update"));
+    transport->receive(make_event(200, 5000, "com.example.a.update"));
+    poll(io);
+    check(routed == 1, "exact route runs once per publication");
+    check(routed_prefix == 1, "prefix route runs once per publication");
+    check(prefix_events == 0 && wildcard_events == 0,
+            "routes stand in for every matching subscription");
+
+    transport->receive(make_event(200, 5001, "com.example.a.update"));
+    transport->receive(make_event(100, 5001, "com.example.a.update"));
+    poll(io);
+    check(routed == 2 && routed_prefix == 2, "the next publication is routed again");
+
+    // Publications no route matches go to the subscriptions.
+    transport->receive(make_event(100, 5002, "com.example.b.update"));
+    transport->receive(make_event(200, 5002, "com.example.b.update"));
+    poll(io);
+    check(prefix_events == 1 && wildcard_events == 1,
+            "unrouted publications reach every matching subscription");
+    check(routed == 2 && routed_prefix == 2, "unrouted publications skip the routes");
+
+    transport->receive(make_event(100, 5003, "com.example.a.other"));
+    poll(io);
+    check(routed == 2 && routed_prefix == 3, "only matching routes run");
+    check(prefix_events == 1, "routed publication skips its subscription");
+}
+
+int main()
+{
+    test_overlapping_subscriptions();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,295 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_thread_pool runs every task and keeps its metrics, and
+// that wamp_limited_executor never exceeds its concurrency cap, starts its
+// backlog in order and survives throwing tasks.
+//
+// Usage: test_wamp_executor
+//
+
+#include <autobahn/wamp_limited_executor.hpp>
+#include <autobahn/wamp_serial_executor.hpp>
+#include <autobahn/wamp_thread_pool.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// A latch that tasks can block on until the test opens it.
+class gate
+{
+public:
+    gate()
+        : m_open(false)
+    {
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait(lock, [this]() { return m_open; });
+    }
+
+    void open()
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_open = true;
+        m_condition.notify_all();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    bool m_open;
+};
+
+// Waits up to five seconds for the condition to become true.
+template <typename Condition>
+static bool eventually(Condition condition)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (!condition()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// Waits for the runners of a limited executor to let go of it. They keep
+// it, and so its pool, alive, and a pool must not be destroyed from one of
+// its own workers.
+template <typename Executor>
+static void release(const std::shared_ptr<Executor>& limited)
+{
+    check(eventually([&]() { return limited.use_count() == 1; }),
+            "limited executor is released by its runners");
+}
+
+static void test_thread_pool()
+{
+    std::atomic<int> done(0);
+    {
+        auto pool = std::make_shared<wamp_thread_pool>(4);
+        check(pool->size() == 4, "pool has the requested number of threads");
+
+        // Tasks posted from a worker run as well. They hold a plain pointer,
+        // as the pool must not be destroyed from one of its workers.
+        wamp_thread_pool* raw = pool.get();
+        for (int i = 0; i < 1000; ++i) {
+            pool->post([&done, raw]() {
+                ++done;
+                raw->post([&done]() { ++done; });
+            });
+        }
+        pool->post([]() { throw std::runtime_error("task failed"); });
+
+        check(eventually([&]() { return pool->metrics().executed == 2001; }),
+                "pool runs every task");
+        check(done == 2000, "pool runs every task once");
+
+        // A task counts as executed once it starts.
+        check(eventually([&]() { return pool->metrics().failed == 1; }),
+                "pool counts throwing tasks");
+        wamp_executor_metrics metrics = pool->metrics();
+        check(metrics.queue_depth == 0, "pool has no queued tasks left");
+        check(metrics.max_wait.count() > 0 && metrics.total_wait >= metrics.max_wait,
+                "pool accounts the time tasks waited");
+
+        // A throwing task does not take down its worker.
+        auto blocked = std::make_shared<gate>();
+        std::atomic<int> started(0);
+        for (int i = 0; i < 4; ++i) {
+            pool->post([blocked, &started]() {
+                ++started;
+                blocked->wait();
+            });
+        }
+        check(eventually([&]() { return started == 4; }), "every worker takes a task");
+        pool->post([&done]() { ++done; });
+        check(eventually([&]() { return pool->metrics().queue_depth == 1; }),
+                "pool reports the queue depth");
+        blocked->open();
+        check(eventually([&]() { return done == 2001; }), "every worker survives a throwing task");
+    }
+
+    // Tasks still queued when the pool is destroyed are run.
+    done = 0;
+    {
+        wamp_thread_pool pool(1);
+        gate blocked;
+        pool.post([&blocked]() { blocked.wait(); });
+        for (int i = 0; i < 10; ++i) {
+            pool.post([&done]() { ++done; });
+        }
+        blocked.open();
+    }
+    check(done == 10, "destroying the pool runs the queued tasks");
+}
+
+static void test_concurrency_cap()
+{
+    auto pool = std::make_shared<wamp_thread_pool>(8);
+    auto limited = std::make_shared<wamp_limited_executor>(pool, 3);
+    check(limited->max_concurrency() == 3, "limited executor keeps its cap");
+
+    std::atomic<int> running(0);
+    std::atomic<int> peak(0);
+    std::atomic<int> done(0);
+    for (int i = 0; i < 200; ++i) {
+        limited->post([&]() {
+            int now = ++running;
+            int seen = peak.load();
+            while (now > seen && !peak.compare_exchange_weak(seen, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            --running;
+            ++done;
+        });
+    }
+
+    check(eventually([&]() { return done == 200; }), "limited executor runs every task");
+    check(peak <= 3, "limited executor never exceeds its cap");
+    check(peak == 3, "limited executor uses its whole cap");
+    release(limited);
+}
+
+static void test_backlog()
+{
+    auto pool = std::make_shared<wamp_thread_pool>(4);
+    auto serial = std::make_shared<wamp_serial_executor>(pool);
+
+    auto blocked = std::make_shared<gate>();
+    serial->post([blocked]() { blocked->wait(); });
+
+    // Wait for the blocking task to start, so that the rest is backlogged.
+    check(eventually([&]() { return serial->metrics().executed == 1; }),
+            "serial executor starts the first task");
+
+    std::vector<int> order;
+    for (int i = 0; i < 100; ++i) {
+        serial->post([&order, i]() { order.push_back(i); });
+    }
+    serial->post([]() { throw std::runtime_error("task failed"); });
+    std::atomic<bool> finished(false);
+    serial->post([&order, &finished]() {
+        order.push_back(100);
+        finished = true;
+    });
+
+    wamp_executor_metrics metrics = serial->metrics();
+    check(metrics.queue_depth == 102, "backlog counts as queue depth");
+    check(metrics.executed == 1, "backlogged tasks have not started");
+    check(pool->metrics().queue_depth == 0, "backlog does not occupy the underlying executor");
+
+    blocked->open();
+    check(eventually([&]() { return finished.load(); }), "serial executor runs its backlog");
+    check(serial->metrics().executed == 103, "serial executor counts the started tasks");
+
+    bool ordered = order.size() == 101;
+    for (std::size_t i = 0; ordered && i < order.size(); ++i) {
+        ordered = order[i] == static_cast<int>(i);
+    }
+    check(ordered, "backlog starts in the order it was posted");
+
+    metrics = serial->metrics();
+    check(metrics.failed == 1, "limited executor counts throwing tasks");
+    check(metrics.queue_depth == 0, "backlog is empty");
+    check(metrics.max_wait.count() > 0 && metrics.total_wait >= metrics.max_wait,
+            "limited executor accounts the time tasks waited");
+    check(pool->metrics().failed == 0, "limited executor keeps exceptions from its executor");
+    release(serial);
+}
+
+static void test_invalid_arguments()
+{
+    bool thrown = false;
+    try {
+        wamp_thread_pool pool(0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "pool without threads is rejected");
+
+    thrown = false;
+    try {
+        wamp_limited_executor limited(std::make_shared<wamp_thread_pool>(1), 0);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "limited executor without concurrency is rejected");
+
+    thrown = false;
+    try {
+        wamp_limited_executor limited(nullptr, 1);
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "limited executor without executor is rejected");
+}
+
+int main()
+{
+    test_thread_pool();
+    test_concurrency_cap();
+    test_backlog();
+    test_invalid_arguments();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,228 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks wamp_id_map against std::unordered_map, including erasing from
+// within clusters of colliding ids.
+//
+// Usage: test_wamp_id_map
+//
+
+#include <autobahn/wamp_id_map.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Counts live instances to catch values that are never destroyed or
+// destroyed twice.
+struct counted
+{
+    static int live;
+
+    explicit counted(uint64_t value) : value(value) { ++live; }
+    counted(const counted& other) : value(other.value) { ++live; }
+    counted(counted&& other) : value(other.value) { ++live; }
+    ~counted() { --live; }
+
+    uint64_t value;
+};
+
+int counted::live = 0;
+
+// Ids with the same home slot as the first one in a table of 16 slots,
+// the size of a table holding up to 8 entries, see wamp_id_map::grow().
+static std::vector<uint64_t> colliding_ids(std::size_t count)
+{
+    std::vector<uint64_t> ids;
+    for (uint64_t id = 1; ids.size() < count; ++id) {
+        if (((id * UINT64_C(11400714819323198485)) >> 60) == 0) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+static bool matches(wamp_id_map<counted>& map, const std::unordered_map<uint64_t, uint64_t>& model)
+{
+    if (map.size() != model.size()) {
+        return false;
+    }
+
+    for (const auto& entry : model) {
+        const counted* value = map.find(entry.first);
+        if (!value || value->value != entry.second) {
+            return false;
+        }
+    }
+
+    std::size_t visited = 0;
+    bool known = true;
+    map.for_each([&](uint64_t id, counted& value) {
+        auto found = model.find(id);
+        known = known && found != model.end() && found->second == value.value;
+        ++visited;
+    });
+
+    return known && visited == model.size();
+}
+
+static void test_basic_operations()
+{
+    wamp_id_map<counted> map;
+    check(map.empty() && map.find(1) == nullptr, "new map is empty");
+
+    map.emplace(1, 10);
+    map.emplace(2, 20);
+    check(map.size() == 2 && map.find(1)->value == 10 && map.find(2)->value == 20, "emplace");
+
+    check(map.emplace(1, 99).value == 10 && map.size() == 2, "emplace keeps existing value");
+    check(map.find(0) == nullptr, "id 0 is never found");
+
+    check(map.take(1).value == 10 && map.find(1) == nullptr && map.size() == 1, "take");
+    check(map.erase(2) && !map.erase(2) && map.empty(), "erase");
+
+    map.emplace(3, 30);
+    map.clear();
+    check(map.empty() && map.find(3) == nullptr, "clear");
+
+    map.emplace(3, 31);
+    check(map.find(3)->value == 31, "reuse after clear");
+}
+
+static void test_collisions()
+{
+    const std::vector<uint64_t> ids = colliding_ids(6);
+
+    // Erase each position of a cluster in turn, the remaining entries must
+    // still be found after the backward shift.
+    for (std::size_t erased = 0; erased < ids.size(); ++erased) {
+        wamp_id_map<counted> map;
+        std::unordered_map<uint64_t, uint64_t> model;
+        for (uint64_t id : ids) {
+            map.emplace(id, id * 10);
+            model[id] = id * 10;
+        }
+
+        map.erase(ids[erased]);
+        model.erase(ids[erased]);
+        check(matches(map, model), "erase position " + std::to_string(erased) + " of a cluster");
+
+        // The freed slot is reused without disturbing the cluster.
+        map.emplace(ids[erased], 1);
+        model[ids[erased]] = 1;
+        check(matches(map, model), "reinsert into a cluster at " + std::to_string(erased));
+    }
+
+    // A cluster wrapping around the end of the table.
+    wamp_id_map<counted> map;
+    std::unordered_map<uint64_t, uint64_t> model;
+    std::vector<uint64_t> last_slot;
+    for (uint64_t id = 1; last_slot.size() < 3; ++id) {
+        if (((id * UINT64_C(11400714819323198485)) >> 60) == 15) {
+            last_slot.push_back(id);
+        }
+    }
+    for (uint64_t id : last_slot) {
+        map.emplace(id, id);
+        model[id] = id;
+    }
+    map.erase(last_slot[0]);
+    model.erase(last_slot[0]);
+    check(matches(map, model), "erase from a wrapping cluster");
+}
+
+static void test_against_model()
+{
+    std::mt19937_64 random(4711);
+    wamp_id_map<counted> map;
+    std::unordered_map<uint64_t, uint64_t> model;
+
+    bool consistent = true;
+    for (int step = 0; step < 100000 && consistent; ++step) {
+        // A small id range keeps the table busy with collisions.
+        const uint64_t id = random() % 512 + 1;
+        switch (random() % 3) {
+            case 0:
+                map.emplace(id, step);
+                model.emplace(id, step);
+                break;
+            case 1:
+                consistent = map.erase(id) == (model.erase(id) == 1);
+                break;
+            default:
+                if (model.count(id)) {
+                    consistent = map.take(id).value == model[id];
+                    model.erase(id);
+                }
+                break;
+        }
+
+        if (step % 1000 == 0) {
+            consistent = consistent && matches(map, model);
+        }
+    }
+    check(consistent && matches(map, model), "random operations match std::unordered_map");
+
+    wamp_id_map<counted> moved(std::move(map));
+    check(matches(moved, model) && map.empty(), "move");
+}
+
+int main()
+{
+    test_basic_operations();
+    test_collisions();
+    test_against_model();
+
+    check(counted::live == 0, "every value is destroyed exactly once");
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,231 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//
+// Checks that publishes with local delivery reach the session's own exact,
+// prefix and wildcard subscriptions directly, and that the router copy of
+// a local and router publish keeps its arguments.
+//
+// Usage: test_wamp_local_delivery
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// What a handler saw of the events it received.
+struct received
+{
+    std::vector<std::string> topics;
+    std::vector<std::vector<int>> arguments;
+    std::vector<std::map<std::string, std::string>> kw_arguments;
+
+    wamp_event_handler handler()
+    {
+        return [this](const wamp_event& event) {
+            topics.push_back(event.uri());
+            arguments.push_back(event.arguments<std::vector<int>>());
+            kw_arguments.push_back(event.kw_arguments<std::map<std::string, std::string>>());
+        };
+    }
+};
+
+static void subscribe(
+        boost::asio::io_service& io,
+        const std::shared_ptr<test_transport>& transport,
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        const std::string& match,
+        received& events,
+        uint64_t subscription_id)
+{
+    wamp_subscribe_options options(match);
+    boost::future<wamp_subscription> subscribed = session->subscribe(topic, events.handler(), options);
+    poll(io);
+
+    std::vector<wamp_message> sent = transport->take_sent();
+    uint64_t request_id = sent.back().field<uint64_t>(1);
+    transport->receive(make_message(message_type::SUBSCRIBED, request_id, subscription_id));
+    poll(io);
+    check(subscribed.get().id() == subscription_id, "subscribed to " + topic);
+}
+
+static boost::future<wamp_publication> publish(
+        const std::shared_ptr<wamp_session>& session,
+        const std::string& topic,
+        wamp_local_delivery local_delivery,
+        int value)
+{
+    std::map<std::string, std::string> kw_arguments;
+    kw_arguments["key"] = "value";
+
+    wamp_publish_options options;
+    options.set_local_delivery(local_delivery);
+    return session->publish(topic, std::vector<int>{value, value + 1}, kw_arguments, options);
+}
+
+static void test_local_delivery()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    received exact;
+    received prefix;
+    received wildcard;
+    received other;
+    subscribe(io, transport, session, "com.example.a", "exact", exact, 100);
+    subscribe(io, transport, session, "com.example", "prefix", prefix, 200);
+    subscribe(io, transport, session, "com..a", "wildcard", wildcard, 300);
+    subscribe(io, transport, session, "com.other", "exact", other, 400);
+
+    // A local only publish takes the message's zone and sends nothing.
+    boost::future<wamp_publication> local_only =
+            publish(session, "com.example.a", wamp_local_delivery::local_only, 1);
+    poll(io);
+    check(transport->take_sent().empty(), "a local only publish is not sent");
+    check(local_only.wait_for(boost::chrono::seconds(0)) == boost::future_status::ready,
+            "a local only publish completes once delivered");
+
+    const std::vector<int> first{1, 2};
+    check(exact.arguments.size() == 1 && exact.arguments[0] == first,
+            "the exact subscription receives the event");
+    check(prefix.arguments.size() == 1 && prefix.arguments[0] == first,
+            "the prefix subscription receives the event");
+    check(wildcard.arguments.size() == 1 && wildcard.arguments[0] == first,
+            "the wildcard subscription receives the event");
+    check(other.arguments.empty(), "other subscriptions do not receive the event");
+    check(exact.topics.size() == 1 && exact.topics[0] == "com.example.a"
+            && prefix.topics[0] == "com.example.a" && wildcard.topics[0] == "com.example.a",
+            "local events carry their topic");
+    check(exact.kw_arguments.size() == 1 && exact.kw_arguments[0].at("key") == "value",
+            "local events carry keyword arguments");
+
+    // A local and router publish copies the arguments for the event, and
+    // the router copy excludes the publisher.
+    boost::future<wamp_publication> local_and_router =
+            publish(session, "com.example.b", wamp_local_delivery::local_and_router, 5);
+    poll(io);
+    local_and_router.get();
+
+    std::vector<wamp_message> sent = transport->take_sent();
+    check(sent.size() == 1 && sent[0].field<int>(0) == static_cast<int>(message_type::PUBLISH),
+            "a local and router publish is sent");
+    if (sent.size() == 1) {
+        std::map<std::string, bool> options = sent[0].field<std::map<std::string, bool>>(2);
+        check(options.count("exclude_me") && options["exclude_me"],
+                "the router copy excludes the publisher");
+        check(sent[0].field<std::string>(3) == "com.example.b", "the router copy keeps its topic");
+        check(sent[0].field<std::vector<int>>(4) == std::vector<int>({5, 6}),
+                "the router copy keeps its arguments");
+        check(sent[0].field<std::map<std::string, std::string>>(5).at("key") == "value",
+                "the router copy keeps its keyword arguments");
+    }
+
+    // Drop the sent message before the handlers' data is checked, the event
+    // must not have shared its zone.
+    sent.clear();
+    check(prefix.arguments.size() == 2 && prefix.arguments[1] == std::vector<int>({5, 6}),
+            "the prefix subscription receives the local and router event");
+    check(exact.arguments.size() == 1 && wildcard.arguments.size() == 1,
+            "non-matching subscriptions do not receive the event");
+
+    // Without local delivery nothing is delivered locally.
+    boost::future<wamp_publication> plain =
+            publish(session, "com.example.a", wamp_local_delivery::none, 9);
+    poll(io);
+    plain.get();
+    check(transport->take_sent().size() == 1, "a plain publish is sent");
+    check(exact.arguments.size() == 1 && prefix.arguments.size() == 2,
+            "a plain publish is not delivered locally");
+}
+
+static void test_routes()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    received exact;
+    received prefix;
+    subscribe(io, transport, session, "com.example.a", "exact", exact, 100);
+    subscribe(io, transport, session, "com.example", "prefix", prefix, 200);
+
+    int routed = 0;
+    session->add_event_route("com.example.a", [&](const wamp_event& event) {
+        check(event.uri() == "com.example.a", "a routed local event carries its topic");
+        ++routed;
+    });
+    poll(io);
+
+    boost::future<wamp_publication> published =
+            publish(session, "com.example.a", wamp_local_delivery::local_only, 1);
+    poll(io);
+    published.get();
+    check(routed == 1, "a route stands in for the pattern subscription");
+    check(prefix.arguments.empty(), "the routed pattern subscription is skipped");
+    check(exact.arguments.size() == 1, "the exact subscription still receives the event");
+}
+
+int main()
+{
+    test_local_delivery();
+    test_routes();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,306 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_async_log_sink drops records once its queue is full or
+// the rate limit is reached and reports them, that no record is lost under
+// concurrent producers, and that an idle sink leaves its stream alone.
+//
+// Usage: test_wamp_log_sink
+//
+
+#include <autobahn/wamp_log_sink.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Collects the output of a sink and counts its flushes. Optionally blocks
+// the first write until released, which stalls the background thread.
+class capture_buffer : public std::streambuf
+{
+public:
+    explicit capture_buffer(bool blocking = false)
+        : m_blocking(blocking)
+        , m_entered(false)
+        , m_released(false)
+        , m_syncs(0)
+    {
+    }
+
+    // Waits for the background thread to get stuck in the first write.
+    bool wait_entered()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return m_changed.wait_for(lock, std::chrono::seconds(5), [this] { return m_entered; });
+    }
+
+    void release()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        m_released = true;
+        m_changed.notify_all();
+    }
+
+    std::string text()
+    {
+        std::lock_guard<std::mutex> guard(m_mutex);
+        return m_text;
+    }
+
+    int syncs() const
+    {
+        return m_syncs.load();
+    }
+
+protected:
+    virtual std::streamsize xsputn(const char* data, std::streamsize size) override
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (m_blocking) {
+            m_entered = true;
+            m_changed.notify_all();
+            m_changed.wait(lock, [this] { return m_released; });
+        }
+        m_text.append(data, static_cast<std::size_t>(size));
+        return size;
+    }
+
+    virtual int_type overflow(int_type character) override
+    {
+        if (character != traits_type::eof()) {
+            char value = traits_type::to_char_type(character);
+            xsputn(&value, 1);
+        }
+        return traits_type::not_eof(character);
+    }
+
+    virtual int sync() override
+    {
+        ++m_syncs;
+        return 0;
+    }
+
+private:
+    bool m_blocking;
+    std::mutex m_mutex;
+    std::condition_variable m_changed;
+    bool m_entered;
+    bool m_released;
+    std::string m_text;
+    std::atomic<int> m_syncs;
+};
+
+static log_record make_record(uint64_t timestamp, const char* text)
+{
+    log_record record;
+    record.timestamp = timestamp;
+    record.id = 0;
+    record.size = 0;
+    record.level = log_level::warning;
+    record.event = log_event::session;
+    record.message_type = 0;
+    std::strncpy(record.text, text, log_record::TEXT_LENGTH - 1);
+    record.text[log_record::TEXT_LENGTH - 1] = '\0';
+    return record;
+}
+
+// The number of formatted records and the number of dropped records
+// reported in the output.
+static void count_output(const std::string& text, uint64_t& records, uint64_t& dropped)
+{
+    static const std::string DROPPED = "log records dropped: ";
+
+    records = 0;
+    dropped = 0;
+    std::istringstream lines(text);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (line.compare(0, DROPPED.size(), DROPPED) == 0) {
+            dropped += std::stoull(line.substr(DROPPED.size()));
+        } else {
+            ++records;
+        }
+    }
+}
+
+static void test_idle()
+{
+    capture_buffer buffer;
+    std::ostream out(&buffer);
+    {
+        wamp_async_log_sink sink(out, 64, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        check(buffer.syncs() == 0, "unused sink does not flush");
+
+        sink.write(make_record(1, "first"));
+        for (int i = 0; i < 500 && buffer.text().empty(); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        check(buffer.text().find("first") != std::string::npos, "first record starts the sink");
+
+        const int syncs = buffer.syncs();
+        check(syncs > 0, "written records are flushed");
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        check(buffer.syncs() == syncs, "idle sink does not flush");
+    }
+
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    count_output(buffer.text(), records, dropped);
+    check(records == 1 && dropped == 0, "idle sink writes the record once");
+}
+
+static void test_full_queue()
+{
+    capture_buffer buffer(true);
+    std::ostream out(&buffer);
+    uint64_t dropped_records = 0;
+    {
+        wamp_async_log_sink sink(out, 4, 0);
+
+        // The background thread takes the first record off the queue and
+        // gets stuck writing it, so the queue fills up.
+        sink.write(make_record(1, "stuck"));
+        check(buffer.wait_entered(), "background thread writes the first record");
+
+        for (int i = 0; i < 7; ++i) {
+            sink.write(make_record(2, "queued"));
+        }
+        dropped_records = sink.dropped();
+        check(dropped_records == 3, "records beyond the capacity are dropped");
+
+        buffer.release();
+    }
+
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    count_output(buffer.text(), records, dropped);
+    check(records == 5, "queued records are written");
+    check(dropped == dropped_records, "dropped records are reported");
+}
+
+static void test_rate_limit()
+{
+    const uint64_t second = 1000000000;
+
+    capture_buffer buffer;
+    std::ostream out(&buffer);
+    {
+        wamp_async_log_sink sink(out, 64, 3);
+        for (int i = 0; i < 10; ++i) {
+            sink.write(make_record(10 * second + i, "burst"));
+        }
+        check(sink.dropped() == 7, "records beyond the rate are dropped");
+
+        sink.write(make_record(9 * second, "late"));
+        check(sink.dropped() == 8, "earlier records count against the current second");
+
+        sink.write(make_record(11 * second, "next"));
+        check(sink.dropped() == 8, "next second starts a new window");
+    }
+
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    count_output(buffer.text(), records, dropped);
+    check(records == 4, "records within the rate are written");
+    check(dropped == 8, "rate limited records are reported");
+}
+
+static void test_concurrent_producers()
+{
+    const int thread_count = 4;
+    const int writes = 20000;
+
+    capture_buffer buffer;
+    std::ostream out(&buffer);
+    uint64_t dropped_records = 0;
+    {
+        wamp_async_log_sink sink(out, 256, 0);
+
+        std::vector<std::thread> threads;
+        for (int index = 0; index < thread_count; ++index) {
+            threads.emplace_back([&sink]() {
+                for (int i = 0; i < writes; ++i) {
+                    sink.write(make_record(1, "concurrent"));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        dropped_records = sink.dropped();
+    }
+
+    uint64_t records = 0;
+    uint64_t dropped = 0;
+    count_output(buffer.text(), records, dropped);
+    check(dropped == dropped_records, "every drop is reported");
+    check(records + dropped == static_cast<uint64_t>(thread_count * writes),
+            "every record is either written or dropped");
+}
+
+int main()
+{
+    test_idle();
+    test_full_queue();
+    test_rate_limit();
+    test_concurrent_producers();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
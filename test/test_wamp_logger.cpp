@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_logger filters records by level, that AUTOBAHN_LOG does
+// not evaluate its arguments for disabled levels, and what the records of
+// text and messages carry.
+//
+// Usage: test_wamp_logger
+//
+
+#include <autobahn/wamp_logger.hpp>
+#include <autobahn/wamp_message.hpp>
+#include <autobahn/wamp_message_type.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Keeps the records written to it.
+class capture_sink : public wamp_log_sink
+{
+public:
+    virtual void write(const log_record& record) override
+    {
+        records.push_back(record);
+    }
+
+    std::vector<log_record> records;
+};
+
+static int evaluations = 0;
+
+static const char* evaluated(const char* text)
+{
+    ++evaluations;
+    return text;
+}
+
+static void test_level_filtering()
+{
+    auto sink = std::make_shared<capture_sink>();
+    wamp_logger logger(log_level::warning, sink);
+    check(logger.level() == log_level::warning, "initial level");
+    check(!logger.is_enabled(log_level::info), "below the level is disabled");
+    check(logger.is_enabled(log_level::warning) && logger.is_enabled(log_level::error),
+            "level and above are enabled");
+
+    evaluations = 0;
+    AUTOBAHN_LOG(logger, log_level::info, log_event::session, evaluated("info"));
+    check(sink->records.empty(), "disabled level writes nothing");
+    check(evaluations == 0, "arguments of disabled levels are not evaluated");
+
+    AUTOBAHN_LOG(logger, log_level::warning, log_event::session, evaluated("warning"), 7);
+    check(sink->records.size() == 1 && evaluations == 1, "enabled level writes a record");
+    check(sink->records.back().level == log_level::warning
+            && sink->records.back().event == log_event::session
+            && sink->records.back().id == 7
+            && std::string(sink->records.back().text) == "warning",
+            "record carries level, event, id and text");
+
+    logger.set_level(log_level::debug);
+    AUTOBAHN_LOG(logger, log_level::trace, log_event::dispatch, "trace");
+    AUTOBAHN_LOG(logger, log_level::debug, log_event::dispatch, "debug");
+    check(sink->records.size() == 2 && std::string(sink->records.back().text) == "debug",
+            "lowering the level enables more records");
+
+    logger.set_level(log_level::off);
+    AUTOBAHN_LOG(logger, log_level::error, log_event::session, "error");
+    check(sink->records.size() == 2, "off disables every level");
+
+    logger.set_level(log_level::trace);
+    logger.set_sink(nullptr);
+    check(!logger.is_enabled(log_level::error), "logger without a sink is disabled");
+}
+
+static void test_records()
+{
+    auto sink = std::make_shared<capture_sink>();
+    wamp_logger logger(log_level::trace, sink);
+
+    const std::string text(100, 'x');
+    logger.log(log_level::info, log_event::transport, text.c_str(), 1, 42);
+    check(std::strlen(sink->records.back().text) == log_record::TEXT_LENGTH - 1,
+            "long text is truncated");
+    check(sink->records.back().size == 42, "record carries the size");
+
+    wamp_message message(3);
+    message.set_field(0, static_cast<int>(message_type::CALL));
+    message.set_field(1, static_cast<uint64_t>(1234));
+    message.set_field(2, std::string("com.example"));
+    logger.log(log_level::trace, log_event::message_sent, message, 99);
+    const log_record& record = sink->records.back();
+    check(record.message_type == static_cast<uint8_t>(message_type::CALL),
+            "message record carries the type");
+    check(record.id == 1234 && record.size == 99, "message record carries id and size");
+    check(record.text[0] == '\0', "message record has no text");
+}
+
+int main()
+{
+    test_level_filtering();
+    test_records();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
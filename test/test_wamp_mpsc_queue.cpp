@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_mpsc_queue delivers every element exactly once and in
+// the order each producer pushed them.
+//
+// Usage: test_wamp_mpsc_queue
+//
+
+#include <autobahn/wamp_mpsc_queue.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+struct element : wamp_mpsc_node
+{
+    element() : producer(0), sequence(0) {}
+
+    std::size_t producer;
+    std::size_t sequence;
+};
+
+static void test_single_thread()
+{
+    wamp_mpsc_queue<element> queue;
+    check(queue.empty() && queue.pop() == nullptr, "new queue is empty");
+
+    element elements[3];
+    for (std::size_t i = 0; i < 3; ++i) {
+        elements[i].sequence = i;
+        queue.push(&elements[i]);
+    }
+    check(!queue.empty(), "queue with elements is not empty");
+
+    bool in_order = true;
+    for (std::size_t i = 0; i < 3; ++i) {
+        element* popped = queue.pop();
+        in_order = in_order && popped == &elements[i];
+    }
+    check(in_order, "elements are popped in push order");
+    check(queue.empty() && queue.pop() == nullptr, "queue is empty after popping everything");
+
+    // The stub is pushed back when the last element is popped, so the queue
+    // keeps working after being drained.
+    queue.push(&elements[0]);
+    element* popped = queue.pop();
+    queue.push(&elements[1]);
+    check(popped == &elements[0] && queue.pop() == &elements[1] && queue.pop() == nullptr,
+            "reuse after draining");
+}
+
+static void test_producers()
+{
+    const std::size_t PRODUCERS = 4;
+    const std::size_t ELEMENTS = 100000;
+
+    wamp_mpsc_queue<element> queue;
+    // Elements are not copyable, so each producer gets an array of its own.
+    std::vector<std::unique_ptr<element[]>> elements;
+    for (std::size_t p = 0; p < PRODUCERS; ++p) {
+        elements.emplace_back(new element[ELEMENTS]);
+    }
+
+    std::vector<std::thread> producers;
+    for (std::size_t p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([&, p]() {
+            for (std::size_t i = 0; i < ELEMENTS; ++i) {
+                elements[p][i].producer = p;
+                elements[p][i].sequence = i;
+                queue.push(&elements[p][i]);
+            }
+        });
+    }
+
+    // pop() may return nullptr while a push is in progress, so keep going
+    // until everything has arrived.
+    std::vector<std::size_t> next(PRODUCERS, 0);
+    std::size_t received = 0;
+    bool in_order = true;
+    while (received < PRODUCERS * ELEMENTS) {
+        element* popped = queue.pop();
+        if (!popped) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        in_order = in_order && popped->sequence == next[popped->producer];
+        ++next[popped->producer];
+        ++received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+
+    check(in_order, "elements of each producer are popped in push order");
+    check(queue.empty() && queue.pop() == nullptr, "every element is popped exactly once");
+}
+
+int main()
+{
+    test_single_thread();
+    test_producers();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
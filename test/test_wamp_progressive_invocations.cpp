@@ -0,0 +1,202 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//
+// Checks that the chunks of a progressive call reach the invocation in
+// order, and that an invocation released without an answer is cleaned up
+// without taking its remaining chunks for new invocations.
+//
+// Usage: test_wamp_progressive_invocations
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static const uint64_t REGISTRATION_ID = 300;
+
+static void provide(
+        boost::asio::io_service& io,
+        const std::shared_ptr<test_transport>& transport,
+        const std::shared_ptr<wamp_session>& session,
+        const wamp_procedure& procedure)
+{
+    boost::future<wamp_registration> registered = session->provide("com.example.upload", procedure);
+    poll(io);
+
+    std::vector<wamp_message> sent = transport->take_sent();
+    uint64_t request_id = sent.back().field<uint64_t>(1);
+    transport->receive(make_message(message_type::REGISTERED, request_id, REGISTRATION_ID));
+    poll(io);
+    check(registered.get().id() == REGISTRATION_ID, "registered the procedure");
+}
+
+// An INVOCATION, or a further chunk of one when it reuses a request id.
+static wamp_message make_invocation(uint64_t request_id, int value, bool progress)
+{
+    std::map<std::string, bool> details;
+    if (progress) {
+        details["progress"] = true;
+    }
+    return make_message(message_type::INVOCATION, request_id, REGISTRATION_ID, details,
+            std::vector<int>{value});
+}
+
+static void test_chunks()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    int invocations = 0;
+    wamp_invocation kept;
+    provide(io, transport, session, [&](wamp_invocation invocation) {
+        ++invocations;
+        kept = invocation;
+    });
+
+    transport->receive(make_invocation(1, 1, true));
+    poll(io);
+    check(invocations == 1 && kept && kept->progressive_call(), "the first chunk invokes the procedure");
+    check(kept && kept->argument<int>(0) == 1, "the invocation carries the first chunk");
+
+    // Chunks arriving before the handler is set are kept for it.
+    transport->receive(make_invocation(1, 2, true));
+    poll(io);
+
+    std::vector<int> chunks;
+    bool final = false;
+    kept->set_chunk_handler([&](const wamp_call_result& chunk, bool last) {
+        chunks.push_back(chunk.argument<int>(0));
+        final = last;
+    });
+    check(chunks == std::vector<int>({2}) && !final, "buffered chunks reach the handler once set");
+
+    transport->receive(make_invocation(1, 3, true));
+    transport->receive(make_invocation(1, 4, false));
+    poll(io);
+    check(invocations == 1, "further chunks do not invoke the procedure");
+    check(chunks == std::vector<int>({2, 3, 4}) && final, "chunks arrive in order, the last one final");
+
+    kept->result(std::vector<int>{10});
+    poll(io);
+    std::vector<wamp_message> sent = transport->take_sent();
+    check(sent.size() == 1 && sent[0].field<int>(0) == static_cast<int>(message_type::YIELD)
+            && sent[0].field<uint64_t>(1) == 1, "the invocation is answered once");
+}
+
+static void test_released_unanswered()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    int invocations = 0;
+    std::vector<int> arguments;
+    provide(io, transport, session, [&](wamp_invocation invocation) {
+        // Drop the invocation without an answer.
+        ++invocations;
+        arguments.push_back(invocation->argument<int>(0));
+    });
+
+    // A plain invocation is forgotten once released.
+    transport->receive(make_invocation(1, 1, false));
+    poll(io);
+    transport->receive(make_invocation(1, 2, false));
+    poll(io);
+    check(invocations == 2, "a released invocation is forgotten");
+
+    // A progressive call released before its last chunk swallows the
+    // remaining chunks.
+    transport->receive(make_invocation(2, 10, true));
+    poll(io);
+    transport->receive(make_invocation(2, 11, true));
+    transport->receive(make_invocation(2, 12, true));
+    poll(io);
+    check(invocations == 3 && arguments.back() == 10,
+            "chunks of a released progressive call do not invoke the procedure");
+
+    transport->receive(make_invocation(2, 13, false));
+    poll(io);
+    check(invocations == 3, "the last chunk of a released progressive call is dropped too");
+
+    // Its last chunk ended the call, so the request id is free again.
+    transport->receive(make_invocation(2, 14, false));
+    poll(io);
+    check(invocations == 4 && arguments.back() == 14,
+            "a released progressive call is forgotten after its last chunk");
+
+    // An interrupt also ends a released progressive call.
+    transport->receive(make_invocation(3, 20, true));
+    poll(io);
+    transport->receive(make_message(message_type::INTERRUPT, uint64_t(3), no_details()));
+    poll(io);
+    transport->receive(make_invocation(3, 21, false));
+    poll(io);
+    check(invocations == 6 && arguments.back() == 21,
+            "a released progressive call is forgotten once interrupted");
+    check(transport->take_sent().empty(), "released invocations send nothing");
+}
+
+int main()
+{
+    test_chunks();
+    test_released_unanswered();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
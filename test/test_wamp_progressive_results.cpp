@@ -0,0 +1,228 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//
+// Checks that progressive call results reach the progress handler in the
+// order they arrive and before the final result resolves the call.
+//
+// Usage: test_wamp_progressive_results
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static bool is_ready(boost::future<wamp_call_result>& result)
+{
+    return result.wait_for(boost::chrono::seconds(0)) == boost::future_status::ready;
+}
+
+// Takes the single CALL sent since the last call.
+static wamp_message take_call(const std::shared_ptr<test_transport>& transport)
+{
+    std::vector<wamp_message> sent = transport->take_sent();
+    if (sent.size() != 1 || sent[0].field<int>(0) != static_cast<int>(message_type::CALL)) {
+        throw std::runtime_error("expected a single CALL");
+    }
+    return std::move(sent[0]);
+}
+
+static wamp_message make_result(uint64_t request_id, int value, bool progress)
+{
+    std::map<std::string, bool> details;
+    if (progress) {
+        details["progress"] = true;
+    }
+    return make_message(message_type::RESULT, request_id, details, std::vector<int>{value});
+}
+
+static void test_ordering()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    std::vector<int> progress;
+    bool resolved_early = false;
+    boost::future<wamp_call_result> result;
+
+    wamp_call_options options;
+    options.set_progress_handler([&](const wamp_call_result& partial) {
+        progress.push_back(partial.argument<int>(0));
+        resolved_early = resolved_early || is_ready(result);
+    });
+    result = session->call("com.example.stream", std::vector<int>{3}, options);
+    poll(io);
+
+    wamp_message call = take_call(transport);
+    std::map<std::string, bool> call_options = call.field<std::map<std::string, bool>>(2);
+    check(call_options.count("receive_progress") && call_options["receive_progress"],
+            "the call asks for progressive results");
+    const uint64_t request_id = call.field<uint64_t>(1);
+
+    transport->receive(make_result(request_id, 1, true));
+    poll(io);
+    check(progress == std::vector<int>({1}), "a progressive result reaches the handler as it arrives");
+    check(!is_ready(result), "a progressive result leaves the call pending");
+
+    transport->receive(make_result(request_id, 2, true));
+    transport->receive(make_result(request_id, 3, true));
+    transport->receive(make_result(request_id, 4, false));
+    poll(io);
+    check(progress == std::vector<int>({1, 2, 3}), "progressive results arrive in order");
+    check(!resolved_early, "the call resolves only after every progressive result");
+    check(is_ready(result) && result.get().argument<int>(0) == 4,
+            "the final result resolves the call");
+
+    // The call is complete, so late results are ignored.
+    transport->receive(make_result(request_id, 5, true));
+    transport->receive(make_result(request_id, 6, false));
+    poll(io);
+    check(progress.size() == 3, "results after the final one are ignored");
+}
+
+static void test_handler_failures()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    // A throwing handler does not fail the call, and the handler may issue
+    // further requests.
+    int calls = 0;
+    boost::future<wamp_call_result> nested;
+    wamp_call_options options;
+    options.set_progress_handler([&](const wamp_call_result&) {
+        if (++calls == 1) {
+            nested = session->call("com.example.nested");
+            return;
+        }
+        throw std::runtime_error("progress handler failed");
+    });
+    boost::future<wamp_call_result> result = session->call("com.example.stream", options);
+    poll(io);
+    const uint64_t request_id = take_call(transport).field<uint64_t>(1);
+
+    transport->receive(make_result(request_id, 1, true));
+    poll(io);
+    const uint64_t nested_id = take_call(transport).field<uint64_t>(1);
+    check(nested_id != request_id, "a progress handler may issue a call");
+
+    transport->receive(make_result(request_id, 2, true));
+    poll(io);
+    check(calls == 2 && !is_ready(result), "a throwing progress handler leaves the call pending");
+
+    transport->receive(make_result(nested_id, 10, false));
+    transport->receive(make_result(request_id, 3, false));
+    poll(io);
+    check(nested.get().argument<int>(0) == 10, "the nested call completes");
+    check(result.get().argument<int>(0) == 3, "the call completes after a throwing handler");
+
+    // Without a handler progressive results are ignored.
+    boost::future<wamp_call_result> plain = session->call("com.example.plain");
+    poll(io);
+    wamp_message call = take_call(transport);
+    check(call.field<std::map<std::string, bool>>(2).count("receive_progress") == 0,
+            "a call without a handler does not ask for progressive results");
+    const uint64_t plain_id = call.field<uint64_t>(1);
+    transport->receive(make_result(plain_id, 1, true));
+    poll(io);
+    check(!is_ready(plain), "unrequested progressive results are ignored");
+    transport->receive(make_result(plain_id, 2, false));
+    poll(io);
+    check(plain.get().argument<int>(0) == 2, "the final result still resolves the call");
+}
+
+static void test_error_after_progress()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    int progress = 0;
+    wamp_call_options options;
+    options.set_progress_handler([&](const wamp_call_result&) { ++progress; });
+    boost::future<wamp_call_result> result = session->call("com.example.stream", options);
+    poll(io);
+    const uint64_t request_id = take_call(transport).field<uint64_t>(1);
+
+    transport->receive(make_result(request_id, 1, true));
+    transport->receive(make_message(message_type::ERROR,
+            static_cast<int>(message_type::CALL), request_id, no_details(),
+            std::string("com.example.error.aborted")));
+    poll(io);
+
+    bool failed = false;
+    try {
+        result.get();
+    } catch (const wamp_error& e) {
+        failed = std::string(e.uri()) == "com.example.error.aborted";
+    }
+    check(progress == 1, "progress arrives before the error");
+    check(failed, "an error after progressive results fails the call");
+}
+
+int main()
+{
+    test_ordering();
+    test_handler_failures();
+    test_error_after_progress();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
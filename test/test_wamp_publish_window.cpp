@@ -0,0 +1,217 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+
+//
+// Checks that acknowledged publishes beyond the publish window wait, in
+// order, until an acknowledgement or error from the router makes room.
+//
+// Usage: test_wamp_publish_window
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static boost::future<wamp_publication> publish(
+        const std::shared_ptr<wamp_session>& session, int value, bool acknowledge = true)
+{
+    wamp_publish_options options;
+    options.set_acknowledge(acknowledge);
+    return session->publish("com.example.topic", std::vector<int>{value}, options);
+}
+
+// The request ids and payloads of the PUBLISH messages sent since the last call.
+static std::vector<uint64_t> take_published(
+        const std::shared_ptr<test_transport>& transport, std::vector<int>* values = nullptr)
+{
+    std::vector<uint64_t> request_ids;
+    for (wamp_message& message : transport->take_sent()) {
+        if (message.field<int>(0) == static_cast<int>(message_type::PUBLISH)) {
+            request_ids.push_back(message.field<uint64_t>(1));
+            if (values) {
+                values->push_back(message.field<std::vector<int>>(4).at(0));
+            }
+        }
+    }
+    return request_ids;
+}
+
+static bool is_ready(boost::future<wamp_publication>& publication)
+{
+    return publication.wait_for(boost::chrono::seconds(0)) == boost::future_status::ready;
+}
+
+static void test_full_window()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    session->set_publish_window(2);
+    poll(io);
+
+    std::vector<boost::future<wamp_publication>> published;
+    for (int value = 0; value < 4; ++value) {
+        published.push_back(publish(session, value));
+    }
+    poll(io);
+
+    std::vector<int> values;
+    std::vector<uint64_t> in_flight = take_published(transport, &values);
+    check(in_flight.size() == 2, "a full window holds back further publishes");
+    check(values == std::vector<int>({0, 1}), "the first publishes are sent");
+    check(session->pending_publications() == 4, "waiting publishes count as pending");
+    check(!is_ready(published[2]) && !is_ready(published[3]), "waiting publishes are not complete");
+
+    // An unacknowledged publish is not held back.
+    boost::future<wamp_publication> unacknowledged = publish(session, 100, false);
+    poll(io);
+    values.clear();
+    check(take_published(transport, &values).size() == 1 && values == std::vector<int>({100}),
+            "unacknowledged publishes overtake waiting ones");
+    check(is_ready(unacknowledged), "unacknowledged publishes complete once sent");
+    check(session->pending_publications() == 4, "unacknowledged publishes are not pending");
+
+    // An acknowledgement makes room for the next waiting publish.
+    transport->receive(make_message(message_type::PUBLISHED, in_flight[0], uint64_t(7000)));
+    poll(io);
+    check(is_ready(published[0]) && published[0].get().id() == 7000,
+            "an acknowledged publish resolves to its publication");
+    values.clear();
+    std::vector<uint64_t> released = take_published(transport, &values);
+    check(released.size() == 1 && values == std::vector<int>({2}),
+            "an acknowledgement releases the next waiting publish");
+    check(session->pending_publications() == 3, "the acknowledged publish is no longer pending");
+    check(!is_ready(published[3]), "the window is full again");
+
+    // So does an error.
+    transport->receive(make_message(message_type::ERROR,
+            static_cast<int>(message_type::PUBLISH), in_flight[1], no_details(),
+            std::string("wamp.error.not_authorized")));
+    poll(io);
+    bool failed = false;
+    try {
+        published[1].get();
+    } catch (const wamp_error& e) {
+        failed = std::string(e.uri()) == "wamp.error.not_authorized";
+    }
+    check(failed, "a rejected publish fails with the router's error");
+    values.clear();
+    std::vector<uint64_t> last = take_published(transport, &values);
+    check(last.size() == 1 && values == std::vector<int>({3}), "an error releases the next waiting publish");
+    check(session->pending_publications() == 2, "the rejected publish is no longer pending");
+
+    transport->receive(make_message(message_type::PUBLISHED, released[0], uint64_t(7002)));
+    transport->receive(make_message(message_type::PUBLISHED, last[0], uint64_t(7003)));
+    poll(io);
+    check(published[2].get().id() == 7002 && published[3].get().id() == 7003,
+            "released publishes complete with their own acknowledgements");
+    check(session->pending_publications() == 0, "nothing is pending once acknowledged");
+}
+
+static void test_window_changes()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport);
+
+    session->set_publish_window(1);
+    poll(io);
+
+    std::vector<boost::future<wamp_publication>> published;
+    for (int value = 0; value < 3; ++value) {
+        published.push_back(publish(session, value));
+    }
+    poll(io);
+    check(take_published(transport).size() == 1, "a window of one sends a single publish");
+
+    // Lifting the limit sends everything that waits, in order.
+    session->set_publish_window(0);
+    poll(io);
+    std::vector<int> values;
+    check(take_published(transport, &values).size() == 2 && values == std::vector<int>({1, 2}),
+            "lifting the window releases the waiting publishes in order");
+
+    session->set_publish_window(1);
+    poll(io);
+    published.push_back(publish(session, 3));
+    poll(io);
+    check(take_published(transport).empty(), "a smaller window holds back publishes");
+    check(session->pending_publications() == 4, "all publishes are pending");
+
+    // Dropping the connection fails both the sent and the waiting publishes.
+    transport->drop();
+    poll(io);
+    int failed = 0;
+    for (auto& publication : published) {
+        try {
+            publication.get();
+        } catch (const network_error&) {
+            ++failed;
+        }
+    }
+    check(failed == 4, "a dropped connection fails in flight and waiting publishes");
+    check(session->pending_publications() == 0, "nothing is pending after a dropped connection");
+}
+
+int main()
+{
+    test_full_window();
+    test_window_changes();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_result_cache evicts the least recently used result,
+// expires results after their time to live, keeps results requested before
+// a clear() out of the cache and counts its metrics.
+//
+// Usage: test_wamp_result_cache
+//
+
+#include <autobahn/wamp_call_result.hpp>
+#include <autobahn/wamp_result_cache.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <msgpack.hpp>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// A result with a single positional argument, built like the session
+// builds the result of a RESULT message.
+static wamp_call_result make_result(int value)
+{
+    msgpack::zone zone;
+    msgpack::object arguments(std::make_tuple(value), zone);
+
+    wamp_call_result result(std::move(zone));
+    result.set_arguments(arguments);
+    return result;
+}
+
+// The argument of the cached result for a key, or -1 on a miss.
+static int cached_value(wamp_result_cache& cache, const std::string& key)
+{
+    wamp_call_result result;
+    return cache.find(key, result) ? result.argument<int>(0) : -1;
+}
+
+static void test_basic_operations()
+{
+    bool thrown = false;
+    try {
+        wamp_result_cache cache(0, std::chrono::milliseconds(0));
+    } catch (const std::invalid_argument&) {
+        thrown = true;
+    }
+    check(thrown, "capacity zero throws");
+
+    wamp_result_cache cache(4, std::chrono::milliseconds(0));
+    check(cache.capacity() == 4 && cache.ttl().count() == 0, "capacity and ttl");
+    check(cached_value(cache, "a") == -1, "empty cache misses");
+
+    cache.insert("a", make_result(1), cache.generation());
+    check(cached_value(cache, "a") == 1, "hit after insert");
+    check(cached_value(cache, "b") == -1, "other key misses");
+
+    cache.insert("a", make_result(2), cache.generation());
+    check(cached_value(cache, "a") == 2, "insert replaces the result of a key");
+
+    wamp_result_cache_metrics metrics = cache.metrics();
+    check(metrics.size == 1, "replacing keeps the size");
+    check(metrics.hits == 2 && metrics.misses == 2, "hits and misses are counted");
+    check(metrics.evictions == 0, "replacing is no eviction");
+
+    // The cache hands out copies, which outlive the cached result.
+    wamp_call_result result;
+    check(cache.find("a", result), "find copies the result");
+    cache.clear();
+    check(result.argument<int>(0) == 2, "copy outlives clear");
+    check(cache.metrics().size == 0 && cached_value(cache, "a") == -1, "clear drops results");
+}
+
+static void test_eviction()
+{
+    wamp_result_cache cache(2, std::chrono::milliseconds(0));
+    cache.insert("a", make_result(1), cache.generation());
+    cache.insert("b", make_result(2), cache.generation());
+
+    // Using a makes b the least recently used.
+    check(cached_value(cache, "a") == 1, "a is cached");
+    cache.insert("c", make_result(3), cache.generation());
+    check(cached_value(cache, "b") == -1, "least recently used result is evicted");
+    check(cached_value(cache, "a") == 1 && cached_value(cache, "c") == 3,
+            "recently used results are kept");
+
+    cache.insert("d", make_result(4), cache.generation());
+    check(cached_value(cache, "a") == -1, "a is evicted after c was used");
+
+    wamp_result_cache_metrics metrics = cache.metrics();
+    check(metrics.size == 2, "size stays at capacity");
+    check(metrics.evictions == 2, "evictions are counted");
+}
+
+static void test_expiry()
+{
+    const std::chrono::milliseconds ttl(50);
+    wamp_result_cache cache(4, ttl);
+    cache.insert("a", make_result(1), cache.generation());
+    check(cached_value(cache, "a") == 1, "fresh result hits");
+
+    std::this_thread::sleep_for(ttl * 2);
+    check(cached_value(cache, "a") == -1, "expired result misses");
+
+    wamp_result_cache_metrics metrics = cache.metrics();
+    check(metrics.size == 0, "expired result is dropped");
+    check(metrics.hits == 1 && metrics.misses == 1, "expired result counts as a miss");
+
+    cache.insert("a", make_result(2), cache.generation());
+    check(cached_value(cache, "a") == 2, "expired key can be cached again");
+}
+
+static void test_generation()
+{
+    wamp_result_cache cache(4, std::chrono::milliseconds(0));
+
+    // A call missed, then the cache was cleared before its result arrived.
+    const uint64_t missed = cache.generation();
+    cache.clear();
+    check(cache.generation() != missed, "clear advances the generation");
+
+    cache.insert("a", make_result(1), missed);
+    check(cached_value(cache, "a") == -1, "result of an earlier generation is not cached");
+    check(cache.metrics().size == 0, "stale insert leaves the cache empty");
+
+    cache.insert("a", make_result(2), cache.generation());
+    check(cached_value(cache, "a") == 2, "result of the current generation is cached");
+}
+
+// Several threads looking up, inserting and clearing at once. Checks that
+// the cache stays within its capacity and that every lookup is counted.
+static void test_threads()
+{
+    wamp_result_cache cache(16, std::chrono::milliseconds(0));
+
+    const int thread_count = 4;
+    const int lookups = 20000;
+    std::atomic<bool> wrong_value(false);
+
+    std::vector<std::thread> threads;
+    for (int index = 0; index < thread_count; ++index) {
+        threads.emplace_back([&cache, &wrong_value, index, lookups]() {
+            for (int i = 0; i < lookups; ++i) {
+                const int value = (i * 7 + index) % 64;
+                const std::string key = std::to_string(value);
+
+                wamp_call_result result;
+                if (cache.find(key, result)) {
+                    if (result.argument<int>(0) != value) {
+                        wrong_value = true;
+                    }
+                } else {
+                    cache.insert(key, make_result(value), cache.generation());
+                }
+
+                if (i % 1000 == 0) {
+                    cache.clear();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    wamp_result_cache_metrics metrics = cache.metrics();
+    check(!wrong_value, "every hit returns the result of its key");
+    check(metrics.size <= cache.capacity(), "size never exceeds capacity");
+    check(metrics.hits + metrics.misses == static_cast<uint64_t>(thread_count * lookups),
+            "every lookup is counted");
+}
+
+int main()
+{
+    test_basic_operations();
+    test_eviction();
+    test_expiry();
+    test_generation();
+    test_threads();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
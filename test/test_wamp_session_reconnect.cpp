@@ -0,0 +1,197 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that subscriptions and registrations end when the transport
+// disconnects: their handlers are not invoked any more, their handles fail
+// without reaching the router and pending requests fail.
+//
+// Usage: test_wamp_session_reconnect
+//
+
+#include "test_transport.hpp"
+
+#include <autobahn/autobahn.hpp>
+
+#include <boost/asio/io_service.hpp>
+
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Answers the single request sent since the last call with the given reply.
+static uint64_t answer(
+        boost::asio::io_service& io,
+        const std::shared_ptr<test_transport>& transport,
+        message_type request_type,
+        message_type reply_type,
+        uint64_t id)
+{
+    poll(io);
+    std::vector<wamp_message> sent = transport->take_sent();
+    check(sent.size() == 1 && sent[0].field<int>(0) == static_cast<int>(request_type),
+            "request sent to the router");
+    if (sent.empty()) {
+        return 0;
+    }
+
+    uint64_t request_id = sent[0].field<uint64_t>(1);
+    transport->receive(make_message(reply_type, request_id, id));
+    poll(io);
+    return request_id;
+}
+
+// Expects a future to fail with a wamp_error of the given URI.
+template <typename T>
+static void check_error(boost::future<T>& result, const std::string& uri, const std::string& what)
+{
+    try {
+        result.get();
+        check(false, what);
+    } catch (const wamp_error& e) {
+        check(e.uri() == uri, what + " (" + e.uri() + ")");
+    } catch (const std::exception& e) {
+        check(false, what + " (" + e.what() + ")");
+    }
+}
+
+static void test_reconnect()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport, 1);
+
+    int events = 0;
+    int invocations = 0;
+    boost::future<wamp_subscription> subscribed = session->subscribe("com.example.topic",
+            [&](const wamp_event&) { ++events; });
+    answer(io, transport, message_type::SUBSCRIBE, message_type::SUBSCRIBED, 10);
+    wamp_subscription subscription = subscribed.get();
+
+    // A second handler shares the router subscription.
+    subscribed = session->subscribe("com.example.topic", [&](const wamp_event&) { ++events; });
+    poll(io);
+    check(transport->take_sent().empty(), "second handler shares the subscription");
+    wamp_subscription shared = subscribed.get();
+
+    boost::future<wamp_registration> provided = session->provide("com.example.procedure",
+            [&](wamp_invocation invocation) {
+                ++invocations;
+                invocation->empty_result();
+            });
+    answer(io, transport, message_type::REGISTER, message_type::REGISTERED, 20);
+    wamp_registration registration = provided.get();
+    check(registration.session_id() == 1, "registration belongs to the session");
+
+    transport->receive(make_message(message_type::EVENT, 10, 100, no_details(), std::vector<int>{1}));
+    transport->receive(make_message(message_type::INVOCATION, 30, 20, no_details(), std::vector<int>{1}));
+    poll(io);
+    check(events == 2 && invocations == 1, "handlers run while the session lasts");
+    transport->take_sent();
+
+    // Unsubscribing a handler twice fails the second time, even while the
+    // other handler keeps the router subscription.
+    boost::future<void> unsubscribed = session->unsubscribe(shared);
+    poll(io);
+    check(transport->take_sent().empty(), "detaching a shared handler stays local");
+    unsubscribed.get();
+    unsubscribed = session->unsubscribe(shared);
+    poll(io);
+    check(transport->take_sent().empty(), "unsubscribing twice does not reach the router");
+    check_error(unsubscribed, "wamp.error.no_such_subscription", "unsubscribing twice fails");
+
+    transport->drop();
+
+    // Whatever still arrives for the old ids is not dispatched.
+    transport->receive(make_message(message_type::EVENT, 10, 101, no_details(), std::vector<int>{1}));
+    try {
+        transport->receive(make_message(message_type::INVOCATION, 31, 20, no_details(), std::vector<int>{1}));
+        check(false, "invocation for an ended registration is rejected");
+    } catch (const protocol_error&) {
+    }
+    poll(io);
+    check(events == 2, "handlers are not invoked after the disconnect");
+    check(invocations == 1, "procedures are not invoked after the disconnect");
+
+    // The handles fail without reaching the router, whose next session may
+    // hand out the same ids.
+    unsubscribed = session->unsubscribe(subscription);
+    boost::future<void> unprovided = session->unprovide(registration);
+    poll(io);
+    check(transport->take_sent().empty(), "ended handles do not reach the router");
+    check_error(unsubscribed, "wamp.error.no_such_subscription", "ended subscription fails");
+    check_error(unprovided, "wamp.error.no_such_registration", "ended registration fails");
+}
+
+static void test_pending_requests()
+{
+    boost::asio::io_service io;
+    auto transport = std::make_shared<test_transport>();
+    auto session = join_session(io, transport, 1);
+
+    boost::future<wamp_subscription> subscribed = session->subscribe("com.example.topic",
+            [](const wamp_event&) {});
+    boost::future<wamp_registration> provided = session->provide("com.example.procedure",
+            [](wamp_invocation invocation) { invocation->empty_result(); });
+    poll(io);
+
+    transport->drop();
+    check(subscribed.has_exception(), "pending subscribe fails on disconnect");
+    check(provided.has_exception(), "pending register fails on disconnect");
+}
+
+int main()
+{
+    test_reconnect();
+    test_pending_requests();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,196 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks that wamp_timer_wheel expires timers neither early nor more than
+// a tick late, across all levels of the wheel, and that cancelled timers
+// never expire.
+//
+// Usage: test_wamp_timer_wheel
+//
+
+#include <autobahn/wamp_timer_wheel.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace autobahn;
+
+using clock_type = wamp_timer_wheel::clock;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static void test_basic_operations()
+{
+    const clock_type::duration tick = std::chrono::milliseconds(1);
+    wamp_timer_wheel wheel(tick);
+    const clock_type::time_point base = clock_type::now();
+
+    std::vector<uint64_t> expired;
+    auto collect = [&](uint64_t id) { expired.push_back(id); };
+
+    check(wheel.empty() && wheel.resolution() == tick, "new wheel is empty");
+
+    wamp_timer_wheel::handle first = wheel.schedule(1, base + 5 * tick);
+    wamp_timer_wheel::handle second = wheel.schedule(2, base + 5 * tick);
+    wheel.schedule(3, base + 10 * tick);
+    check(wheel.size() == 3 && first != 0 && first != second, "schedule");
+
+    wheel.expire(base + 3 * tick, collect);
+    check(expired.empty(), "nothing expires early");
+
+    wheel.cancel(second);
+    wheel.cancel(second);
+    check(wheel.size() == 2, "cancel, twice");
+
+    wheel.expire(base + 7 * tick, collect);
+    check(expired == std::vector<uint64_t>{1} && wheel.size() == 1, "due timer expires");
+
+    // The node of the expired timer is reused, the old handle must not
+    // cancel the new timer.
+    wheel.schedule(4, base + 20 * tick);
+    wheel.cancel(first);
+    check(wheel.size() == 2, "stale handle does not cancel a reused node");
+
+    // A deadline in the past expires on the next tick.
+    wheel.schedule(5, base);
+    expired.clear();
+    wheel.expire(base + 12 * tick, collect);
+    check(std::set<uint64_t>(expired.begin(), expired.end()) == std::set<uint64_t>{3, 5},
+            "past deadline expires on the next tick");
+
+    // The expiry function may schedule timers.
+    expired.clear();
+    wheel.expire(base + 25 * tick, [&](uint64_t id) {
+        expired.push_back(id);
+        wheel.schedule(id + 100, base + 30 * tick);
+    });
+    check(expired == std::vector<uint64_t>{4} && wheel.size() == 1, "schedule while expiring");
+
+    wheel.clear();
+    expired.clear();
+    wheel.expire(base + 40 * tick, collect);
+    check(wheel.empty() && expired.empty(), "clear");
+}
+
+static void test_cascading()
+{
+    // One nanosecond ticks, so that deadlines beyond the third level
+    // (2^24 ticks) only take a few milliseconds of simulated time.
+    const clock_type::duration tick(1);
+    wamp_timer_wheel wheel(tick);
+    const clock_type::time_point base = clock_type::now();
+
+    std::mt19937_64 random(4711);
+    std::map<uint64_t, clock_type::time_point> deadlines;
+    std::map<uint64_t, wamp_timer_wheel::handle> handles;
+
+    // Spread deadlines over every level, including the slot boundaries
+    // where timers are cascaded.
+    std::vector<uint64_t> offsets{1, 255, 256, 257, 65535, 65536, 65537,
+            (1 << 24) - 1, 1 << 24, (1 << 24) + 1, (1 << 25) + 12345};
+    for (int i = 0; i < 2000; ++i) {
+        const unsigned bits = 1 + random() % 25;
+        offsets.push_back(random() % (UINT64_C(1) << bits) + 1);
+    }
+
+    uint64_t id = 0;
+    for (uint64_t offset : offsets) {
+        ++id;
+        deadlines[id] = base + offset * tick;
+        handles[id] = wheel.schedule(id, deadlines[id]);
+    }
+
+    // Cancel every tenth timer.
+    std::set<uint64_t> cancelled;
+    for (uint64_t cancel_id = 10; cancel_id <= id; cancel_id += 10) {
+        wheel.cancel(handles[cancel_id]);
+        cancelled.insert(cancel_id);
+    }
+
+    bool early = false;
+    bool expired_cancelled = false;
+    bool duplicate = false;
+    std::set<uint64_t> expired;
+
+    clock_type::time_point now = base;
+    const clock_type::time_point end = base + ((1 << 25) + 20000) * tick;
+    while (now < end) {
+        now += clock_type::duration(1 + random() % 100000);
+        wheel.expire(now, [&](uint64_t expired_id) {
+            early = early || deadlines[expired_id] > now;
+            expired_cancelled = expired_cancelled || cancelled.count(expired_id) != 0;
+            duplicate = duplicate || !expired.insert(expired_id).second;
+        });
+
+        // Everything due more than a tick ago must have expired by now.
+        for (const auto& deadline : deadlines) {
+            if (deadline.second + tick <= now && !cancelled.count(deadline.first)
+                    && !expired.count(deadline.first)) {
+                check(false, "timer " + std::to_string(deadline.first) + " expired late");
+                return;
+            }
+        }
+    }
+
+    check(!early, "no timer expires early");
+    check(!expired_cancelled, "cancelled timers never expire");
+    check(!duplicate, "timers expire once");
+    check(expired.size() + cancelled.size() == deadlines.size() && wheel.empty(),
+            "every timer expires or is cancelled");
+}
+
+int main()
+{
+    test_basic_operations();
+    test_cascading();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}
@@ -0,0 +1,300 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) Tavendo GmbH
+//
+// Boost Software License - Version 1.0 - August 17th, 2003
+//
+// Permission is hereby granted, free of charge, to any person or organization
+// obtaining a copy of the software and accompanying documentation covered by
+// this license (the "Software") to use, reproduce, display, distribute,
+// execute, and transmit the Software, and to prepare derivative works of the
+// Software, and to permit third-parties to whom the Software is furnished to
+// do so, all subject to the following:
+//
+// The copyright notices in the Software and this entire statement, including
+// the above license grant, this restriction and the following disclaimer,
+// must be included in all copies of the Software, in whole or in part, and
+// all derivative works of the Software, unless such copies or derivative
+// works are solely in the form of machine-executable object code generated by
+// a source language processor.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE, TITLE AND NON-INFRINGEMENT. IN NO EVENT
+// SHALL THE COPYRIGHT HOLDERS OR ANYONE DISTRIBUTING THE SOFTWARE BE LIABLE
+// FOR ANY DAMAGES OR OTHER LIABILITY, WHETHER IN CONTRACT, TORT OR OTHERWISE,
+// ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER
+// DEALINGS IN THE SOFTWARE.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+//
+// Checks the precedence wamp_uri_trie applies between exact, prefix and
+// wildcard patterns, and compares its lookups with a brute force matcher
+// over random patterns.
+//
+// Usage: test_wamp_uri_trie
+//
+
+#include <autobahn/wamp_uri_trie.hpp>
+
+#include <cstddef>
+#include <iostream>
+#include <map>
+#include <random>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace autobahn;
+
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "FAILED: " << what << std::endl;
+        ++failures;
+    }
+}
+
+static std::string match_or_none(const wamp_uri_trie<std::string>& trie, const std::string& uri)
+{
+    const std::string* value = trie.match(uri);
+    return value ? *value : "<none>";
+}
+
+static std::vector<std::string> components(const std::string& uri)
+{
+    std::vector<std::string> result(1);
+    for (char character : uri) {
+        if (character == '.') {
+            result.emplace_back();
+        } else {
+            result.back() += character;
+        }
+    }
+    return result;
+}
+
+// Whether a wildcard pattern matches a URI, and if so which of its
+// components are literal, for ranking several wildcard matches.
+static bool wildcard_matches(const std::string& pattern, const std::string& uri,
+        std::vector<bool>& literal)
+{
+    std::vector<std::string> pattern_components = components(pattern);
+    std::vector<std::string> uri_components = components(uri);
+    if (pattern_components.size() != uri_components.size()) {
+        return false;
+    }
+
+    literal.clear();
+    for (std::size_t i = 0; i < pattern_components.size(); ++i) {
+        if (pattern_components[i].empty()) {
+            if (uri_components[i].empty()) {
+                return false;
+            }
+            literal.push_back(false);
+        } else if (pattern_components[i] == uri_components[i]) {
+            literal.push_back(true);
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_basic_operations()
+{
+    wamp_uri_trie<std::string> trie;
+    check(trie.empty() && trie.size() == 0, "new trie is empty");
+    check(trie.match("com.example") == nullptr, "empty trie matches nothing");
+
+    trie.insert("com.example.add", wamp_match::exact, "exact");
+    trie.insert("com.example.add", wamp_match::prefix, "prefix");
+    trie.insert("com.example.add", wamp_match::wildcard, "wildcard");
+    check(trie.size() == 3, "same pattern with different policies is stored separately");
+    check(trie.find("com.example.add", wamp_match::exact)
+            && *trie.find("com.example.add", wamp_match::exact) == "exact", "find exact");
+    check(trie.find("com.example.add", wamp_match::prefix)
+            && *trie.find("com.example.add", wamp_match::prefix) == "prefix", "find prefix");
+    check(trie.find("com.example", wamp_match::exact) == nullptr, "find does not match prefixes");
+
+    trie.insert("com.example.add", wamp_match::exact, "replaced");
+    check(trie.size() == 3 && *trie.find("com.example.add", wamp_match::exact) == "replaced",
+            "insert replaces the value of the same pattern");
+
+    check(trie.erase("com.example.add", wamp_match::exact), "erase existing pattern");
+    check(!trie.erase("com.example.add", wamp_match::exact), "erase twice");
+    check(!trie.erase("com.example", wamp_match::prefix), "erase unknown pattern");
+    check(trie.size() == 2 && trie.find("com.example.add", wamp_match::prefix),
+            "erase keeps the other policies");
+
+    wamp_uri_trie<std::string> moved(std::move(trie));
+    check(moved.size() == 2 && match_or_none(moved, "com.example.add") == "prefix",
+            "move construction takes the patterns");
+
+    moved.clear();
+    check(moved.empty() && moved.match("com.example.add") == nullptr, "clear");
+    moved.insert("com", wamp_match::prefix, "again");
+    check(match_or_none(moved, "com.example") == "again", "insert after clear");
+}
+
+static void test_precedence()
+{
+    wamp_uri_trie<std::string> trie;
+    trie.insert("com..add", wamp_match::wildcard, "wildcard");
+    check(match_or_none(trie, "com.example.add") == "wildcard", "wildcard matches one component");
+    check(match_or_none(trie, "com.add") == "<none>", "wildcard needs the component");
+    check(match_or_none(trie, "com..add") == "<none>", "wildcard does not match empty components");
+    check(match_or_none(trie, "com.a.b.add") == "<none>", "wildcard matches a single component");
+
+    trie.insert("com", wamp_match::prefix, "short prefix");
+    check(match_or_none(trie, "com.example.add") == "short prefix", "prefix wins over wildcard");
+    check(match_or_none(trie, "com") == "short prefix", "prefix matches itself");
+    check(match_or_none(trie, "org.example") == "<none>", "prefix must start the URI");
+
+    trie.insert("com.example", wamp_match::prefix, "long prefix");
+    check(match_or_none(trie, "com.example.add") == "long prefix", "longest prefix wins");
+    check(match_or_none(trie, "com.example-low") == "long prefix",
+            "prefixes are not split at components");
+    check(match_or_none(trie, "com.other") == "short prefix", "shorter prefix still matches");
+
+    trie.insert("com.example.add", wamp_match::exact, "exact");
+    check(match_or_none(trie, "com.example.add") == "exact", "exact wins over prefix");
+    check(match_or_none(trie, "com.example.add.more") == "long prefix",
+            "exact does not match longer URIs");
+
+    wamp_uri_trie<std::string> wildcards;
+    wildcards.insert("com..", wamp_match::wildcard, "com.*.*");
+    wildcards.insert("com..add", wamp_match::wildcard, "com.*.add");
+    wildcards.insert("com.example.", wamp_match::wildcard, "com.example.*");
+    wildcards.insert("..add", wamp_match::wildcard, "*.*.add");
+    check(match_or_none(wildcards, "com.example.add") == "com.example.*",
+            "wildcard with the latest first wildcard wins");
+    check(match_or_none(wildcards, "com.other.add") == "com.*.add",
+            "literal component wins over wildcard");
+    check(match_or_none(wildcards, "com.other.sub") == "com.*.*", "all wildcard match");
+    check(match_or_none(wildcards, "org.other.add") == "*.*.add", "leading wildcard");
+
+    std::multiset<std::string> matches;
+    wildcards.for_each_match("com.example.add",
+            [&](wamp_match match, const std::string& value) {
+                check(match == wamp_match::wildcard, "for_each_match passes the policy");
+                matches.insert(value);
+            });
+    check(matches == std::multiset<std::string>{"com.*.*", "com.*.add", "com.example.*", "*.*.add"},
+            "for_each_match visits every matching pattern once");
+}
+
+// Compares match() and for_each_match() with a brute force scan over
+// random patterns built from a few short components, so that patterns
+// share prefixes and overlap often.
+static void test_random()
+{
+    static const char* const pieces[] = { "a", "b", "ab", "ba" };
+
+    std::mt19937 random(7);
+    auto random_uri = [&](bool wildcards) {
+        std::string uri;
+        std::size_t count = 1 + random() % 4;
+        for (std::size_t i = 0; i < count; ++i) {
+            if (i) {
+                uri += '.';
+            }
+            if (!wildcards || random() % 3) {
+                uri += pieces[random() % 4];
+            }
+        }
+        return uri;
+    };
+
+    using pattern = std::pair<std::string, wamp_match>;
+    wamp_uri_trie<std::string> trie;
+    std::map<pattern, std::string> reference;
+
+    for (int operation = 0; operation < 20000; ++operation) {
+        const wamp_match match = static_cast<wamp_match>(random() % 3);
+        const pattern key(random_uri(match == wamp_match::wildcard), match);
+        const std::string value = to_string(match) + std::string(":") + key.first;
+
+        if (random() % 3) {
+            trie.insert(key.first, key.second, value);
+            reference[key] = value;
+        } else {
+            check(trie.erase(key.first, key.second) == (reference.erase(key) == 1),
+                    "erase agrees with reference");
+        }
+        check(trie.size() == reference.size(), "size agrees with reference");
+
+        const std::string uri = random_uri(false);
+
+        const std::string* exact = nullptr;
+        const std::string* prefix = nullptr;
+        std::size_t prefix_length = 0;
+        const std::string* wildcard = nullptr;
+        std::vector<bool> wildcard_rank;
+        std::multiset<std::string> expected;
+        for (const auto& entry : reference) {
+            const std::string& text = entry.first.first;
+            std::vector<bool> rank;
+            bool matches = false;
+            switch (entry.first.second) {
+                case wamp_match::exact:
+                    matches = text == uri;
+                    if (matches) {
+                        exact = &entry.second;
+                    }
+                    break;
+                case wamp_match::prefix:
+                    matches = uri.compare(0, text.size(), text) == 0;
+                    if (matches && (!prefix || text.size() > prefix_length)) {
+                        prefix = &entry.second;
+                        prefix_length = text.size();
+                    }
+                    break;
+                case wamp_match::wildcard:
+                    matches = wildcard_matches(text, uri, rank);
+                    if (matches && (!wildcard || rank > wildcard_rank)) {
+                        wildcard = &entry.second;
+                        wildcard_rank = rank;
+                    }
+                    break;
+            }
+            if (matches) {
+                expected.insert(entry.second);
+            }
+        }
+
+        const std::string* best = exact ? exact : prefix ? prefix : wildcard;
+        const std::string* found = trie.match(uri);
+        check((best == nullptr && found == nullptr) || (best && found && *best == *found),
+                "match agrees with reference for " + uri);
+
+        std::multiset<std::string> visited;
+        trie.for_each_match(uri, [&](wamp_match, const std::string& value) {
+            visited.insert(value);
+        });
+        check(visited == expected, "for_each_match agrees with reference for " + uri);
+
+        if (failures > 10) {
+            return;
+        }
+    }
+}
+
+int main()
+{
+    test_basic_operations();
+    test_precedence();
+    test_random();
+
+    if (failures) {
+        std::cerr << failures << " checks failed" << std::endl;
+        return 1;
+    }
+
+    std::cout << "all checks passed" << std::endl;
+    return 0;
+}